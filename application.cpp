@@ -2,10 +2,30 @@
 
 namespace Tea {
 
+	Application::Application(bool headless, uint32_t headlessFrameCount) {
+		mHeadless = headless;
+		mHeadlessFrameCount = headlessFrameCount;
+	}
+
+	Application::Application(bool headless, uint32_t headlessFrameCount, uint32_t resizeBenchCount)
+		: Application(headless, headlessFrameCount) {
+		mResizeBenchCount = resizeBenchCount;
+	}
+
 	void Application::run(){
-		initWindow();
+		if (!mHeadless) {
+			initWindow();
+		}
+
 		initVulkan();
-		mainLoop();
+
+		if (mHeadless) {
+			headlessLoop();
+		}
+		else {
+			mainLoop();
+		}
+
 		cleanUp();
 	}
 
@@ -14,37 +34,81 @@ namespace Tea {
 	}
 
 	void Application::initVulkan(){
-		mInstance = Wrapper::Instance::create(true);
+		mInstance = Wrapper::Instance::create(mValidation, mHeadless);
 
-		mSurface = Wrapper::WindowSurface::create(mInstance, mWindow);
+		if (!mHeadless) {
+			mSurface = Wrapper::WindowSurface::create(mInstance, mWindow);
+		}
 
 		mDevice = Wrapper::Device::create(mInstance, mSurface);
 
 		mCommandPool = Wrapper::CommandPool::create(mDevice);
 
-		mSwapChain = Wrapper::SwapChain::create(mDevice, mWindow, mSurface);
-		mWidth = mSwapChain->getExtent().width;
-		mHeight = mSwapChain->getExtent().height;
+		mDeletionQueue = Wrapper::DeletionQueue::create(mDevice);
+
+		createRenderTarget();
 
 		mRenderPass = Wrapper::RenderPass::create(mDevice);
 		createRenderPass();
 
-		mSwapChain->createFrameBuffers(mRenderPass);
+		createFrameBuffers();
+
+		createShaders();
 
 		//descriptor ===========================
 		mUniformManager = UniformManager::create();
-		mUniformManager->init(mDevice, mCommandPool, mSwapChain->getImageCount());
+		mUniformManager->init(mDevice, mCommandPool, MAX_FRAMES_IN_FLIGHT, mReflectedLayout->getSetLayouts().at(0));
 
 		mModel = Model::create(mDevice);
 
+		//compiles what the previous run recorded in parallel, the pipeline below is shared with it if it was recorded
+		mPipelineWarmup = Wrapper::PipelineWarmup::create(mDevice);
+		mPipelineWarmup->start();
+
 		mPipeline = Wrapper::Pipeline::create(mDevice, mRenderPass);
 		createPipeline();
 
-		mCommandBuffers.resize(mSwapChain->getImageCount());
+		//no first-use compile once rendering has started
+		mPipelineWarmup->wait();
+		std::cout << "Pipeline warm-up: " << mPipelineWarmup->getWarmedCount() << " compiled, "
+			<< mPipelineWarmup->getSkippedCount() << " skipped, " << mPipelineWarmup->getFailedCount() << " failed" << std::endl;
+
+		mCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
 		createCommandBuffers();
 
 		createSyncObjects();
+
+		createImageSyncObjects();
+	}
+
+	void Application::createRenderTarget() {
+		if (mHeadless) {
+			mOffscreenTarget = Wrapper::OffscreenTarget::create(mDevice, WIDTH, HEIGHT, HeadlessImageCount);
+			mWidth = mOffscreenTarget->getExtent().width;
+			mHeight = mOffscreenTarget->getExtent().height;
+			mImageCount = mOffscreenTarget->getImageCount();
+			return;
+		}
+
+		//on recreation the current swapchain is passed as the old one
+		mSwapChain = Wrapper::SwapChain::create(mDevice, mWindow, mSurface, mCommandPool, mSwapChain);
+		mWidth = mSwapChain->getExtent().width;
+		mHeight = mSwapChain->getExtent().height;
+		mImageCount = mSwapChain->getImageCount();
+	}
+
+	void Application::createFrameBuffers() {
+		if (mHeadless) {
+			mOffscreenTarget->createFrameBuffers(mRenderPass);
+		}
+		else {
+			mSwapChain->createFrameBuffers(mRenderPass);
+		}
+	}
+
+	VkFramebuffer Application::getFrameBuffer(uint32_t imageIndex) const {
+		return mHeadless ? mOffscreenTarget->getFrameBuffer(imageIndex) : mSwapChain->getFrameBuffer(imageIndex);
 	}
 
 	void Application::mainLoop() {
@@ -53,45 +117,56 @@ namespace Tea {
 
 			mModel->update();
 
-			mUniformManager->update(mVPMatrices, mModel->getUniform(), mCurrentFrame);
 			render();
+
+			if (mResizeBenchCount > 0) {
+				if (mRecreateMs.size() >= mResizeBenchCount) {
+					break;
+				}
+
+				//alternate between two sizes, the size only flips once the previous resize was handled
+				bool grow = mRecreateMs.size() % 2 == 0;
+				mWindow->setSize(grow ? WIDTH * 3 / 2 : WIDTH, grow ? HEIGHT * 3 / 2 : HEIGHT);
+			}
 		}
 
 		vkDeviceWaitIdle(mDevice->getDevice());
+
+		reportSwapChainRecreation();
 	}
-	void Application::createPipeline() {
-		//设置视口
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = (float)mWidth;
-		viewport.height = (float)mHeight;
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-
-		VkRect2D scissor = {};
-		scissor.offset = { 0, 0 };
-		scissor.extent = { mWidth, mHeight };
-
-		mPipeline->setViewports({ viewport });
-		mPipeline->setScissors({ scissor });
 
-		//step1.shader
-		//设置shader
-		std::vector<Wrapper::Shader::Ptr> shaderGroup{};
+	void Application::headlessLoop() {
+		//every measured frame should draw, not just clear
+		mPipeline->wait();
 
-		auto shaderVertex = Wrapper::Shader::create(mDevice, "shaders/vs.spv", VK_SHADER_STAGE_VERTEX_BIT, "main");
-		shaderGroup.push_back(shaderVertex);
+		auto start = std::chrono::steady_clock::now();
 
-		auto shaderFragment = Wrapper::Shader::create(mDevice, "shaders/fs.spv", VK_SHADER_STAGE_FRAGMENT_BIT, "main");
-		shaderGroup.push_back(shaderFragment);
+		for (uint32_t frame = 0; frame < mHeadlessFrameCount; ++frame) {
+			mModel->update();
 
-		mPipeline->setShaderGroup(shaderGroup);
+			renderHeadless();
+		}
+
+		mDevice->getFrameScheduler()->waitIdle();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Headless: " << mHeadlessFrameCount << " frames in " << seconds << " s ("
+			<< (seconds > 0.0 ? mHeadlessFrameCount / seconds : 0.0) << " fps)" << std::endl;
+	}
+
+	void Application::createPipeline() {
+		//视口和剪裁在录制时设置，窗口大小变化不需要重建pipeline
+		mPipeline->setDynamicStates({ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR });
+
+		//step1.shader
+		//设置shader
+		mPipeline->setShaderGroup({ mVertexShader, mFragmentShader });
 
 		//step2.Fixed-function
 		//顶点的排布模式
 		auto vertexBindingDes = mModel->getVertexInputBindingDescriptions();
 		auto vertexAttributeDes = mModel->getAttributeDescriptions();
+		mReflectedLayout->checkVertexInput(vertexAttributeDes);
 
 		mPipeline->mVertexInputState.vertexBindingDescriptionCount = vertexBindingDes.size();
 		mPipeline->mVertexInputState.pVertexBindingDescriptions = vertexBindingDes.data();
@@ -156,37 +231,39 @@ namespace Tea {
 
 		//We need to specify the descriptor set layout during pipeline creation to tell Vulkan which descriptors the shaders will be using.
 		//Descriptor set layouts are specified in the pipeline layout object.		
-		//uniform的传递
-		auto layout = mUniformManager->getDescriptorLayout();
-
-		mPipeline->mLayoutState.setLayoutCount = 1;
-		mPipeline->mLayoutState.pSetLayouts = &layout;
-		mPipeline->mLayoutState.pushConstantRangeCount = 0;
-		mPipeline->mLayoutState.pPushConstantRanges = nullptr;
-
-		mPipeline->build();
-
-        for(int i = 0; i< mSwapChain->getImageCount(); i++){
-            auto imageSemaphore = Wrapper::Semaphore::create(mDevice);
-            mImageAvailableSemaphores.push_back(imageSemaphore);
-            auto renderSemaphore = Wrapper::Semaphore::create(mDevice);
-            mRenderFinishedSemaphores.push_back(renderSemaphore);
-            auto fence = Wrapper::Fence::create(mDevice);
-            mFences.push_back(fence);
-        }
+		//uniform的传递, set layouts and push constants as the shaders declare them
+		mPipeline->setReflectedLayout(mReflectedLayout);
+
+		//compiled on a worker thread, frames before it is ready only clear the screen
+		mPipeline->buildAsync();
+	}
+
+	void Application::createShaders() {
+		mVertexShader = Wrapper::Shader::create(mDevice, "shaders/vs.spv", VK_SHADER_STAGE_VERTEX_BIT, "main");
+
+		//constant 0: USE_TEXTURE, VK_FALSE gives the vertex colored variant of the same module
+		Wrapper::SpecializationConstants fragmentVariant{};
+		fragmentVariant.set<VkBool32>(0, mUseTexture ? VK_TRUE : VK_FALSE);
+
+		mFragmentShader = Wrapper::Shader::create(mDevice, "shaders/fs.spv", VK_SHADER_STAGE_FRAGMENT_BIT, "main", fragmentVariant);
+
+		//the view/projection is bound with a dynamic offset into UniformManager's ring buffer,
+		//the model matrix is a push constant range the layout takes from the vertex shader
+		mReflectedLayout = Wrapper::ReflectedLayout::create(mDevice, { mVertexShader, mFragmentShader }, { { 0, 0 } });
 	}
 
 	void Application::createRenderPass() {
 		//输入画布的描述
 		VkAttachmentDescription attachmentDes{};
-		attachmentDes.format = mSwapChain->getFormat();
+		attachmentDes.format = mHeadless ? mOffscreenTarget->getFormat() : mSwapChain->getFormat();
 		attachmentDes.samples = VK_SAMPLE_COUNT_1_BIT;
 		attachmentDes.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 		attachmentDes.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		attachmentDes.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		attachmentDes.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		attachmentDes.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		attachmentDes.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		//offscreen images are left ready to be copied out
+		attachmentDes.finalLayout = mHeadless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
 		mRenderPass->addAttachment(attachmentDes);
 
@@ -222,10 +299,11 @@ namespace Tea {
 		VkSubpassDependency dependency{};
 		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
 		dependency.dstSubpass = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.srcAccessMask = 0;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		//the depth image is shared by all framebuffers: the depth tests of the previous frame have to be done before this frame clears it
+		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
 		mRenderPass->addDependency(dependency);
 
@@ -233,54 +311,77 @@ namespace Tea {
 	}
 
 	void Application::createCommandBuffers() {
-	for (int i = 0; i < mSwapChain->getImageCount(); ++i) {
+		//one command buffer per frame in flight, recorded every frame because the dynamic uniform offsets change
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
 			mCommandBuffers[i] = Wrapper::CommandBuffer::create(mDevice, mCommandPool);
+		}
+	}
 
-			mCommandBuffers[i]->begin();
-
-			VkRenderPassBeginInfo renderBeginInfo{};
-			renderBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-			renderBeginInfo.renderPass = mRenderPass->getRenderPass();
-			renderBeginInfo.framebuffer = mSwapChain->getFrameBuffer(i);
-			renderBeginInfo.renderArea.offset = { 0, 0 };
-			renderBeginInfo.renderArea.extent = mSwapChain->getExtent();
+	void Application::recordCommandBuffer(uint32_t imageIndex) {
+		auto& commandBuffer = mCommandBuffers[mCurrentFrame];
 
-			VkClearValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-			renderBeginInfo.clearValueCount = 1;
-			renderBeginInfo.pClearValues = &clearColor;
+		//the pool is created with RESET_COMMAND_BUFFER_BIT, so begin resets the previous recording
+		commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
+		VkRenderPassBeginInfo renderBeginInfo{};
+		renderBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderBeginInfo.renderPass = mRenderPass->getRenderPass();
+		renderBeginInfo.framebuffer = getFrameBuffer(imageIndex);
+		renderBeginInfo.renderArea.offset = { 0, 0 };
+		renderBeginInfo.renderArea.extent = { mWidth, mHeight };
 
-			mCommandBuffers[i]->beginRenderPass(renderBeginInfo);
+		//one per attachment: color, then depth
+		std::array<VkClearValue, 2> clearValues{};
+		clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
+		clearValues[1].depthStencil = { 1.0f, 0 };
+		renderBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+		renderBeginInfo.pClearValues = clearValues.data();
 
-			mCommandBuffers[i]->bindGraphicPipeline(mPipeline->getPipeline());
+		commandBuffer->beginRenderPass(renderBeginInfo);
 
-			mCommandBuffers[i]->bindDescriptorSet(mPipeline->getLayout(), mUniformManager->getDescriptorSet(mCurrentFrame));
+		auto pipeline = mPipeline->getPipeline();
+		if (pipeline != VK_NULL_HANDLE) {
+			commandBuffer->bindGraphicPipeline(pipeline);
 
-			//mCommandBuffers[i]->bindVertexBuffer({ mModel->getVertexBuffer()->getBuffer() });
+			commandBuffer->setViewportAndScissor({ mWidth, mHeight });
 
-			mCommandBuffers[i]->bindVertexBuffer({ mModel->getVertexBuffers() });
+			commandBuffer->bindDescriptorSet(mPipeline->getLayout(), mUniformManager->getDescriptorSet(mCurrentFrame), mUniformManager->getDynamicOffsets());
 
-			mCommandBuffers[i]->bindIndexBuffer(mModel->getIndexBuffer()->getBuffer());
+			commandBuffer->pushConstants(mPipeline->getLayout(), VK_SHADER_STAGE_VERTEX_BIT, mModel->getUniform());
 
-			mCommandBuffers[i]->drawIndex(mModel->getIndexCount());
+			commandBuffer->bindVertexBuffer({ mModel->getVertexBuffers() });
 
-			mCommandBuffers[i]->endRenderPass();
+			commandBuffer->bindIndexBuffer(mModel->getIndexBuffer()->getBuffer());
 
-			mCommandBuffers[i]->end();
+			commandBuffer->drawIndex(mModel->getIndexCount());
 		}
+
+		commandBuffer->endRenderPass();
+
+		commandBuffer->end();
 	}
 
 	void Application::createSyncObjects(){
-		for (int i = 0; i < mSwapChain->getImageCount(); ++i) {
+		//frame completion is tracked on the graphics timeline of the device's FrameScheduler, no fences needed
+		for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
 			auto imageSemaphore = Wrapper::Semaphore::create(mDevice);
 			mImageAvailableSemaphores.push_back(imageSemaphore);
+		}
+	}
 
+	void Application::createImageSyncObjects() {
+		for (uint32_t i = 0; i < mImageCount; ++i) {
 			auto renderSemaphore = Wrapper::Semaphore::create(mDevice);
 			mRenderFinishedSemaphores.push_back(renderSemaphore);
-
-			auto fence = Wrapper::Fence::create(mDevice);
-			mFences.push_back(fence);
 		}
+
+		mImagesInFlight.assign(mImageCount, 0);
+	}
+
+	void Application::waitImageInFlight(uint32_t imageIndex) {
+		//with more images than frames in flight the driver may hand out an image whose frame
+		//was submitted from another slot and has not finished yet
+		mDevice->getFrameScheduler()->wait(Wrapper::QueueType::Graphics, mImagesInFlight[imageIndex]);
 	}
 
 	void Application::recreateSwapChain(){
@@ -291,38 +392,59 @@ namespace Tea {
 			glfwGetFramebufferSize(mWindow->getWindow(), &width, &height);
 		}
 
-		vkDeviceWaitIdle(mDevice->getDevice());
+		auto start = std::chrono::steady_clock::now();
 
-		cleanupSwapChain();
+		//no vkDeviceWaitIdle: frames in flight keep using the old objects, which are only destroyed
+		//once the graphics queue has passed the last frame submitted so far
+		auto oldSwapChain = mSwapChain;
 
-		mSwapChain = Wrapper::SwapChain::create(mDevice, mWindow, mSurface);
-		mWidth = mSwapChain->getExtent().width;
-		mHeight = mSwapChain->getExtent().height;
+		createRenderTarget();
 
-		mRenderPass = Wrapper::RenderPass::create(mDevice);
-		createRenderPass();
+		mDeletionQueue->retire(oldSwapChain);
 
-		mSwapChain->createFrameBuffers(mRenderPass);
+		//viewport and scissor are dynamic, only a new render pass needs a new pipeline
+		if (mSwapChain->getFormat() != oldSwapChain->getFormat()) {
+			mDeletionQueue->retire(mRenderPass);
+			mRenderPass = Wrapper::RenderPass::create(mDevice);
+			createRenderPass();
 
-		mPipeline = Wrapper::Pipeline::create(mDevice, mRenderPass);
-		createPipeline();
+			mDeletionQueue->retire(mPipeline);
+			mPipeline = Wrapper::Pipeline::create(mDevice, mRenderPass);
+			createPipeline();
+		}
 
-		mCommandBuffers.resize(mSwapChain->getImageCount());
+		oldSwapChain.reset();
 
-		createCommandBuffers();
+		createFrameBuffers();
 
-		createSyncObjects();
+		//a pending present of the old swapchain may still wait on a render finished semaphore
+		mDeletionQueue->retire(std::make_shared<std::vector<Wrapper::Semaphore::Ptr>>(std::move(mRenderFinishedSemaphores)));
+		mRenderFinishedSemaphores.clear();
+
+		//command buffers and image available semaphores are per frame in flight and survive the swapchain
+		createImageSyncObjects();
+
+		mWindow->resetResized();
+
+		mRecreateMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
 	}
 
-	void Application::cleanupSwapChain(){
-		//每个对象里存储了依赖对象的智能指针
-		mSwapChain.reset();
-		mCommandBuffers.clear();
-		mPipeline.reset();
-		mRenderPass.reset();
-		mImageAvailableSemaphores.clear();
-		mRenderFinishedSemaphores.clear();
-		mFences.clear();
+	void Application::reportSwapChainRecreation() const {
+		if (mRecreateMs.empty()) {
+			return;
+		}
+
+		auto samples = mRecreateMs;
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+		for (double sample : samples) {
+			sum += sample;
+		}
+
+		std::cout << "Swapchain recreation: " << samples.size() << " times, mean " << sum / samples.size()
+			<< " ms, p50 " << samples[samples.size() / 2]
+			<< " ms, max " << samples.back() << " ms" << std::endl;
 	}
 	
 
@@ -341,48 +463,55 @@ namespace Tea {
 		//That is unfortunate, because each of the operations depends on the previous one finishing.Thus we need to explore which primitives we can use to achieve the desired ordering.
 
 		//等待当前要提交的CommandBuffer执行完毕
-		mFences[mCurrentFrame]->block();;//to make the CPU wait for one or more fences to be signaled by the GPU.
+		//the CPU waits until the graphics timeline has reached the frame that last used this slot
+		auto scheduler = mDevice->getFrameScheduler();
+		mCurrentFrame = scheduler->beginFrame();
 
 		//获取交换链当中的下一帧
 		uint32_t imageIndex{ 0 };
 
-		vkAcquireNextImageKHR(
+		VkResult acquireResult = vkAcquireNextImageKHR(
 			mDevice->getDevice(),
 			mSwapChain->getSwapChain(),
-			UINT32_MAX,
+			UINT64_MAX,
 			mImageAvailableSemaphores[mCurrentFrame]->getSemaphore(),
 			VK_NULL_HANDLE,
 			&imageIndex);
 
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		//out of date: nothing was acquired and the semaphore stays unsignaled, the frame slot is simply reused.
+		//suboptimal still delivers an image, it is rendered and the swapchain recreated after presenting it
+		if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+			recreateSwapChain();
+			return;
+		}
 
-		//wait with writing colors to the image until waitSemaphore available, 
-		VkSemaphore waitSemaphores[] = { mImageAvailableSemaphores[mCurrentFrame]->getSemaphore() }; 
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
+			throw std::runtime_error("Error: failed to acquire swapchain image");
+		}
+
+		waitImageInFlight(imageIndex);
+
+		//beginFrame above guarantees the GPU is done with this frame's uniform ring region and command buffer
+		mUniformManager->update(mVPMatrices, mCurrentFrame);
 
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;//which semaphores to wait on before execution begin
-		submitInfo.pWaitDstStageMask = waitStages;// in which stage(s) of the pipeline to wait
+		recordCommandBuffer(imageIndex);
+
+		//wait with writing colors to the image until waitSemaphore available, 
+		Wrapper::SubmitWait imageAvailable{};
+		imageAvailable.mSemaphore = mImageAvailableSemaphores[mCurrentFrame]->getSemaphore();
+		imageAvailable.mStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
 		//work is represented as a sequence of commands
 		//that are created and recorded into "command buffers" by cpu
 		//they are submitted to gpu to execution
 
-		auto commandBuffer = mCommandBuffers[imageIndex]->getCommandBuffer() ;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-
-		//执行命令后light which Semaphore
-		VkSemaphore lightSemaphores[] = { mRenderFinishedSemaphores[mCurrentFrame]->getSemaphore() };
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = lightSemaphores;
+		//执行命令后light which Semaphore, present can only wait on binary semaphores
+		VkSemaphore lightSemaphores[] = { mRenderFinishedSemaphores[imageIndex]->getSemaphore() };
 
-		mFences[mCurrentFrame]->resetFence();
+		uint64_t frameValue = mCommandBuffers[mCurrentFrame]->submit(Wrapper::QueueType::Graphics, { imageAvailable }, { lightSemaphores[0] });
 
-		if (vkQueueSubmit(mDevice->getGraphicQueue(), 1, &submitInfo, mFences[mCurrentFrame]->getFence() ) != VK_SUCCESS) {
-			throw std::runtime_error("Error:failed to submit renderCommand");
-		}
+		mImagesInFlight[imageIndex] = frameValue;
+		scheduler->endFrame(frameValue);
 
 		//render command above, present command below
 		//drawing a frame is submitting the result back to the swap chain to have it eventually show up on the screen
@@ -397,18 +526,51 @@ namespace Tea {
 		presentInfo.pImageIndices = &imageIndex;// the index of the image for each swap chain
 		presentInfo.pResults = nullptr;
 
-		vkQueuePresentKHR(mDevice->getPresentQueue(), &presentInfo);//submits the request to present an image to the swap chain
+		VkResult presentResult = vkQueuePresentKHR(mDevice->getPresentQueue(), &presentInfo);//submits the request to present an image to the swap chain
+
+		if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || acquireResult == VK_SUBOPTIMAL_KHR || mWindow->isResized()) {
+			recreateSwapChain();
+		}
+		else if (presentResult != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to present swapchain image");
+		}
 
-		mCurrentFrame = (mCurrentFrame + 1) % mSwapChain->getImageCount();
+		mDeletionQueue->collect();
+	}
+
+	void Application::renderHeadless() {
+		auto scheduler = mDevice->getFrameScheduler();
+		mCurrentFrame = scheduler->beginFrame();
+
+		uint32_t imageIndex = mHeadlessImageIndex;
+		mHeadlessImageIndex = (mHeadlessImageIndex + 1) % mImageCount;
+
+		waitImageInFlight(imageIndex);
+
+		mUniformManager->update(mVPMatrices, mCurrentFrame);
+
+		recordCommandBuffer(imageIndex);
+
+		uint64_t frameValue = mCommandBuffers[mCurrentFrame]->submit(Wrapper::QueueType::Graphics);
+
+		mImagesInFlight[imageIndex] = frameValue;
+		scheduler->endFrame(frameValue);
 	}
 
 
 	void Application::cleanUp() {
+		mDeletionQueue.reset();
+
 		mPipeline.reset();
+		mPipelineWarmup.reset();
+		mReflectedLayout.reset();
+		mVertexShader.reset();
+		mFragmentShader.reset();
 
 		mRenderPass.reset();
 
 		mSwapChain.reset();
+		mOffscreenTarget.reset();
 
 		mDevice.reset();
 		mSurface.reset();
@@ -6,16 +6,18 @@
 #include "vulkanWrapper/window.h"
 #include "vulkanWrapper/windowSurface.h"
 #include "vulkanWrapper/swapChain.h"
+#include "vulkanWrapper/offscreenTarget.h"
 #include "vulkanWrapper/shader.h"
 #include "vulkanWrapper/pipeline.h"
+#include "vulkanWrapper/pipelineWarmup.h"
 #include "vulkanWrapper/renderPass.h"
 #include "vulkanWrapper/commandPool.h"
 #include "vulkanWrapper/commandBuffer.h"
 #include "vulkanWrapper/semaphore.h"
-#include "vulkanWrapper/fence.h"
 #include "vulkanWrapper/buffer.h"
 #include "vulkanWrapper/image.h"
 #include "vulkanWrapper/sampler.h"
+#include "vulkanWrapper/deletionQueue.h"
 #include "texture/texture.h"
 
 #include "model.h"
@@ -26,8 +28,21 @@ namespace Tea {
 	public:
 		Application() = default;
 
+		//headless: no window, surface or swapchain, renders headlessFrameCount frames into offscreen images as fast as possible
+		Application(bool headless, uint32_t headlessFrameCount);
+
+		//resizeBenchCount > 0: resizes the window back and forth until the swapchain was recreated that many times,
+		//then prints the recreation latency and exits
+		Application(bool headless, uint32_t headlessFrameCount, uint32_t resizeBenchCount);
+
 		~Application() = default;
 
+		//false: draws with the vertex colored variant of the fragment shader instead of the textured one
+		void setUseTexture(bool useTexture) { mUseTexture = useTexture; }
+
+		//validation layers have to be installed, so headless runs on bare machines (CI, lavapipe) turn them off
+		void setValidation(bool validation) { mValidation = validation; }
+
 		void run();
 
 	private:
@@ -37,44 +52,102 @@ namespace Tea {
 
 		void mainLoop();
 
+		void headlessLoop();
+
 		void render();
 
+		void renderHeadless();
+
 		void cleanUp();
 
 	private:
+		void createRenderTarget();
+		void createFrameBuffers();
+		//loads the shaders and reflects the descriptor and pipeline layout from them
+		void createShaders();
 		void createPipeline();
 		void createRenderPass();
 		void createCommandBuffers();
+		void recordCommandBuffer(uint32_t imageIndex);
 		void createSyncObjects();
+		void createImageSyncObjects();
 
-		//重建交换链:  当窗口大小发生变化的时候，交换链也要发生变化，Frame View Pipeline RenderPass Sync
+		//waits until imageIndex is no longer used by an earlier frame
+		void waitImageInFlight(uint32_t imageIndex);
+
+		//重建交换链:  当窗口大小发生变化的时候，交换链也要发生变化
+		//the old swapchain keeps presenting until the new one is created and is destroyed through the deletion queue,
+		//the render pass and pipeline are only rebuilt if the surface format changed, viewport and scissor are dynamic
 		void recreateSwapChain();
 
-		void cleanupSwapChain();
+		void reportSwapChainRecreation() const;
+
+		VkFramebuffer getFrameBuffer(uint32_t imageIndex) const;
 
 	private:
 		unsigned int mWidth{ 800 };
 		unsigned int mHeight{ 600 };
 
 	private:
-		int mCurrentFrame{ 0 };
+		bool mHeadless{ false };
+		uint32_t mHeadlessFrameCount{ 0 };
+
+		uint32_t mResizeBenchCount{ 0 };
+
+		//specialization constant USE_TEXTURE of the fragment shader
+		bool mUseTexture{ true };
+
+		bool mValidation{ true };
+
+		//milliseconds of every swapchain recreation, from the resize being noticed until the next frame can be recorded
+		std::vector<double> mRecreateMs{};
+
+		//offscreen images in headless mode, mirrors a triple buffered swapchain
+		static constexpr uint32_t HeadlessImageCount = 3;
+
+		//swapchain or offscreen image count, only framebuffers and render finished semaphores exist per image
+		uint32_t mImageCount{ 0 };
+
+		//command buffers, uniforms and image available semaphores exist per frame in flight,
+		//FrameScheduler::beginFrame hands out the slot once the GPU is done with it
+		uint32_t mCurrentFrame{ 0 };
+
+		//headless mode has no acquire, offscreen images are simply used in turn
+		uint32_t mHeadlessImageIndex{ 0 };
+
 		Wrapper::Window::Ptr mWindow{ nullptr };
 		Wrapper::Instance::Ptr mInstance{ nullptr };
 		Wrapper::Device::Ptr mDevice{ nullptr };
 		Wrapper::WindowSurface::Ptr mSurface{ nullptr };
 		Wrapper::SwapChain::Ptr mSwapChain{ nullptr };
+		Wrapper::OffscreenTarget::Ptr mOffscreenTarget{ nullptr };
 		Wrapper::Pipeline::Ptr mPipeline{ nullptr };
+		//pipelines of the previous run, kept so they stay in the device's PipelineStateCache
+		Wrapper::PipelineWarmup::Ptr mPipelineWarmup{ nullptr };
 		Wrapper::RenderPass::Ptr mRenderPass{ nullptr };
 		Wrapper::CommandPool::Ptr mCommandPool{ nullptr };
 
 		std::vector<Wrapper::CommandBuffer::Ptr> mCommandBuffers{};
 
+		//per frame in flight
 		std::vector<Wrapper::Semaphore::Ptr> mImageAvailableSemaphores{};
+
+		//per image: a present may still wait on an image's semaphore after its frame slot is reused
 		std::vector<Wrapper::Semaphore::Ptr> mRenderFinishedSemaphores{};
-		std::vector<Wrapper::Fence::Ptr> mFences{};
+
+		//per image, the graphics timeline value of the frame that last rendered into it (0 if none), so an image
+		//handed out again before its frame slot comes around is not rendered into while still in use
+		std::vector<uint64_t> mImagesInFlight{};
+
+		//swapchains, framebuffers, pipelines and semaphores that frames still in flight may use
+		Wrapper::DeletionQueue::Ptr mDeletionQueue{ nullptr };
 
 		UniformManager::Ptr mUniformManager{ nullptr };
 
+		Wrapper::Shader::Ptr mVertexShader{ nullptr };
+		Wrapper::Shader::Ptr mFragmentShader{ nullptr };
+		Wrapper::ReflectedLayout::Ptr mReflectedLayout{ nullptr };
+
 		Model::Ptr mModel{ nullptr };
 		VPMatrices	mVPMatrices;
 	};
@@ -2,15 +2,31 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <set>
 #include <array>
 #include <fstream>
+#include <sstream>
+#include <string>
 #include <stdexcept>
 #include <cstdlib>
 #include <cstring>
 #include <algorithm> // Necessary for std::clamp
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <functional>
+#include <cassert>
+#include <chrono>
+#include <tuple>
+#include <type_traits>
+#include <cmath>
+#include <numeric>
+
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
@@ -32,6 +48,10 @@ const std::vector<const char*> deviceExtensions = {
 const uint32_t WIDTH = 800;
 const uint32_t HEIGHT = 600;
 
+//frames the CPU may record ahead of the GPU, independent of how many images the swapchain has.
+//2 keeps latency low, 3 trades one frame of latency for more CPU/GPU overlap
+const uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
 struct VPMatrices {
 	glm::mat4 mViewMatrix;
 	glm::mat4 mProjectionMatrix;
@@ -42,6 +62,7 @@ struct VPMatrices {
 	}
 };
 
+//pushed per draw as push constants (lessionShader.vert), keep it within the 128 bytes every device supports
 struct ObjectUniform {
 	glm::mat4 mModelMatrix;
 
@@ -0,0 +1,74 @@
+#include "benchCommon.h"
+
+namespace Tea::Bench {
+
+	SampleStats SampleStats::fromSamples(std::vector<double> samples) {
+		SampleStats stats{};
+		if (samples.empty()) {
+			return stats;
+		}
+
+		std::sort(samples.begin(), samples.end());
+
+		auto percentile = [&samples](double p) {
+			size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+			return samples[std::min(index, samples.size() - 1)];
+		};
+
+		double sum = 0.0;
+		for (double sample : samples) {
+			sum += sample;
+		}
+
+		stats.mMean = sum / samples.size();
+		stats.mMin = samples.front();
+		stats.mMax = samples.back();
+		stats.mP50 = percentile(0.50);
+		stats.mP95 = percentile(0.95);
+		stats.mP99 = percentile(0.99);
+
+		return stats;
+	}
+
+	std::string SampleStats::toJson() const {
+		std::ostringstream json;
+
+		json << "{ \"mean\": " << mMean
+			<< ", \"min\": " << mMin
+			<< ", \"max\": " << mMax
+			<< ", \"p50\": " << mP50
+			<< ", \"p95\": " << mP95
+			<< ", \"p99\": " << mP99
+			<< " }";
+
+		return json.str();
+	}
+
+	const char* getDeviceTypeName(VkPhysicalDeviceType type) {
+		switch (type) {
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:	return "integrated";
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:		return "discrete";
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:		return "virtual";
+		case VK_PHYSICAL_DEVICE_TYPE_CPU:				return "cpu";
+		default:										return "other";
+		}
+	}
+
+	double toMilliseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	double toMicroseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+
+	uint64_t parseNumber(const std::string& name, const char* value, uint64_t minValue, uint64_t maxValue) {
+		char* end = nullptr;
+		unsigned long long number = std::strtoull(value, &end, 10);
+		if (end == value || *end != '\0' || number < minValue || number > maxValue) {
+			throw std::runtime_error("Error: " + name + " expects a number in [" + std::to_string(minValue) + ", " + std::to_string(maxValue) + "]");
+		}
+
+		return static_cast<uint64_t>(number);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Bench {
+	//distribution of per-frame or per-call samples, in whatever unit they were pushed
+	struct SampleStats {
+		double mMean{ 0.0 };
+		double mMin{ 0.0 };
+		double mMax{ 0.0 };
+		double mP50{ 0.0 };
+		double mP95{ 0.0 };
+		double mP99{ 0.0 };
+
+		static SampleStats fromSamples(std::vector<double> samples);
+
+		[[nodiscard]] std::string toJson() const;
+	};
+
+	[[nodiscard]] const char* getDeviceTypeName(VkPhysicalDeviceType type);
+
+	[[nodiscard]] double toMilliseconds(std::chrono::steady_clock::duration duration);
+
+	[[nodiscard]] double toMicroseconds(std::chrono::steady_clock::duration duration);
+
+	//parses an unsigned decimal option value and throws unless it lies in [minValue, maxValue]
+	uint64_t parseNumber(const std::string& name, const char* value, uint64_t minValue, uint64_t maxValue);
+}
@@ -0,0 +1,180 @@
+#include "benchConfig.h"
+
+namespace Tea::Bench {
+
+	static uint32_t parseCount(const std::string& name, const char* value, uint32_t minValue, uint32_t maxValue) {
+		return static_cast<uint32_t>(parseNumber(name, value, minValue, maxValue));
+	}
+
+	BenchConfig BenchConfig::parse(int argc, char** argv) {
+		BenchConfig config{};
+
+		for (int i = 1; i < argc; ++i) {
+			std::string name = argv[i];
+
+			if (name == "--validation") {
+				config.mValidation = true;
+				continue;
+			}
+
+			if (i + 1 >= argc) {
+				throw std::runtime_error("Error: missing value for " + name);
+			}
+			const char* value = argv[++i];
+
+			if (name == "--objects")		config.mObjectCount = parseCount(name, value, 1, MaxObjectCount);
+			else if (name == "--meshes")	config.mMeshCount = parseCount(name, value, 1, 1024);
+			else if (name == "--textures")	config.mTextureCount = parseCount(name, value, 1, 1024);
+			else if (name == "--pipelines")	config.mPipelineCount = parseCount(name, value, 1, 64);
+			else if (name == "--texture-size")	config.mTextureSize = parseCount(name, value, 1, 4096);
+			else if (name == "--frames")	config.mFrameCount = parseCount(name, value, 1, 1000000);
+			else if (name == "--warmup")	config.mWarmupFrames = parseCount(name, value, 0, 1000000);
+			else if (name == "--width")		config.mWidth = parseCount(name, value, 1, 16384);
+			else if (name == "--height")	config.mHeight = parseCount(name, value, 1, 16384);
+			else if (name == "--shaders")	config.mShaderDirectory = value;
+			else if (name == "--output")	config.mOutputPath = value;
+			else throw std::runtime_error("Error: unknown option " + name);
+		}
+
+		return config;
+	}
+
+	std::string BenchConfig::toJson() const {
+		std::ostringstream json;
+
+		json << "{ \"objects\": " << mObjectCount
+			<< ", \"meshes\": " << mMeshCount
+			<< ", \"textures\": " << mTextureCount
+			<< ", \"pipelines\": " << mPipelineCount
+			<< ", \"textureSize\": " << mTextureSize
+			<< ", \"frames\": " << mFrameCount
+			<< ", \"warmupFrames\": " << mWarmupFrames
+			<< ", \"width\": " << mWidth
+			<< ", \"height\": " << mHeight
+			<< ", \"validation\": " << (mValidation ? "true" : "false")
+			<< " }";
+
+		return json.str();
+	}
+
+	static std::vector<std::string> splitList(const char* value) {
+		std::vector<std::string> items{};
+		std::stringstream stream(value);
+		std::string item{};
+		while (std::getline(stream, item, ',')) {
+			items.push_back(item);
+		}
+
+		return items;
+	}
+
+	//"4096", "4K" or "16M"
+	static uint64_t parseSize(const std::string& name, std::string value) {
+		uint64_t unit = 1;
+		if (!value.empty() && (value.back() == 'K' || value.back() == 'k')) {
+			unit = 1ull << 10;
+			value.pop_back();
+		}
+		else if (!value.empty() && (value.back() == 'M' || value.back() == 'm')) {
+			unit = 1ull << 20;
+			value.pop_back();
+		}
+
+		uint64_t size = parseNumber(name, value.c_str(), 1, UploadBenchConfig::MaxSize) * unit;
+		if (size < UploadBenchConfig::MinSize || size > UploadBenchConfig::MaxSize) {
+			throw std::runtime_error("Error: " + name + " sizes have to lie in [4K, 256M]");
+		}
+
+		return size;
+	}
+
+	static UploadOperation parseOperation(const std::string& value) {
+		for (auto operation : { UploadOperation::Map, UploadOperation::MapPersistent, UploadOperation::Stage,
+								UploadOperation::FillImage, UploadOperation::SetImageLayout }) {
+			if (value == getUploadOperationName(operation)) {
+				return operation;
+			}
+		}
+
+		throw std::runtime_error("Error: unknown upload operation " + value);
+	}
+
+	const char* getUploadOperationName(UploadOperation operation) {
+		switch (operation) {
+		case UploadOperation::Map:				return "map";
+		case UploadOperation::MapPersistent:	return "mapPersistent";
+		case UploadOperation::Stage:			return "stage";
+		case UploadOperation::FillImage:		return "fillImage";
+		case UploadOperation::SetImageLayout:	return "setImageLayout";
+		default:								return "unknown";
+		}
+	}
+
+	UploadBenchConfig UploadBenchConfig::parse(int argc, char** argv) {
+		UploadBenchConfig config{};
+
+		for (int i = 1; i < argc; ++i) {
+			std::string name = argv[i];
+
+			if (name == "--validation") {
+				config.mValidation = true;
+				continue;
+			}
+
+			if (i + 1 >= argc) {
+				throw std::runtime_error("Error: missing value for " + name);
+			}
+			const char* value = argv[++i];
+
+			if (name == "--operations") {
+				config.mOperations.clear();
+				for (const auto& item : splitList(value)) {
+					config.mOperations.push_back(parseOperation(item));
+				}
+			}
+			else if (name == "--sizes") {
+				config.mSizes.clear();
+				for (const auto& item : splitList(value)) {
+					config.mSizes.push_back(parseSize(name, item));
+				}
+			}
+			else if (name == "--counts") {
+				config.mCounts.clear();
+				for (const auto& item : splitList(value)) {
+					config.mCounts.push_back(static_cast<uint32_t>(parseNumber(name, item.c_str(), 1, MaxCount)));
+				}
+			}
+			else if (name == "--max-case-mb")	config.mMaxCaseBytes = parseNumber(name, value, 1, 1ull << 20) << 20;
+			else if (name == "--output")		config.mOutputPath = value;
+			else throw std::runtime_error("Error: unknown option " + name);
+		}
+
+		if (config.mOperations.empty() || config.mSizes.empty() || config.mCounts.empty()) {
+			throw std::runtime_error("Error: --operations, --sizes and --counts must not be empty");
+		}
+
+		return config;
+	}
+
+	std::string UploadBenchConfig::toJson() const {
+		std::ostringstream json;
+
+		json << "{ \"operations\": [";
+		for (size_t i = 0; i < mOperations.size(); ++i) {
+			json << (i == 0 ? "" : ", ") << "\"" << getUploadOperationName(mOperations[i]) << "\"";
+		}
+		json << "], \"sizes\": [";
+		for (size_t i = 0; i < mSizes.size(); ++i) {
+			json << (i == 0 ? "" : ", ") << mSizes[i];
+		}
+		json << "], \"counts\": [";
+		for (size_t i = 0; i < mCounts.size(); ++i) {
+			json << (i == 0 ? "" : ", ") << mCounts[i];
+		}
+		json << "], \"maxCaseBytes\": " << mMaxCaseBytes
+			<< ", \"validation\": " << (mValidation ? "true" : "false")
+			<< " }";
+
+		return json.str();
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../base.h"
+#include "benchCommon.h"
+
+namespace Tea::Bench {
+	//Command line of tea_bench, every option is "--name value", e.g.
+	//tea_bench --objects 10000 --textures 16 --pipelines 4 --frames 1000 --output result.json
+
+	struct BenchConfig {
+		uint32_t	mObjectCount{ 1000 };	//1 to MaxObjectCount
+		uint32_t	mMeshCount{ 16 };
+		uint32_t	mTextureCount{ 4 };
+		uint32_t	mPipelineCount{ 2 };
+		uint32_t	mTextureSize{ 256 };
+
+		uint32_t	mFrameCount{ 500 };
+		uint32_t	mWarmupFrames{ 20 };
+
+		uint32_t	mWidth{ 1280 };
+		uint32_t	mHeight{ 720 };
+
+		bool		mValidation{ false };
+
+		std::string	mShaderDirectory{ "shaders" };
+
+		//empty: the JSON report goes to stdout
+		std::string	mOutputPath{};
+
+		static constexpr uint32_t MaxObjectCount = 100000;
+
+		static BenchConfig parse(int argc, char** argv);
+
+		[[nodiscard]] std::string toJson() const;
+	};
+
+	//Command line of tea_upload_bench, lists are comma separated and sizes accept K and M suffixes, e.g.
+	//tea_upload_bench --operations map,stage --sizes 4K,1M,64M --counts 1,100 --output upload.json
+
+	enum class UploadOperation {
+		Map,				//Buffer::updateBufferByMap on a buffer that is mapped per call
+		MapPersistent,		//Buffer::updateBufferByMap on a persistently mapped buffer
+		Stage,				//Buffer::updateBufferByStage
+		FillImage,			//Image::fillImageData, a square RGBA8 image of the payload size
+		SetImageLayout		//Image::setImageLayout, toggling TRANSFER_DST <-> SHADER_READ_ONLY
+	};
+
+	[[nodiscard]] const char* getUploadOperationName(UploadOperation operation);
+
+	struct UploadBenchConfig {
+		std::vector<UploadOperation> mOperations{
+			UploadOperation::Map, UploadOperation::MapPersistent, UploadOperation::Stage,
+			UploadOperation::FillImage, UploadOperation::SetImageLayout
+		};
+
+		std::vector<uint64_t>	mSizes{ 4ull << 10, 64ull << 10, 1ull << 20, 16ull << 20, 256ull << 20 };
+		std::vector<uint32_t>	mCounts{ 1, 10, 100, 1000, 10000 };
+
+		//a size/count case moving more than this is skipped, 256 MB x 10k calls would run for hours
+		uint64_t	mMaxCaseBytes{ 4ull << 30 };
+
+		bool		mValidation{ false };
+
+		std::string	mOutputPath{};
+
+		static constexpr uint64_t MinSize = 4ull << 10;
+		static constexpr uint64_t MaxSize = 256ull << 20;
+		static constexpr uint32_t MaxCount = 10000;
+
+		static UploadBenchConfig parse(int argc, char** argv);
+
+		[[nodiscard]] std::string toJson() const;
+	};
+}
@@ -0,0 +1,385 @@
+#include "frameBenchmark.h"
+
+namespace Tea::Bench {
+
+	std::string BenchResult::toJson() const {
+		std::ostringstream json;
+
+		json << "{\n";
+		json << "  \"device\": { \"name\": \"" << mDeviceName << "\", \"type\": \"" << mDeviceType
+			<< "\", \"apiVersion\": \"" << VK_VERSION_MAJOR(mApiVersion) << "." << VK_VERSION_MINOR(mApiVersion) << "." << VK_VERSION_PATCH(mApiVersion) << "\" },\n";
+		json << "  \"config\": " << mConfig.toJson() << ",\n";
+		json << "  \"measuredFrames\": " << mMeasuredFrames << ",\n";
+		json << "  \"fps\": " << mFramesPerSecond << ",\n";
+		json << "  \"cpuFrameMs\": " << mCpuFrameMs.toJson() << ",\n";
+		json << "  \"cpuRecordMs\": " << mCpuRecordMs.toJson() << ",\n";
+		json << "  \"gpuFrameMs\": " << (mGpuTimeSupported ? mGpuFrameMs.toJson() : "null") << ",\n";
+		json << "  \"perFrame\": { \"drawCalls\": " << mDrawCalls
+			<< ", \"pipelineBinds\": " << mPipelineBinds
+			<< ", \"descriptorSetBinds\": " << mDescriptorSetBinds
+			<< ", \"vertexBufferBinds\": " << mVertexBufferBinds
+			<< " },\n";
+		json << "  \"pipelines\": { \"buildMs\": " << mPipelineBuildMs
+			<< ", \"compiled\": " << mPipelinesCompiled
+			<< ", \"compilerThreads\": " << mPipelineCompilerThreads
+			<< " },\n";
+		json << "  \"pipelineCreation\": " << mPipelineCreationJson << ",\n";
+		json << "  \"frameAllocateMemoryCalls\": " << mFrameAllocateMemoryCalls << ",\n";
+		json << "  \"memory\": " << mMemory.toJson();
+		json << "}\n";
+
+		return json.str();
+	}
+
+	FrameBenchmark::FrameBenchmark(const BenchConfig& config) {
+		mConfig = config;
+
+		mInstance = Wrapper::Instance::create(mConfig.mValidation, true);
+		mDevice = Wrapper::Device::create(mInstance, nullptr);
+		mCommandPool = Wrapper::CommandPool::create(mDevice);
+
+		mTarget = Wrapper::OffscreenTarget::create(mDevice, mConfig.mWidth, mConfig.mHeight, FrameCount);
+
+		createRenderPass();
+		mTarget->createFrameBuffers(mRenderPass);
+
+		mScene = SyntheticScene::create(mDevice, mCommandPool, mConfig, FrameCount);
+
+		createPipelines();
+
+		for (uint32_t i = 0; i < FrameCount; ++i) {
+			mCommandBuffers.push_back(Wrapper::CommandBuffer::create(mDevice, mCommandPool));
+		}
+
+		//a begin and an end timestamp per frame slot
+		mQueryPool = Wrapper::QueryPool::create(mDevice, FrameCount * 2);
+	}
+
+	FrameBenchmark::~FrameBenchmark() {
+		vkDeviceWaitIdle(mDevice->getDevice());
+	}
+
+	void FrameBenchmark::createRenderPass() {
+		mRenderPass = Wrapper::RenderPass::create(mDevice);
+
+		VkAttachmentDescription colorAttachmentDes{};
+		colorAttachmentDes.format = mTarget->getFormat();
+		colorAttachmentDes.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachmentDes.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachmentDes.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachmentDes.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachmentDes.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachmentDes.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		colorAttachmentDes.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+		mRenderPass->addAttachment(colorAttachmentDes);
+
+		VkAttachmentDescription depthAttachmentDes{};
+		depthAttachmentDes.format = Wrapper::Image::findDepthFormat(mDevice);
+		depthAttachmentDes.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthAttachmentDes.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAttachmentDes.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachmentDes.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachmentDes.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachmentDes.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		depthAttachmentDes.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		mRenderPass->addAttachment(depthAttachmentDes);
+
+		VkAttachmentReference colorAttachmentRef{};
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentReference depthAttachmentRef{};
+		depthAttachmentRef.attachment = 1;
+		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		Wrapper::SubPass subPass{};
+		subPass.addColorAttachmentReference(colorAttachmentRef);
+		subPass.setDepthStencilAttachmentReference(depthAttachmentRef);
+		subPass.buildSubPassDescription();
+
+		mRenderPass->addSubPass(subPass);
+
+		//same dependency as the application: the shared depth image is cleared only after the previous frame's depth writes
+		VkSubpassDependency dependency{};
+		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependency.dstSubpass = 0;
+		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		mRenderPass->addDependency(dependency);
+
+		mRenderPass->buildRenderPass();
+	}
+
+	void FrameBenchmark::createPipelines() {
+		auto shaderVertex = Wrapper::Shader::create(mDevice, mConfig.mShaderDirectory + "/vs.spv", VK_SHADER_STAGE_VERTEX_BIT, "main");
+
+		//specialization constant 0 (USE_TEXTURE) gives a textured and a vertex colored variant of the one module
+		Wrapper::SpecializationConstants textured{}, vertexColored{};
+		textured.set<VkBool32>(0, VK_TRUE);
+		vertexColored.set<VkBool32>(0, VK_FALSE);
+		std::array<Wrapper::Shader::Ptr, 2> shaderFragments = {
+			Wrapper::Shader::create(mDevice, mConfig.mShaderDirectory + "/fs.spv", VK_SHADER_STAGE_FRAGMENT_BIT, "main", textured),
+			Wrapper::Shader::create(mDevice, mConfig.mShaderDirectory + "/fs.spv", VK_SHADER_STAGE_FRAGMENT_BIT, "main", vertexColored)
+		};
+
+		auto vertexBindingDes = SyntheticScene::getVertexInputBindingDescriptions();
+		auto vertexAttributeDes = SyntheticScene::getAttributeDescriptions();
+		auto layout = mScene->getDescriptorLayout();
+
+		VkViewport viewport{};
+		viewport.width = static_cast<float>(mConfig.mWidth);
+		viewport.height = static_cast<float>(mConfig.mHeight);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = { mConfig.mWidth, mConfig.mHeight };
+
+		auto start = std::chrono::steady_clock::now();
+
+		//the variants differ in state a material system would switch: culling, depth compare, blending and texturing
+		for (uint32_t i = 0; i < mConfig.mPipelineCount; ++i) {
+			auto pipeline = Wrapper::Pipeline::create(mDevice, mRenderPass);
+
+			pipeline->setViewports({ viewport });
+			pipeline->setScissors({ scissor });
+			pipeline->setShaderGroup({ shaderVertex, shaderFragments[(i / 8) % 2] });
+
+			pipeline->mVertexInputState.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindingDes.size());
+			pipeline->mVertexInputState.pVertexBindingDescriptions = vertexBindingDes.data();
+			pipeline->mVertexInputState.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributeDes.size());
+			pipeline->mVertexInputState.pVertexAttributeDescriptions = vertexAttributeDes.data();
+
+			pipeline->mAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+			pipeline->mAssemblyState.primitiveRestartEnable = VK_FALSE;
+
+			pipeline->mRasterState.polygonMode = VK_POLYGON_MODE_FILL;
+			pipeline->mRasterState.lineWidth = 1.0f;
+			pipeline->mRasterState.cullMode = i % 2 == 0 ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+			pipeline->mRasterState.frontFace = VK_FRONT_FACE_CLOCKWISE;
+			pipeline->mRasterState.depthBiasEnable = VK_FALSE;
+
+			pipeline->mSampleState.sampleShadingEnable = VK_FALSE;
+			pipeline->mSampleState.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+			pipeline->mSampleState.minSampleShading = 1.0f;
+
+			pipeline->mDepthStencilState.depthTestEnable = VK_TRUE;
+			pipeline->mDepthStencilState.depthWriteEnable = VK_TRUE;
+			pipeline->mDepthStencilState.depthCompareOp = (i / 2) % 2 == 0 ? VK_COMPARE_OP_LESS_OR_EQUAL : VK_COMPARE_OP_ALWAYS;
+
+			bool blend = (i / 4) % 2 == 1;
+
+			VkPipelineColorBlendAttachmentState blendAttachment{};
+			blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+			blendAttachment.blendEnable = blend ? VK_TRUE : VK_FALSE;
+			blendAttachment.srcColorBlendFactor = blend ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ONE;
+			blendAttachment.dstColorBlendFactor = blend ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO;
+			blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+			blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+			blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+			pipeline->pushBlendAttachment(blendAttachment);
+
+			pipeline->mLayoutState.setLayoutCount = 1;
+			pipeline->mLayoutState.pSetLayouts = &layout;
+			pipeline->addPushConstantRange<ObjectUniform>(VK_SHADER_STAGE_VERTEX_BIT);
+
+			pipeline->buildAsync();
+
+			mPipelines.push_back(pipeline);
+		}
+
+		for (auto& pipeline : mPipelines) {
+			pipeline->wait();
+		}
+
+		mPipelineBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void FrameBenchmark::recordCommandBuffer(uint32_t frameIndex, BenchResult& result) {
+		auto& commandBuffer = mCommandBuffers[frameIndex];
+
+		commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+		commandBuffer->resetQueryPool(mQueryPool->getQueryPool(), frameIndex * 2, 2);
+		commandBuffer->writeTimestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mQueryPool->getQueryPool(), frameIndex * 2);
+
+		VkRenderPassBeginInfo renderBeginInfo{};
+		renderBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderBeginInfo.renderPass = mRenderPass->getRenderPass();
+		renderBeginInfo.framebuffer = mTarget->getFrameBuffer(frameIndex);
+		renderBeginInfo.renderArea.offset = { 0, 0 };
+		renderBeginInfo.renderArea.extent = mTarget->getExtent();
+
+		std::array<VkClearValue, 2> clearValues{};
+		clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
+		clearValues[1].depthStencil = { 1.0f, 0 };
+		renderBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+		renderBeginInfo.pClearValues = clearValues.data();
+
+		commandBuffer->beginRenderPass(renderBeginInfo);
+
+		//objects are sorted, so state is only rebound when it changes. Per object data is pushed with the draw,
+		//the descriptor set only changes with the texture: all pipelines share one layout, so a bound set stays valid
+		uint32_t drawCalls = 0, pipelineBinds = 0, descriptorSetBinds = 0, vertexBufferBinds = 0;
+		uint32_t boundPipeline = UINT32_MAX, boundTexture = UINT32_MAX, boundMesh = UINT32_MAX;
+
+		mDynamicOffsets[0] = mScene->getViewProjectionOffset();
+
+		const auto& objects = mScene->getObjects();
+		for (size_t i = 0; i < objects.size(); ++i) {
+			const auto& object = objects[i];
+
+			if (object.mPipeline != boundPipeline) {
+				commandBuffer->bindGraphicPipeline(mPipelines[object.mPipeline]->getPipeline());
+				boundPipeline = object.mPipeline;
+				pipelineBinds++;
+			}
+
+			auto layout = mPipelines[object.mPipeline]->getLayout();
+			if (object.mTexture != boundTexture) {
+				commandBuffer->bindDescriptorSet(layout, mScene->getDescriptorSet(object.mTexture, frameIndex), mDynamicOffsets);
+				boundTexture = object.mTexture;
+				descriptorSetBinds++;
+			}
+
+			commandBuffer->pushConstants(layout, VK_SHADER_STAGE_VERTEX_BIT, mScene->getObjectUniform(i));
+
+			const auto& mesh = mScene->getMesh(object.mMesh);
+			if (object.mMesh != boundMesh) {
+				commandBuffer->bindVertexBuffer({ mesh.mPositionBuffer->getBuffer(), mesh.mColorBuffer->getBuffer(), mesh.mUVBuffer->getBuffer() });
+				commandBuffer->bindIndexBuffer(mesh.mIndexBuffer->getBuffer());
+				boundMesh = object.mMesh;
+				vertexBufferBinds++;
+			}
+
+			commandBuffer->drawIndex(mesh.mIndexCount);
+			drawCalls++;
+		}
+
+		commandBuffer->endRenderPass();
+
+		commandBuffer->writeTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mQueryPool->getQueryPool(), frameIndex * 2 + 1);
+
+		commandBuffer->end();
+
+		result.mDrawCalls = drawCalls;
+		result.mPipelineBinds = pipelineBinds;
+		result.mDescriptorSetBinds = descriptorSetBinds;
+		result.mVertexBufferBinds = vertexBufferBinds;
+	}
+
+	bool FrameBenchmark::readGpuTime(uint32_t frameIndex, double& milliseconds) {
+		if (!mPendingGpuTime[frameIndex]) {
+			return false;
+		}
+		mPendingGpuTime[frameIndex] = false;
+
+		std::vector<uint64_t> timestamps{};
+		if (!mQueryPool->getResults(frameIndex * 2, 2, timestamps)) {
+			return false;
+		}
+
+		milliseconds = mQueryPool->toNanoseconds(timestamps[0], timestamps[1]) / 1.0e6;
+		return true;
+	}
+
+	BenchResult FrameBenchmark::run() {
+		BenchResult result{};
+		result.mConfig = mConfig;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+		result.mDeviceName = properties.deviceName;
+		result.mDeviceType = getDeviceTypeName(properties.deviceType);
+		result.mApiVersion = properties.apiVersion;
+		result.mGpuTimeSupported = mQueryPool->isTimestampSupported();
+
+		std::vector<double> cpuFrameSamples{}, cpuRecordSamples{}, gpuFrameSamples{};
+		cpuFrameSamples.reserve(mConfig.mFrameCount);
+		cpuRecordSamples.reserve(mConfig.mFrameCount);
+		gpuFrameSamples.reserve(mConfig.mFrameCount);
+
+		uint64_t allocateMemoryCalls = 0;
+		auto measureStart = std::chrono::steady_clock::now();
+		auto frameStart = measureStart;
+
+		uint32_t totalFrames = mConfig.mWarmupFrames + mConfig.mFrameCount;
+		for (uint32_t frame = 0; frame < totalFrames; ++frame) {
+			bool measured = frame >= mConfig.mWarmupFrames;
+			uint32_t frameIndex = frame % FrameCount;
+
+			if (frame == mConfig.mWarmupFrames) {
+				allocateMemoryCalls = mDevice->getAllocator()->getStats().mAllocateMemoryCalls;
+				measureStart = std::chrono::steady_clock::now();
+				frameStart = measureStart;
+			}
+
+			//the slot's previous frame has to be done before its command buffer, uniforms and queries are reused
+			mDevice->getFrameScheduler()->wait(Wrapper::QueueType::Graphics, mFrameValues[frameIndex]);
+
+			double gpuMs = 0.0;
+			if (readGpuTime(frameIndex, gpuMs)) {
+				gpuFrameSamples.push_back(gpuMs);
+			}
+
+			auto recordStart = std::chrono::steady_clock::now();
+
+			mScene->update();
+			mScene->writeUniforms(frameIndex);
+
+			recordCommandBuffer(frameIndex, result);
+
+			mFrameValues[frameIndex] = mCommandBuffers[frameIndex]->submit(Wrapper::QueueType::Graphics);
+
+			mPendingGpuTime[frameIndex] = measured && result.mGpuTimeSupported;
+
+			auto recordEnd = std::chrono::steady_clock::now();
+
+			if (measured) {
+				cpuRecordSamples.push_back(toMilliseconds(recordEnd - recordStart));
+
+				//the frame time of this frame ends where the next one starts, the last frame ends when its slot is free again
+				if (frame > mConfig.mWarmupFrames) {
+					cpuFrameSamples.push_back(toMilliseconds(recordStart - frameStart));
+				}
+				frameStart = recordStart;
+			}
+		}
+
+		vkDeviceWaitIdle(mDevice->getDevice());
+		auto measureEnd = std::chrono::steady_clock::now();
+
+		for (uint32_t frameIndex = 0; frameIndex < FrameCount; ++frameIndex) {
+			double gpuMs = 0.0;
+			if (readGpuTime(frameIndex, gpuMs)) {
+				gpuFrameSamples.push_back(gpuMs);
+			}
+		}
+
+		cpuFrameSamples.push_back(toMilliseconds(measureEnd - frameStart));
+
+		double seconds = std::chrono::duration<double>(measureEnd - measureStart).count();
+
+		result.mMeasuredFrames = mConfig.mFrameCount;
+		result.mFramesPerSecond = seconds > 0.0 ? mConfig.mFrameCount / seconds : 0.0;
+		result.mCpuFrameMs = SampleStats::fromSamples(cpuFrameSamples);
+		result.mCpuRecordMs = SampleStats::fromSamples(cpuRecordSamples);
+		result.mGpuFrameMs = SampleStats::fromSamples(gpuFrameSamples);
+		result.mFrameAllocateMemoryCalls = mDevice->getAllocator()->getStats().mAllocateMemoryCalls - allocateMemoryCalls;
+		result.mMemory = mDevice->getMemoryReport();
+
+		result.mPipelineBuildMs = mPipelineBuildMs;
+		result.mPipelinesCompiled = mDevice->getPipelineStateCache()->getStats().mPipelinesCreated;
+		result.mPipelineCompilerThreads = mDevice->getPipelineCompiler()->getThreadCount();
+		result.mPipelineCreationJson = mDevice->getPipelineStateCache()->getCreationLog()->toJson();
+
+		return result;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../base.h"
+#include "../vulkanWrapper/instance.h"
+#include "../vulkanWrapper/device.h"
+#include "../vulkanWrapper/offscreenTarget.h"
+#include "../vulkanWrapper/renderPass.h"
+#include "../vulkanWrapper/pipeline.h"
+#include "../vulkanWrapper/shader.h"
+#include "../vulkanWrapper/commandPool.h"
+#include "../vulkanWrapper/commandBuffer.h"
+#include "../vulkanWrapper/queryPool.h"
+#include "benchCommon.h"
+#include "benchConfig.h"
+#include "syntheticScene.h"
+
+namespace Tea::Bench {
+	struct BenchResult {
+		std::string		mDeviceName{};
+		std::string		mDeviceType{};
+		uint32_t		mApiVersion{ 0 };
+
+		BenchConfig		mConfig{};
+
+		uint32_t		mMeasuredFrames{ 0 };
+		double			mFramesPerSecond{ 0.0 };
+
+		SampleStats		mCpuFrameMs{};		//frame start to frame start, including the wait for a free frame slot
+		SampleStats		mCpuRecordMs{};		//uniform update, command recording and submit
+		bool			mGpuTimeSupported{ false };
+		SampleStats		mGpuFrameMs{};		//timestamps around the render pass
+
+		//per frame, identical for every frame of a run
+		uint32_t		mDrawCalls{ 0 };
+		uint32_t		mPipelineBinds{ 0 };
+		uint32_t		mDescriptorSetBinds{ 0 };
+		uint32_t		mVertexBufferBinds{ 0 };
+
+		//wall time from the first buildAsync until every pipeline variant was compiled, and how many
+		//of the variants actually needed a compile (equal state is shared, see PipelineStateCache)
+		double			mPipelineBuildMs{ 0.0 };
+		uint64_t		mPipelinesCompiled{ 0 };
+		uint32_t		mPipelineCompilerThreads{ 0 };
+
+		//per pipeline compile time and cache hits, see PipelineCreationLog
+		std::string		mPipelineCreationJson{};
+
+		//vkAllocateMemory calls while the measured frames ran, anything but 0 means per frame allocations
+		uint64_t		mFrameAllocateMemoryCalls{ 0 };
+		Wrapper::MemoryReport mMemory{};
+
+		[[nodiscard]] std::string toJson() const;
+	};
+
+	//Renders a SyntheticScene headlessly into an OffscreenTarget for mWarmupFrames + mFrameCount frames
+	//and measures the mFrameCount frames after the warm-up. Runs on any Vulkan device including lavapipe.
+	class FrameBenchmark {
+	public:
+		using Ptr = std::shared_ptr<FrameBenchmark>;
+		static Ptr create(const BenchConfig& config) { return std::make_shared<FrameBenchmark>(config); }
+
+		explicit FrameBenchmark(const BenchConfig& config);
+
+		~FrameBenchmark();
+
+		BenchResult run();
+
+		//frames in flight, one offscreen image, command buffer and timestamp pair each
+		static constexpr uint32_t FrameCount = 3;
+
+	private:
+		void createRenderPass();
+
+		//all variants are compiled in parallel on the device's PipelineCompiler
+		void createPipelines();
+
+		void recordCommandBuffer(uint32_t frameIndex, BenchResult& result);
+
+		//reads the timestamps of the frame that last used frameIndex, false if the slot holds no measured frame
+		bool readGpuTime(uint32_t frameIndex, double& milliseconds);
+
+		BenchConfig mConfig{};
+
+		Wrapper::Instance::Ptr mInstance{ nullptr };
+		Wrapper::Device::Ptr mDevice{ nullptr };
+		Wrapper::CommandPool::Ptr mCommandPool{ nullptr };
+		Wrapper::OffscreenTarget::Ptr mTarget{ nullptr };
+		Wrapper::RenderPass::Ptr mRenderPass{ nullptr };
+		std::vector<Wrapper::Pipeline::Ptr> mPipelines{};
+		double mPipelineBuildMs{ 0.0 };
+
+		SyntheticScene::Ptr mScene{ nullptr };
+
+		std::vector<Wrapper::CommandBuffer::Ptr> mCommandBuffers{};
+		//graphics timeline value of the frame last submitted in each slot
+		std::array<uint64_t, FrameCount> mFrameValues{};
+
+		Wrapper::QueryPool::Ptr mQueryPool{ nullptr };
+
+		//whether the frame last submitted in a slot is past the warm-up and its timestamps still have to be read
+		std::array<bool, FrameCount> mPendingGpuTime{};
+
+		std::vector<uint32_t> mDynamicOffsets{ 0 };
+	};
+}
@@ -0,0 +1,34 @@
+#include "../base.h"
+#include "benchConfig.h"
+#include "frameBenchmark.h"
+
+//tea_bench: renders a synthetic scene headlessly and prints (or writes with --output) a JSON report.
+//Exits with 1 on any error so CI can tell a crashed run from a slow one.
+int main(int argc, char** argv) {
+	try {
+		auto config = Tea::Bench::BenchConfig::parse(argc, argv);
+
+		std::string json{};
+		{
+			auto benchmark = Tea::Bench::FrameBenchmark::create(config);
+			json = benchmark->run().toJson();
+		}
+
+		if (config.mOutputPath.empty()) {
+			std::cout << json;
+		}
+		else {
+			std::ofstream file(config.mOutputPath, std::ios::out | std::ios::trunc);
+			if (!file) {
+				throw std::runtime_error("Error: failed to open " + config.mOutputPath);
+			}
+			file << json;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,218 @@
+#include "syntheticScene.h"
+
+namespace Tea::Bench {
+
+	SyntheticScene::SyntheticScene(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, const BenchConfig& config, uint32_t frameCount) {
+		mDevice = device;
+
+		createMeshes(config);
+		createTextures(commandPool, config);
+		createObjects(config);
+		createDescriptors(frameCount);
+	}
+
+	SyntheticScene::~SyntheticScene() {
+	}
+
+	void SyntheticScene::createMeshes(const BenchConfig& config) {
+		//all meshes are uploaded with one batch
+		auto uploadBatch = Wrapper::UploadBatch::create(mDevice);
+
+		mMeshes.resize(config.mMeshCount);
+		for (uint32_t m = 0; m < config.mMeshCount; ++m) {
+			//a fan around the center, mesh m has 3 + m % 30 rim vertices so the meshes differ in vertex and index count
+			uint32_t rimCount = 3 + m % 30;
+
+			std::vector<float> positions{ 0.0f, 0.0f, 0.0f };
+			std::vector<float> colors{ 1.0f, 1.0f, 1.0f };
+			std::vector<float> uvs{ 0.5f, 0.5f };
+			std::vector<uint32_t> indices{};
+
+			for (uint32_t i = 0; i < rimCount; ++i) {
+				float angle = glm::radians(360.0f * i / rimCount);
+				float x = std::cos(angle);
+				float y = std::sin(angle);
+
+				positions.insert(positions.end(), { x, y, 0.0f });
+				colors.insert(colors.end(), { 0.5f + 0.5f * x, 0.5f + 0.5f * y, static_cast<float>(m % 4) / 3.0f });
+				uvs.insert(uvs.end(), { 0.5f + 0.5f * x, 0.5f + 0.5f * y });
+
+				indices.insert(indices.end(), { 0, 1 + i, 1 + (i + 1) % rimCount });
+			}
+
+			auto& mesh = mMeshes[m];
+			mesh.mIndexCount = static_cast<uint32_t>(indices.size());
+
+			mesh.mPositionBuffer = Wrapper::Buffer::createVertexBuffer(mDevice, positions.size() * sizeof(float), positions.data(), *uploadBatch);
+			mesh.mColorBuffer = Wrapper::Buffer::createVertexBuffer(mDevice, colors.size() * sizeof(float), colors.data(), *uploadBatch);
+			mesh.mUVBuffer = Wrapper::Buffer::createVertexBuffer(mDevice, uvs.size() * sizeof(float), uvs.data(), *uploadBatch);
+			mesh.mIndexBuffer = Wrapper::Buffer::createIndexBuffer(mDevice, indices.size() * sizeof(uint32_t), indices.data(), *uploadBatch);
+		}
+
+		uploadBatch->wait(uploadBatch->submit());
+	}
+
+	void SyntheticScene::createTextures(const Wrapper::CommandPool::Ptr& commandPool, const BenchConfig& config) {
+		uint32_t size = config.mTextureSize;
+		std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+
+		//like the meshes, the batch copies each texture's pixels before the next one is generated
+		auto uploadBatch = Wrapper::UploadBatch::create(mDevice);
+
+		mTextures.resize(config.mTextureCount);
+		for (uint32_t t = 0; t < config.mTextureCount; ++t) {
+			//checkerboards with a different tint and square size per texture
+			uint32_t square = 4u << (t % 5);
+			uint8_t r = static_cast<uint8_t>(64 + (t * 53) % 192);
+			uint8_t g = static_cast<uint8_t>(64 + (t * 97) % 192);
+			uint8_t b = static_cast<uint8_t>(64 + (t * 151) % 192);
+
+			for (uint32_t y = 0; y < size; ++y) {
+				for (uint32_t x = 0; x < size; ++x) {
+					bool dark = ((x / square) + (y / square)) % 2 == 0;
+					uint8_t* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+
+					pixel[0] = dark ? r / 2 : r;
+					pixel[1] = dark ? g / 2 : g;
+					pixel[2] = dark ? b / 2 : b;
+					pixel[3] = 255;
+				}
+			}
+
+			mTextures[t] = Texture::create(mDevice, commandPool, *uploadBatch, static_cast<int>(size), static_cast<int>(size), pixels.data());
+		}
+
+		uploadBatch->wait(uploadBatch->submit());
+	}
+
+	void SyntheticScene::createObjects(const BenchConfig& config) {
+		//square grid over the whole target, the identity view/projection maps it straight to clip space
+		uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(config.mObjectCount))));
+		float cell = 2.0f / columns;
+
+		mObjects.resize(config.mObjectCount);
+		for (uint32_t i = 0; i < config.mObjectCount; ++i) {
+			auto& object = mObjects[i];
+			object.mPipeline = i % config.mPipelineCount;
+			object.mTexture = (i / config.mPipelineCount) % config.mTextureCount;
+			object.mMesh = i % config.mMeshCount;
+
+			object.mPosition = glm::vec3(
+				-1.0f + cell * (i % columns + 0.5f),
+				-1.0f + cell * (i / columns + 0.5f),
+				0.1f + 0.8f * (i % 7) / 7.0f);
+			object.mScale = cell * 0.45f;
+			object.mAngle = static_cast<float>(i % 360);
+			object.mSpin = 0.5f + (i % 5) * 0.25f;
+		}
+
+		std::sort(mObjects.begin(), mObjects.end(), [](const BenchObject& a, const BenchObject& b) {
+			return std::tie(a.mPipeline, a.mTexture, a.mMesh) < std::tie(b.mPipeline, b.mTexture, b.mMesh);
+		});
+
+		mObjectUniforms.resize(mObjects.size());
+	}
+
+	void SyntheticScene::createDescriptors(uint32_t frameCount) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+
+		//room for the view/projection per frame, rounded up to the dynamic offset alignment
+		VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+		VkDeviceSize frameCapacity = (sizeof(VPMatrices) + alignment - 1) / alignment * alignment;
+
+		mRingAllocator = Wrapper::UniformRingAllocator::create(mDevice, frameCount, frameCapacity);
+
+		mUniformParams.resize(mTextures.size());
+		for (size_t t = 0; t < mTextures.size(); ++t) {
+			auto vpParam = Wrapper::UniformParameter::create();
+			vpParam->mBinding = 0;
+			vpParam->mCount = 1;
+			vpParam->mDescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			vpParam->mSize = sizeof(VPMatrices);
+			vpParam->mStage = VK_SHADER_STAGE_VERTEX_BIT;
+			vpParam->mRingAllocator = mRingAllocator;
+
+			auto textureParam = Wrapper::UniformParameter::create();
+			textureParam->mBinding = 2;
+			textureParam->mCount = 1;
+			textureParam->mDescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			textureParam->mStage = VK_SHADER_STAGE_FRAGMENT_BIT;
+			textureParam->mTexture = mTextures[t];
+
+			mUniformParams[t] = { vpParam, textureParam };
+		}
+
+		mDescriptorSetLayout = Wrapper::DescriptorSetLayout::create(mDevice);
+		mDescriptorSetLayout->build(mUniformParams[0]);
+
+		//frameCount sets per texture
+		mDescriptorPool = Wrapper::DescriptorPool::create(mDevice);
+		mDescriptorPool->build(mUniformParams[0], static_cast<int>(frameCount * mTextures.size()));
+
+		for (const auto& params : mUniformParams) {
+			mDescriptorSets.push_back(Wrapper::DescriptorSet::create(mDevice, params, mDescriptorPool, mDescriptorSetLayout, static_cast<int>(frameCount)));
+		}
+	}
+
+	void SyntheticScene::update() {
+		for (auto& object : mObjects) {
+			object.mAngle += object.mSpin;
+		}
+	}
+
+	void SyntheticScene::writeUniforms(uint32_t frameIndex) {
+		mRingAllocator->beginFrame(frameIndex);
+
+		mViewProjectionOffset = mRingAllocator->push(mVPMatrices);
+
+		mRingAllocator->endFrame();
+
+		for (size_t i = 0; i < mObjects.size(); ++i) {
+			const auto& object = mObjects[i];
+
+			glm::mat4 model = glm::translate(glm::mat4(1.0f), object.mPosition);
+			model = glm::rotate(model, glm::radians(object.mAngle), glm::vec3(0.0f, 0.0f, 1.0f));
+			mObjectUniforms[i].mModelMatrix = glm::scale(model, glm::vec3(object.mScale));
+		}
+	}
+
+	std::vector<VkVertexInputBindingDescription> SyntheticScene::getVertexInputBindingDescriptions() {
+		std::vector<VkVertexInputBindingDescription> bindingDes(3);
+
+		bindingDes[0].binding = 0;
+		bindingDes[0].stride = sizeof(float) * 3;
+		bindingDes[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		bindingDes[1].binding = 1;
+		bindingDes[1].stride = sizeof(float) * 3;
+		bindingDes[1].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		bindingDes[2].binding = 2;
+		bindingDes[2].stride = sizeof(float) * 2;
+		bindingDes[2].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return bindingDes;
+	}
+
+	std::vector<VkVertexInputAttributeDescription> SyntheticScene::getAttributeDescriptions() {
+		std::vector<VkVertexInputAttributeDescription> attributeDes(3);
+
+		attributeDes[0].binding = 0;
+		attributeDes[0].location = 0;
+		attributeDes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+		attributeDes[0].offset = 0;
+
+		attributeDes[1].binding = 1;
+		attributeDes[1].location = 1;
+		attributeDes[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+		attributeDes[1].offset = 0;
+
+		attributeDes[2].binding = 2;
+		attributeDes[2].location = 2;
+		attributeDes[2].format = VK_FORMAT_R32G32_SFLOAT;
+		attributeDes[2].offset = 0;
+
+		return attributeDes;
+	}
+}
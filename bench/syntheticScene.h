@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../base.h"
+#include "../vulkanWrapper/device.h"
+#include "../vulkanWrapper/buffer.h"
+#include "../vulkanWrapper/commandPool.h"
+#include "../vulkanWrapper/uploadBatch.h"
+#include "../vulkanWrapper/uniformRingAllocator.h"
+#include "../vulkanWrapper/description.h"
+#include "../vulkanWrapper/descriptorSetLayout.h"
+#include "../vulkanWrapper/descriptorPool.h"
+#include "../vulkanWrapper/descriptorSet.h"
+#include "../texture/texture.h"
+#include "benchConfig.h"
+
+namespace Tea::Bench {
+	//Model-like geometry: separate position/color/uv streams and a uint32 index buffer, drawn with the regular shaders
+	struct BenchMesh {
+		Wrapper::Buffer::Ptr mPositionBuffer{ nullptr };
+		Wrapper::Buffer::Ptr mColorBuffer{ nullptr };
+		Wrapper::Buffer::Ptr mUVBuffer{ nullptr };
+		Wrapper::Buffer::Ptr mIndexBuffer{ nullptr };
+		uint32_t mIndexCount{ 0 };
+	};
+
+	struct BenchObject {
+		uint32_t	mPipeline{ 0 };
+		uint32_t	mTexture{ 0 };
+		uint32_t	mMesh{ 0 };
+
+		glm::vec3	mPosition{ 0.0f };
+		float		mScale{ 1.0f };
+		float		mAngle{ 0.0f };
+		float		mSpin{ 0.0f };
+	};
+
+	//A grid of objects that cycle through mMeshCount meshes, mTextureCount generated textures and mPipelineCount pipelines.
+	//Objects are sorted by pipeline, texture and mesh, the order a real renderer would submit them in.
+	//Every object has its own ObjectUniform, sent as push constants with its draw. The uniform ring only holds the view/projection.
+	class SyntheticScene {
+	public:
+		using Ptr = std::shared_ptr<SyntheticScene>;
+		static Ptr create(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, const BenchConfig& config, uint32_t frameCount) {
+			return std::make_shared<SyntheticScene>(device, commandPool, config, frameCount);
+		}
+
+		SyntheticScene(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, const BenchConfig& config, uint32_t frameCount);
+
+		~SyntheticScene();
+
+		void update();
+
+		//fills the frame's uniform ring region with the view/projection and computes every object's ObjectUniform
+		void writeUniforms(uint32_t frameIndex);
+
+		[[nodiscard]] const auto& getObjects() const { return mObjects; }
+
+		[[nodiscard]] const auto& getMesh(uint32_t index) const { return mMeshes[index]; }
+
+		[[nodiscard]] auto getDescriptorSet(uint32_t texture, uint32_t frameIndex) const { return mDescriptorSets[texture]->getDescriptorSet(frameIndex); }
+
+		[[nodiscard]] auto getDescriptorLayout() const { return mDescriptorSetLayout->getLayout(); }
+
+		[[nodiscard]] auto getViewProjectionOffset() const { return mViewProjectionOffset; }
+
+		[[nodiscard]] const auto& getObjectUniform(size_t object) const { return mObjectUniforms[object]; }
+
+		static std::vector<VkVertexInputBindingDescription> getVertexInputBindingDescriptions();
+
+		static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+
+	private:
+		void createMeshes(const BenchConfig& config);
+
+		void createTextures(const Wrapper::CommandPool::Ptr& commandPool, const BenchConfig& config);
+
+		void createObjects(const BenchConfig& config);
+
+		void createDescriptors(uint32_t frameCount);
+
+		Wrapper::Device::Ptr mDevice{ nullptr };
+
+		std::vector<BenchMesh> mMeshes{};
+		std::vector<Texture::Ptr> mTextures{};
+		std::vector<BenchObject> mObjects{};
+
+		VPMatrices mVPMatrices{};
+
+		Wrapper::UniformRingAllocator::Ptr mRingAllocator{ nullptr };
+		uint32_t mViewProjectionOffset{ 0 };
+		std::vector<ObjectUniform> mObjectUniforms{};
+
+		//one set of uniform parameters and descriptor sets per texture, they only differ in binding 2
+		std::vector<std::vector<Wrapper::UniformParameter::Ptr>> mUniformParams{};
+		Wrapper::DescriptorSetLayout::Ptr mDescriptorSetLayout{ nullptr };
+		Wrapper::DescriptorPool::Ptr mDescriptorPool{ nullptr };
+		std::vector<Wrapper::DescriptorSet::Ptr> mDescriptorSets{};
+	};
+}
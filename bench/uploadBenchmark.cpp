@@ -0,0 +1,252 @@
+#include "uploadBenchmark.h"
+
+namespace Tea::Bench {
+
+	std::string UploadCaseResult::toJson() const {
+		std::ostringstream json;
+
+		json << "{ \"operation\": \"" << getUploadOperationName(mOperation) << "\""
+			<< ", \"size\": " << mSize
+			<< ", \"count\": " << mCount;
+
+		if (!mSkipReason.empty()) {
+			json << ", \"skipped\": \"" << mSkipReason << "\" }";
+			return json.str();
+		}
+
+		json << ", \"seconds\": " << mSeconds
+			<< ", \"mbPerSecond\": ";
+		if (mOperation == UploadOperation::SetImageLayout) {
+			json << "null";
+		}
+		else {
+			json << mMegabytesPerSecond;
+		}
+
+		json << ", \"callsPerSecond\": " << mCallsPerSecond
+			<< ", \"latencyUs\": " << mLatencyUs.toJson()
+			<< ", \"allocateMemoryCalls\": " << mAllocateMemoryCalls
+			<< " }";
+
+		return json.str();
+	}
+
+	std::string UploadBenchResult::toJson() const {
+		std::ostringstream json;
+
+		json << "{\n";
+		json << "  \"device\": { \"name\": \"" << mDeviceName << "\", \"type\": \"" << mDeviceType
+			<< "\", \"apiVersion\": \"" << VK_VERSION_MAJOR(mApiVersion) << "." << VK_VERSION_MINOR(mApiVersion) << "." << VK_VERSION_PATCH(mApiVersion) << "\" },\n";
+		json << "  \"config\": " << mConfig.toJson() << ",\n";
+		json << "  \"cases\": [\n";
+		for (size_t i = 0; i < mCases.size(); ++i) {
+			json << "    " << mCases[i].toJson() << (i + 1 < mCases.size() ? ",\n" : "\n");
+		}
+		json << "  ]\n";
+		json << "}\n";
+
+		return json.str();
+	}
+
+	UploadBenchmark::UploadBenchmark(const UploadBenchConfig& config) {
+		mConfig = config;
+
+		mInstance = Wrapper::Instance::create(mConfig.mValidation, true);
+		mDevice = Wrapper::Device::create(mInstance, nullptr);
+		mCommandPool = Wrapper::CommandPool::create(mDevice);
+		mUploadBatch = Wrapper::UploadBatch::create(mDevice);
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+		mMaxImageDimension = properties.limits.maxImageDimension2D;
+
+		uint64_t maxSize = *std::max_element(mConfig.mSizes.begin(), mConfig.mSizes.end());
+		mPayload.resize(static_cast<size_t>(maxSize));
+		for (size_t i = 0; i < mPayload.size(); ++i) {
+			mPayload[i] = static_cast<char>(i * 31);
+		}
+	}
+
+	UploadBenchmark::~UploadBenchmark() {
+		vkDeviceWaitIdle(mDevice->getDevice());
+	}
+
+	uint32_t UploadBenchmark::getImageSide(uint64_t size) {
+		return static_cast<uint32_t>(std::sqrt(static_cast<double>(size / 4)));
+	}
+
+	Wrapper::Image::Ptr UploadBenchmark::createImage(uint32_t side) {
+		auto image = Wrapper::Image::create(
+			mDevice,
+			static_cast<int>(side), static_cast<int>(side),
+			VK_FORMAT_R8G8B8A8_UNORM,
+			VK_IMAGE_TYPE_2D,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_SAMPLE_COUNT_1_BIT,
+			Wrapper::MemoryUsage::GpuOnly,
+			VK_IMAGE_ASPECT_COLOR_BIT
+		);
+
+		VkImageSubresourceRange region{};
+		region.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.baseArrayLayer = 0;
+		region.layerCount = 1;
+		region.baseMipLevel = 0;
+		region.levelCount = 1;
+
+		image->setImageLayout(
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			region,
+			mCommandPool
+		);
+
+		return image;
+	}
+
+	UploadCaseResult UploadBenchmark::runCase(UploadOperation operation, uint64_t size, uint32_t count) {
+		UploadCaseResult result{};
+		result.mOperation = operation;
+		result.mSize = size;
+		result.mCount = count;
+
+		bool isImage = operation == UploadOperation::FillImage || operation == UploadOperation::SetImageLayout;
+		if (isImage) {
+			uint32_t side = getImageSide(size);
+			if (side > mMaxImageDimension) {
+				result.mSkipReason = "image side exceeds maxImageDimension2D";
+				return result;
+			}
+			result.mSize = static_cast<uint64_t>(side) * side * 4;
+		}
+
+		//layout transitions move no data, so only their call count is bounded
+		if (operation != UploadOperation::SetImageLayout && result.mSize * count > mConfig.mMaxCaseBytes) {
+			result.mSkipReason = "exceeds max case bytes";
+			return result;
+		}
+
+		void* payload = mPayload.data();
+		size_t payloadSize = static_cast<size_t>(result.mSize);
+
+		Wrapper::Buffer::Ptr buffer{ nullptr };
+		Wrapper::Image::Ptr image{ nullptr };
+
+		//layout the next setImageLayout call transitions to
+		VkImageLayout nextLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkImageSubresourceRange region{};
+		region.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.layerCount = 1;
+		region.levelCount = 1;
+
+		switch (operation) {
+		case UploadOperation::Map:
+		case UploadOperation::MapPersistent:
+			buffer = Wrapper::Buffer::create(mDevice, result.mSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, Wrapper::MemoryUsage::CpuToGpu);
+			if (operation == UploadOperation::MapPersistent) {
+				buffer->mapPersistently();
+			}
+			break;
+		case UploadOperation::Stage:
+			buffer = Wrapper::Buffer::create(mDevice, result.mSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, Wrapper::MemoryUsage::GpuOnly);
+			break;
+		default:
+			image = createImage(getImageSide(size));
+			break;
+		}
+
+		auto call = [&]() {
+			switch (operation) {
+			case UploadOperation::Map:
+			case UploadOperation::MapPersistent:
+				buffer->updateBufferByMap(payload, payloadSize);
+				break;
+			case UploadOperation::Stage:
+				buffer->updateBufferByStage(*mUploadBatch, payload, payloadSize);
+				mUploadBatch->wait(mUploadBatch->submit());
+				break;
+			case UploadOperation::FillImage:
+				image->fillImageData(*mUploadBatch, payloadSize, payload);
+				mUploadBatch->wait(mUploadBatch->submit());
+				break;
+			case UploadOperation::SetImageLayout: {
+				bool toShaderRead = nextLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				image->setImageLayout(
+					nextLayout,
+					toShaderRead ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+					toShaderRead ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
+					region,
+					mCommandPool
+				);
+				nextLayout = toShaderRead ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				break;
+			}
+			default:
+				break;
+			}
+		};
+
+		//untimed: the first call pays for page faults, pool creation and driver warm-up
+		call();
+
+		std::vector<double> latencies{};
+		latencies.reserve(count);
+
+		uint64_t allocateMemoryCalls = mDevice->getAllocator()->getStats().mAllocateMemoryCalls;
+		auto start = std::chrono::steady_clock::now();
+
+		for (uint32_t i = 0; i < count; ++i) {
+			auto callStart = std::chrono::steady_clock::now();
+			call();
+			latencies.push_back(toMicroseconds(std::chrono::steady_clock::now() - callStart));
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		//all paths are synchronous, so the wall time of the loop covers the copies themselves
+		result.mAllocateMemoryCalls = mDevice->getAllocator()->getStats().mAllocateMemoryCalls - allocateMemoryCalls;
+		result.mSeconds = std::chrono::duration<double>(end - start).count();
+		if (result.mSeconds > 0.0) {
+			result.mMegabytesPerSecond = static_cast<double>(result.mSize) * count / result.mSeconds / 1.0e6;
+			result.mCallsPerSecond = count / result.mSeconds;
+		}
+		result.mLatencyUs = SampleStats::fromSamples(std::move(latencies));
+
+		return result;
+	}
+
+	UploadBenchResult UploadBenchmark::run() {
+		UploadBenchResult result{};
+		result.mConfig = mConfig;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+		result.mDeviceName = properties.deviceName;
+		result.mDeviceType = getDeviceTypeName(properties.deviceType);
+		result.mApiVersion = properties.apiVersion;
+
+		for (auto operation : mConfig.mOperations) {
+			for (auto size : mConfig.mSizes) {
+				for (auto count : mConfig.mCounts) {
+					//an out of memory error on the biggest sizes must not lose the cases that did run
+					try {
+						result.mCases.push_back(runCase(operation, size, count));
+					}
+					catch (const std::exception& e) {
+						UploadCaseResult failed{};
+						failed.mOperation = operation;
+						failed.mSize = size;
+						failed.mCount = count;
+						failed.mSkipReason = e.what();
+						result.mCases.push_back(failed);
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../base.h"
+#include "../vulkanWrapper/instance.h"
+#include "../vulkanWrapper/device.h"
+#include "../vulkanWrapper/commandPool.h"
+#include "../vulkanWrapper/buffer.h"
+#include "../vulkanWrapper/image.h"
+#include "../vulkanWrapper/uploadBatch.h"
+#include "benchCommon.h"
+#include "benchConfig.h"
+
+namespace Tea::Bench {
+	//one operation x payload size x call count
+	struct UploadCaseResult {
+		UploadOperation	mOperation{ UploadOperation::Map };
+		uint64_t		mSize{ 0 };			//payload per call, for images the largest square RGBA8 image that fits the requested size
+		uint32_t		mCount{ 0 };
+
+		//empty if the case ran
+		std::string		mSkipReason{};
+
+		double			mSeconds{ 0.0 };
+		double			mMegabytesPerSecond{ 0.0 };	//10^6 bytes, 0 for setImageLayout which moves no data
+		double			mCallsPerSecond{ 0.0 };
+		SampleStats		mLatencyUs{};
+
+		//vkAllocateMemory calls during the timed calls, the destination itself is created beforehand
+		uint64_t		mAllocateMemoryCalls{ 0 };
+
+		[[nodiscard]] std::string toJson() const;
+	};
+
+	struct UploadBenchResult {
+		std::string		mDeviceName{};
+		std::string		mDeviceType{};
+		uint32_t		mApiVersion{ 0 };
+
+		UploadBenchConfig mConfig{};
+
+		std::vector<UploadCaseResult> mCases{};
+
+		[[nodiscard]] std::string toJson() const;
+	};
+
+	//Times the upload paths of Buffer and Image on a headless device. Every case creates its destination once,
+	//makes one untimed call to fault in memory and pipelines, then times mCount calls one by one.
+	class UploadBenchmark {
+	public:
+		using Ptr = std::shared_ptr<UploadBenchmark>;
+		static Ptr create(const UploadBenchConfig& config) { return std::make_shared<UploadBenchmark>(config); }
+
+		explicit UploadBenchmark(const UploadBenchConfig& config);
+
+		~UploadBenchmark();
+
+		UploadBenchResult run();
+
+	private:
+		UploadCaseResult runCase(UploadOperation operation, uint64_t size, uint32_t count);
+
+		//side of the square RGBA8 image used for a payload of size bytes
+		static uint32_t getImageSide(uint64_t size);
+
+		Wrapper::Image::Ptr createImage(uint32_t side);
+
+		UploadBenchConfig mConfig{};
+
+		Wrapper::Instance::Ptr mInstance{ nullptr };
+		Wrapper::Device::Ptr mDevice{ nullptr };
+		Wrapper::CommandPool::Ptr mCommandPool{ nullptr };
+
+		//staged uploads record into this one batch, each call submits and waits
+		Wrapper::UploadBatch::Ptr mUploadBatch{ nullptr };
+
+		uint32_t mMaxImageDimension{ 0 };
+
+		//source data of every call, as big as the largest size
+		std::vector<char> mPayload{};
+	};
+}
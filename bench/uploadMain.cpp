@@ -0,0 +1,33 @@
+#include "../base.h"
+#include "benchConfig.h"
+#include "uploadBenchmark.h"
+
+//tea_upload_bench: times Buffer and Image upload paths headlessly and prints (or writes with --output) a JSON report.
+int main(int argc, char** argv) {
+	try {
+		auto config = Tea::Bench::UploadBenchConfig::parse(argc, argv);
+
+		std::string json{};
+		{
+			auto benchmark = Tea::Bench::UploadBenchmark::create(config);
+			json = benchmark->run().toJson();
+		}
+
+		if (config.mOutputPath.empty()) {
+			std::cout << json;
+		}
+		else {
+			std::ofstream file(config.mOutputPath, std::ios::out | std::ios::trunc);
+			if (!file) {
+				throw std::runtime_error("Error: failed to open " + config.mOutputPath);
+			}
+			file << json;
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -1,15 +1,55 @@
 #include <iostream>
+#include <cctype>
 #include "application.h"
 
 
-int main() {
-	Tea::Application app;
+int main(int argc, char** argv) {
+	//tea --headless [frameCount]: render offscreen without a window, e.g. on CI with lavapipe
+	//tea --resize-bench [count]: resize the window count times and report the swapchain recreation latency
+	//tea --vertex-color: use the vertex colored fragment shader variant instead of the textured one
+	//tea --validation / --no-validation: enable or disable the validation layers, by default only windowed runs use them
+	bool headless = false;
+	uint32_t headlessFrameCount = 1000;
+	uint32_t resizeBenchCount = 0;
+	bool useTexture = true;
+	std::optional<bool> validation{};
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--headless") == 0) {
+			headless = true;
+
+			if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+				headlessFrameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			}
+		}
+		else if (std::strcmp(argv[i], "--resize-bench") == 0) {
+			resizeBenchCount = 100;
+
+			if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+				resizeBenchCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			}
+		}
+		else if (std::strcmp(argv[i], "--vertex-color") == 0) {
+			useTexture = false;
+		}
+		else if (std::strcmp(argv[i], "--validation") == 0) {
+			validation = true;
+		}
+		else if (std::strcmp(argv[i], "--no-validation") == 0) {
+			validation = false;
+		}
+	}
+
+	Tea::Application app(headless, headlessFrameCount, resizeBenchCount);
+	app.setUseTexture(useTexture);
+	app.setValidation(validation.value_or(!headless));
 
 	try {
 		app.run();
 	}
 	catch (const std::exception& e) {
 		std::cout << e.what() << std::endl;
+		return 1;
 	}
 
 	return 0;
@@ -2,6 +2,7 @@
 #include "base.h"
 #include "vulkanWrapper/device.h"
 #include "vulkanWrapper/buffer.h"
+#include "vulkanWrapper/uploadBatch.h"
 
 namespace Tea{
     struct Vertex{
@@ -61,13 +62,18 @@ namespace Tea{
 
             //mVertexBuffer = Wrapper::Buffer::createVertexBuffer(device, mDatas.size() * sizeof(Vertex), mDatas.data());
 
-            mPositionBuffer = Wrapper::Buffer::createVertexBuffer(device, mPositions.size() * sizeof(float), mPositions.data());
+            //all buffers of the model are uploaded with one submission
+            auto uploadBatch = Wrapper::UploadBatch::create(device);
 
-            mColorBuffer = Wrapper::Buffer::createVertexBuffer(device, mColors.size() * sizeof(float), mColors.data());
+            mPositionBuffer = Wrapper::Buffer::createVertexBuffer(device, mPositions.size() * sizeof(float), mPositions.data(), *uploadBatch);
 
-            mUVBuffer = Wrapper::Buffer::createVertexBuffer(device, mUVs.size() * sizeof(float), mUVs.data());
+            mColorBuffer = Wrapper::Buffer::createVertexBuffer(device, mColors.size() * sizeof(float), mColors.data(), *uploadBatch);
 
-            mIndexBuffer = Wrapper::Buffer::createIndexBuffer(device, mIndexDatas.size() * sizeof(float), mIndexDatas.data());
+            mUVBuffer = Wrapper::Buffer::createVertexBuffer(device, mUVs.size() * sizeof(float), mUVs.data(), *uploadBatch);
+
+            mIndexBuffer = Wrapper::Buffer::createIndexBuffer(device, mIndexDatas.size() * sizeof(float), mIndexDatas.data(), *uploadBatch);
+
+            uploadBatch->wait(uploadBatch->submit());
         }
 
         ~Model() {}
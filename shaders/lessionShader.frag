@@ -9,7 +9,14 @@ layout(location = 0) out vec4 outColor;
 
 layout(binding = 2) uniform sampler2D texSampler;
 
+//set per pipeline (Wrapper::SpecializationConstants), the unused branch is compiled away
+layout(constant_id = 0) const bool USE_TEXTURE = true;
+
 void main() {
-	//outColor = vec4(inColor, 1.0);
-	outColor = texture(texSampler, inUV);
+	if (USE_TEXTURE) {
+		outColor = texture(texSampler, inUV);
+	}
+	else {
+		outColor = vec4(inColor, 1.0);
+	}
 }
\ No newline at end of file
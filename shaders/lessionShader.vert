@@ -14,9 +14,10 @@ layout(binding = 0) uniform VPMatrices {
 	mat4 mProjectionMatrix;
 }vpUBO;
 
-layout(binding = 1) uniform ObjectUniform {
+//per draw data, pushed with the draw instead of written to a uniform buffer
+layout(push_constant) uniform ObjectUniform {
 	mat4 mModelMatrix;
-}objectUBO;
+}object;
 
 //vec2 positions[3] = vec2[](vec2(0.0, -1.0), vec2(0.5, 0.0), vec2(-0.5, 0.0));
 
@@ -24,7 +25,7 @@ layout(binding = 1) uniform ObjectUniform {
 
 void main() {
 	//gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-	gl_Position = vpUBO.mProjectionMatrix * vpUBO.mViewMatrix * objectUBO.mModelMatrix * vec4(inPosition, 1.0);
+	gl_Position = vpUBO.mProjectionMatrix * vpUBO.mViewMatrix * object.mModelMatrix * vec4(inPosition, 1.0);
 
 	outColor = inColor;
 	outUV = inUV;
@@ -0,0 +1,373 @@
+#include "../vulkanWrapper/shaderReflection.h"
+
+//ShaderReflection against modules declaring what shaders/lessionShader.vert and .frag declare, against the compiled
+//shaders/vs.spv and fs.spv when they exist, and against damaged input. Exits with 1 if any check failed.
+
+using namespace Tea::Wrapper;
+
+namespace {
+	uint32_t gFailures = 0;
+
+	void check(bool condition, const std::string& message) {
+		if (!condition) {
+			std::cerr << "FAILED: " << message << std::endl;
+			gFailures++;
+		}
+	}
+
+	//assembles SPIR-V instruction by instruction, remembering where each one ends
+	class SpirvWriter {
+	public:
+		SpirvWriter() {
+			//magic, version 1.0, generator, id bound, schema
+			mWords = { 0x07230203, 0x00010000, 0, 64, 0 };
+		}
+
+		void op(uint16_t opcode, const std::vector<uint32_t>& operands) {
+			mWords.push_back((static_cast<uint32_t>(operands.size() + 1) << 16) | opcode);
+			mWords.insert(mWords.end(), operands.begin(), operands.end());
+			mBoundaries.insert(mWords.size());
+		}
+
+		//operands before the string, the string (nul terminated, padded to words), operands after it
+		void op(uint16_t opcode, const std::vector<uint32_t>& before, const std::string& text, const std::vector<uint32_t>& after = {}) {
+			std::vector<uint32_t> operands = before;
+
+			std::vector<uint32_t> words((text.size() + 4) / 4, 0);
+			std::memcpy(words.data(), text.data(), text.size());
+			operands.insert(operands.end(), words.begin(), words.end());
+			operands.insert(operands.end(), after.begin(), after.end());
+
+			op(opcode, operands);
+		}
+
+		[[nodiscard]] const auto& getWords() const { return mWords; }
+
+		[[nodiscard]] bool isBoundary(size_t wordCount) const { return wordCount == 5 || mBoundaries.count(wordCount) != 0; }
+
+	private:
+		std::vector<uint32_t> mWords{};
+		std::set<size_t> mBoundaries{};
+	};
+
+	enum : uint16_t {
+		OpName = 5, OpEntryPoint = 15, OpTypeBool = 20, OpTypeInt = 21, OpTypeFloat = 22, OpTypeVector = 23, OpTypeMatrix = 24,
+		OpTypeImage = 25, OpTypeSampledImage = 27, OpTypeRuntimeArray = 29, OpTypeStruct = 30, OpTypePointer = 32,
+		OpSpecConstantTrue = 48, OpVariable = 59, OpDecorate = 71, OpMemberDecorate = 72,
+	};
+
+	enum : uint32_t {
+		DecorationSpecId = 1, DecorationBlock = 2, DecorationColMajor = 5, DecorationMatrixStride = 7, DecorationBuiltIn = 11,
+		DecorationLocation = 30, DecorationBinding = 33, DecorationDescriptorSet = 34, DecorationOffset = 35,
+	};
+
+	enum : uint32_t { StorageUniformConstant = 0, StorageInput = 1, StorageUniform = 2, StoragePushConstant = 9 };
+
+	//lessionShader.vert: VPMatrices at binding 0, ObjectUniform { mat4 } as push constant, three vertex inputs
+	SpirvWriter makeVertexModule() {
+		SpirvWriter spirv{};
+
+		spirv.op(OpEntryPoint, { 0, 1 }, "main", { 14, 15, 17, 20 });
+
+		spirv.op(OpName, { 7 }, "VPMatrices");
+		spirv.op(OpName, { 9 }, "vpUBO");
+		spirv.op(OpName, { 10 }, "ObjectUniform");
+		spirv.op(OpName, { 14 }, "inPosition");
+		spirv.op(OpName, { 15 }, "inColor");
+		spirv.op(OpName, { 17 }, "inUV");
+
+		spirv.op(OpMemberDecorate, { 7, 0, DecorationColMajor });
+		spirv.op(OpMemberDecorate, { 7, 0, DecorationOffset, 0 });
+		spirv.op(OpMemberDecorate, { 7, 0, DecorationMatrixStride, 16 });
+		spirv.op(OpMemberDecorate, { 7, 1, DecorationColMajor });
+		spirv.op(OpMemberDecorate, { 7, 1, DecorationOffset, 64 });
+		spirv.op(OpMemberDecorate, { 7, 1, DecorationMatrixStride, 16 });
+		spirv.op(OpDecorate, { 7, DecorationBlock });
+		spirv.op(OpDecorate, { 9, DecorationDescriptorSet, 0 });
+		spirv.op(OpDecorate, { 9, DecorationBinding, 0 });
+		spirv.op(OpMemberDecorate, { 10, 0, DecorationColMajor });
+		spirv.op(OpMemberDecorate, { 10, 0, DecorationOffset, 0 });
+		spirv.op(OpMemberDecorate, { 10, 0, DecorationMatrixStride, 16 });
+		spirv.op(OpDecorate, { 10, DecorationBlock });
+		spirv.op(OpDecorate, { 14, DecorationLocation, 0 });
+		spirv.op(OpDecorate, { 15, DecorationLocation, 1 });
+		spirv.op(OpDecorate, { 17, DecorationLocation, 2 });
+		spirv.op(OpDecorate, { 20, DecorationBuiltIn, 42 });
+
+		spirv.op(OpTypeFloat, { 2, 32 });
+		spirv.op(OpTypeVector, { 3, 2, 3 });
+		spirv.op(OpTypeVector, { 4, 2, 2 });
+		spirv.op(OpTypeVector, { 5, 2, 4 });
+		spirv.op(OpTypeMatrix, { 6, 5, 4 });
+		spirv.op(OpTypeStruct, { 7, 6, 6 });
+		spirv.op(OpTypePointer, { 8, StorageUniform, 7 });
+		spirv.op(OpVariable, { 8, 9, StorageUniform });
+		spirv.op(OpTypeStruct, { 10, 6 });
+		spirv.op(OpTypePointer, { 11, StoragePushConstant, 10 });
+		spirv.op(OpVariable, { 11, 12, StoragePushConstant });
+		spirv.op(OpTypePointer, { 13, StorageInput, 3 });
+		spirv.op(OpVariable, { 13, 14, StorageInput });
+		spirv.op(OpVariable, { 13, 15, StorageInput });
+		spirv.op(OpTypePointer, { 16, StorageInput, 4 });
+		spirv.op(OpVariable, { 16, 17, StorageInput });
+		spirv.op(OpTypeInt, { 18, 32, 1 });
+		spirv.op(OpTypePointer, { 19, StorageInput, 18 });
+		spirv.op(OpVariable, { 19, 20, StorageInput });
+
+		return spirv;
+	}
+
+	//lessionShader.frag: the texture sampler at binding 2 and the USE_TEXTURE specialization constant
+	SpirvWriter makeFragmentModule() {
+		SpirvWriter spirv{};
+
+		spirv.op(OpEntryPoint, { 4, 1 }, "main", { 14 });
+
+		spirv.op(OpName, { 9 }, "texSampler");
+
+		spirv.op(OpDecorate, { 9, DecorationDescriptorSet, 0 });
+		spirv.op(OpDecorate, { 9, DecorationBinding, 2 });
+		spirv.op(OpDecorate, { 11, DecorationSpecId, 0 });
+		spirv.op(OpDecorate, { 14, DecorationLocation, 0 });
+
+		spirv.op(OpTypeFloat, { 2, 32 });
+		spirv.op(OpTypeImage, { 6, 2, 1, 0, 0, 0, 1, 0 });
+		spirv.op(OpTypeSampledImage, { 7, 6 });
+		spirv.op(OpTypePointer, { 8, StorageUniformConstant, 7 });
+		spirv.op(OpVariable, { 8, 9, StorageUniformConstant });
+		spirv.op(OpTypeBool, { 10 });
+		spirv.op(OpSpecConstantTrue, { 10, 11 });
+		spirv.op(OpTypeVector, { 12, 2, 3 });
+		spirv.op(OpTypePointer, { 13, StorageInput, 12 });
+		spirv.op(OpVariable, { 13, 14, StorageInput });
+
+		return spirv;
+	}
+
+	ShaderReflection reflect(const std::vector<uint32_t>& words) {
+		return ShaderReflection::reflect(words.data(), words.size());
+	}
+
+	bool throws(const std::vector<uint32_t>& words) {
+		try {
+			reflect(words);
+		}
+		catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	//empty if the file does not exist, the shaders are compiled by shaders/compile.bat
+	std::vector<uint32_t> readSpirv(const std::string& fileName) {
+		std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+		if (!file) {
+			return {};
+		}
+
+		std::vector<uint32_t> words(static_cast<size_t>(file.tellg()) / sizeof(uint32_t));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+		return words;
+	}
+
+	void checkVertex(const ShaderReflection& vertex, const std::string& source) {
+		check(vertex.getStages() == VK_SHADER_STAGE_VERTEX_BIT, source + ": vertex stage");
+
+		const auto& bindings = vertex.getBindings();
+		check(bindings.size() == 1, source + ": one binding, the model matrix is no uniform buffer");
+		if (!bindings.empty()) {
+			check(bindings[0].mSet == 0 && bindings[0].mBinding == 0, source + ": VPMatrices at set 0 binding 0");
+			check(bindings[0].mType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, source + ": VPMatrices is a uniform buffer");
+			check(bindings[0].mCount == 1, source + ": VPMatrices is no array");
+		}
+
+		const auto& ranges = vertex.getPushConstantRanges();
+		check(ranges.size() == 1, source + ": one push constant range");
+		if (!ranges.empty()) {
+			check(ranges[0].stageFlags == VK_SHADER_STAGE_VERTEX_BIT, source + ": push constants in the vertex stage");
+			check(ranges[0].offset == 0 && ranges[0].size == 64, source + ": push constant range holds one mat4");
+		}
+
+		const auto& inputs = vertex.getVertexInputs();
+		check(inputs.size() == 3, source + ": three vertex inputs, built-ins left out");
+		if (inputs.size() == 3) {
+			check(inputs[0].mLocation == 0 && inputs[0].mFormat == VK_FORMAT_R32G32B32_SFLOAT, source + ": inPosition");
+			check(inputs[1].mLocation == 1 && inputs[1].mFormat == VK_FORMAT_R32G32B32_SFLOAT, source + ": inColor");
+			check(inputs[2].mLocation == 2 && inputs[2].mFormat == VK_FORMAT_R32G32_SFLOAT, source + ": inUV");
+		}
+	}
+
+	void checkFragment(const ShaderReflection& fragment, const std::string& source) {
+		check(fragment.getStages() == VK_SHADER_STAGE_FRAGMENT_BIT, source + ": fragment stage");
+		check(fragment.getVertexInputs().empty(), source + ": fragment inputs are no vertex inputs");
+		check(fragment.getPushConstantRanges().empty(), source + ": no push constants");
+
+		const auto& bindings = fragment.getBindings();
+		check(bindings.size() == 1, source + ": one binding");
+		if (!bindings.empty()) {
+			check(bindings[0].mSet == 0 && bindings[0].mBinding == 2, source + ": sampler at set 0 binding 2");
+			check(bindings[0].mType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, source + ": combined image sampler");
+		}
+	}
+
+	//the layout the application builds with ReflectedLayout, { 0, 0 } bound with a dynamic offset
+	void checkMerged(const ShaderReflection& vertex, const ShaderReflection& fragment, const std::string& source) {
+		auto merged = ShaderReflection::merge({ vertex, fragment });
+		check(merged.getStages() == (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT), source + ": merged stages");
+		check(merged.getVertexInputs().size() == 3, source + ": merged keeps the vertex inputs");
+
+		auto sets = merged.getSetLayoutBindings({ { 0, 0 } });
+		check(sets.size() == 1 && sets[0].size() == 2, source + ": one set with two bindings");
+		if (sets.size() == 1 && sets[0].size() == 2) {
+			check(sets[0][0].binding == 0 && sets[0][0].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, source + ": binding 0 is a dynamic uniform buffer");
+			check(sets[0][0].stageFlags == VK_SHADER_STAGE_VERTEX_BIT, source + ": binding 0 used by the vertex stage");
+			check(sets[0][1].binding == 2 && sets[0][1].descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, source + ": binding 2 is a sampler");
+			check(sets[0][1].stageFlags == VK_SHADER_STAGE_FRAGMENT_BIT, source + ": binding 2 used by the fragment stage");
+		}
+
+		bool samplerRejected = false;
+		try {
+			static_cast<void>(merged.getSetLayoutBindings({ { 0, 2 } }));
+		}
+		catch (const std::runtime_error&) {
+			samplerRejected = true;
+		}
+		check(samplerRejected, source + ": a sampler can not be dynamic");
+	}
+
+	void testRepoShaders() {
+		auto vertex = reflect(makeVertexModule().getWords());
+		auto fragment = reflect(makeFragmentModule().getWords());
+
+		checkVertex(vertex, "assembled vertex module");
+		checkFragment(fragment, "assembled fragment module");
+		checkMerged(vertex, fragment, "assembled modules");
+
+		auto vertexCode = readSpirv("shaders/vs.spv");
+		auto fragmentCode = readSpirv("shaders/fs.spv");
+		if (vertexCode.empty() || fragmentCode.empty()) {
+			std::cout << "shaders/vs.spv or fs.spv not compiled, only the assembled modules were checked" << std::endl;
+			return;
+		}
+
+		try {
+			auto compiledVertex = reflect(vertexCode);
+			auto compiledFragment = reflect(fragmentCode);
+
+			checkVertex(compiledVertex, "vs.spv");
+			checkFragment(compiledFragment, "fs.spv");
+			checkMerged(compiledVertex, compiledFragment, "vs.spv + fs.spv");
+		}
+		catch (const std::exception& e) {
+			check(false, std::string("compiled shaders: ") + e.what());
+		}
+	}
+
+	void testDamagedInput() {
+		check(throws({}), "empty code");
+		check(throws({ 0x07230203, 0x00010000, 0 }), "header only partly there");
+		check(throws({ 0x03022307, 0x00010000, 0, 64, 0 }), "wrong magic");
+		check(throws({ 0x07230203, 0x00010000, 0, 64, 0 }), "header without entry point");
+
+		bool nullRejected = false;
+		try {
+			ShaderReflection::reflect(nullptr, 5);
+		}
+		catch (const std::runtime_error&) {
+			nullRejected = true;
+		}
+		check(nullRejected, "null code");
+
+		auto module = makeVertexModule();
+		const auto& words = module.getWords();
+
+		//every prefix: cut inside an instruction has to be detected, a cut between instructions may still reflect
+		//(if nothing it needs is missing) but must never fail other than with runtime_error
+		for (size_t count = 0; count < words.size(); ++count) {
+			std::vector<uint32_t> prefix(words.begin(), words.begin() + count);
+			try {
+				reflect(prefix);
+				check(module.isBoundary(count), "truncated after " + std::to_string(count) + " words inside an instruction");
+			}
+			catch (const std::runtime_error&) {
+			}
+			catch (const std::exception& e) {
+				check(false, "truncated after " + std::to_string(count) + " words: unexpected " + e.what());
+			}
+		}
+
+		//an instruction claiming zero words would never advance
+		auto zeroLength = words;
+		zeroLength[5] = OpName;
+		check(throws(zeroLength), "instruction of length 0");
+
+		//an instruction claiming more words than the module has
+		auto overlong = words;
+		overlong.push_back((4u << 16) | OpVariable);
+		overlong.push_back(8);
+		check(throws(overlong), "instruction longer than the module");
+
+		//a variable whose pointer type was never declared
+		SpirvWriter missingPointer{};
+		missingPointer.op(OpEntryPoint, { 0, 1 }, "main");
+		missingPointer.op(OpVariable, { 8, 9, StorageUniform });
+		check(throws(missingPointer.getWords()), "variable without pointer type");
+
+		//unsized descriptor arrays are not supported
+		SpirvWriter runtimeArray{};
+		runtimeArray.op(OpEntryPoint, { 4, 1 }, "main");
+		runtimeArray.op(OpDecorate, { 9, DecorationBinding, 0 });
+		runtimeArray.op(OpTypeFloat, { 2, 32 });
+		runtimeArray.op(OpTypeImage, { 6, 2, 1, 0, 0, 0, 1, 0 });
+		runtimeArray.op(OpTypeSampledImage, { 7, 6 });
+		runtimeArray.op(OpTypeRuntimeArray, { 3, 7 });
+		runtimeArray.op(OpTypePointer, { 8, StorageUniformConstant, 3 });
+		runtimeArray.op(OpVariable, { 8, 9, StorageUniformConstant });
+		check(throws(runtimeArray.getWords()), "unsized descriptor array");
+
+		//a vertex input that is no 32 bit scalar or vector
+		SpirvWriter matrixInput{};
+		matrixInput.op(OpEntryPoint, { 0, 1 }, "main", { 9 });
+		matrixInput.op(OpDecorate, { 9, DecorationLocation, 0 });
+		matrixInput.op(OpTypeFloat, { 2, 32 });
+		matrixInput.op(OpTypeVector, { 5, 2, 4 });
+		matrixInput.op(OpTypeMatrix, { 6, 5, 4 });
+		matrixInput.op(OpTypePointer, { 8, StorageInput, 6 });
+		matrixInput.op(OpVariable, { 8, 9, StorageInput });
+		check(throws(matrixInput.getWords()), "matrix vertex input");
+
+		//stages disagreeing on a binding
+		auto vertex = reflect(makeVertexModule().getWords());
+		SpirvWriter conflicting{};
+		conflicting.op(OpEntryPoint, { 4, 1 }, "main");
+		conflicting.op(OpDecorate, { 9, DecorationBinding, 0 });
+		conflicting.op(OpTypeFloat, { 2, 32 });
+		conflicting.op(OpTypeImage, { 6, 2, 1, 0, 0, 0, 1, 0 });
+		conflicting.op(OpTypeSampledImage, { 7, 6 });
+		conflicting.op(OpTypePointer, { 8, StorageUniformConstant, 7 });
+		conflicting.op(OpVariable, { 8, 9, StorageUniformConstant });
+
+		bool conflictRejected = false;
+		try {
+			ShaderReflection::merge({ vertex, reflect(conflicting.getWords()) });
+		}
+		catch (const std::runtime_error&) {
+			conflictRejected = true;
+		}
+		check(conflictRejected, "stages disagreeing on binding 0");
+	}
+}
+
+int main() {
+	testRepoShaders();
+	testDamagedInput();
+
+	if (gFailures != 0) {
+		std::cerr << gFailures << " shader reflection checks failed" << std::endl;
+		return 1;
+	}
+
+	std::cout << "shader reflection checks passed" << std::endl;
+	return 0;
+}
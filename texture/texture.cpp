@@ -4,11 +4,12 @@ namespace Tea {
 	Texture::Texture(
 		const Wrapper::Device::Ptr& device, 
 		const Wrapper::CommandPool::Ptr& commandPool, 
+		Wrapper::UploadBatch& uploadBatch,
 		const std::string& imageFilePath) 
 	{
 		mDevice = device;
 
-		int texWidth, texHeight, texSize, texChannles;
+		int texWidth, texHeight, texChannles;
 		stbi_uc* pixels = stbi_load(imageFilePath.c_str(), &texWidth, &texHeight, &texChannles, STBI_rgb_alpha);
 		
 
@@ -16,8 +17,28 @@ namespace Tea {
 			throw std::runtime_error("Error: failed to read image data");
 		}
 
+		//the batch copies the pixels into its staging memory right away
+		createImage(commandPool, uploadBatch, texWidth, texHeight, pixels);
+
+		stbi_image_free(pixels);
+	}
+
+	Texture::Texture(
+		const Wrapper::Device::Ptr& device,
+		const Wrapper::CommandPool::Ptr& commandPool,
+		Wrapper::UploadBatch& uploadBatch,
+		int width,
+		int height,
+		const void* pixels)
+	{
+		mDevice = device;
+
+		createImage(commandPool, uploadBatch, width, height, pixels);
+	}
+
+	void Texture::createImage(const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, int texWidth, int texHeight, const void* pixels) {
 		//The pixels are laid out row by row with 4 bytes per pixel in the case of STBI_rgb_alpha for a total of texWidth * texHeight * 4 values
-		texSize = texWidth * texHeight * 4;
+		size_t texSize = static_cast<size_t>(texWidth) * texHeight * 4;
 
 		mImage = Wrapper::Image::create(
 			mDevice, texWidth, texHeight,
@@ -53,9 +74,7 @@ namespace Tea {
 		// We'll start by creating a staging resource 
 		// and filling it with pixel data 
 		// and then we copy this to the final image object that we'll use for rendering. 
-		mImage->fillImageData(texSize, (void*)pixels, commandPool);
-
-		stbi_image_free(pixels);
+		mImage->fillImageData(uploadBatch, texSize, const_cast<void*>(pixels));
 
 		mSampler = Wrapper::Sampler::create(mDevice);
 
@@ -5,6 +5,7 @@
 #include "../vulkanWrapper/sampler.h"
 #include "../vulkanWrapper/device.h"
 #include "../vulkanWrapper/commandPool.h"
+#include "../vulkanWrapper/uploadBatch.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../stb_image.h"
@@ -15,19 +16,29 @@ namespace Tea {
 	//staging image or buffer,  Vulkan also allows you to copy pixels from a VkBuffer to an image and the API for this is actually faster on some hardware
 	//Although we could set up the shader to access the pixel values in the buffer
 	//it's better to use image objects in Vulkan for this purpose. Image objects will make it easier and faster to retrieve colors by allowing us to use 2D coordinates, for one. 
+	//The pixels are recorded into uploadBatch, the texture may be sampled once the batch's ticket has completed
 	class Texture {
 	public:
 		using Ptr = std::shared_ptr<Texture>;
-		static Ptr create(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, const std::string& imageFilePath) {
-			return std::make_shared<Texture>(device, commandPool, imageFilePath);
+		static Ptr create(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, const std::string& imageFilePath) {
+			return std::make_shared<Texture>(device, commandPool, uploadBatch, imageFilePath);
 		}
 
-		Texture(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, const std::string& imageFilePath);
+		//width * height tightly packed RGBA8 pixels, e.g. generated textures
+		static Ptr create(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, int width, int height, const void* pixels) {
+			return std::make_shared<Texture>(device, commandPool, uploadBatch, width, height, pixels);
+		}
+
+		Texture(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, const std::string& imageFilePath);
+
+		Texture(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, int width, int height, const void* pixels);
 
 		~Texture();
 
 		[[nodiscard]] auto getImageInfo() { return mImageInfo; }
 	private:
+		void createImage(const Wrapper::CommandPool::Ptr& commandPool, Wrapper::UploadBatch& uploadBatch, int texWidth, int texHeight, const void* pixels);
+
 		Wrapper::Device::Ptr mDevice{ nullptr };
 		Wrapper::Image::Ptr mImage{ nullptr };
 		Wrapper::Sampler::Ptr mSampler{ nullptr };
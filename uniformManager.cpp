@@ -9,48 +9,49 @@ namespace Tea {
 
 	}
 
-	void UniformManager::init(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, int frameCount) {
+	void UniformManager::init(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, int frameCount, const Wrapper::DescriptorSetLayout::Ptr& layout) {
 		mDevice = device;
 
+		//the view/projection is pushed into a ring buffer each frame, binding 0 is dynamic so the set is written once.
+		//binding 1 is free: the model matrix comes in as a push constant
+		mRingAllocator = Wrapper::UniformRingAllocator::create(device, frameCount);
+
 		auto vpParam = Wrapper::UniformParameter::create();
 		vpParam->mBinding = 0;
 		vpParam->mCount = 1;
-		vpParam->mDescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		vpParam->mDescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 		vpParam->mSize = sizeof(VPMatrices);
 		vpParam->mStage = VK_SHADER_STAGE_VERTEX_BIT;
-
-		for (int i = 0; i < frameCount; ++i) {
-			auto buffer = Wrapper::Buffer::createUniformBuffer(device, vpParam->mSize, nullptr);
-			vpParam->mBuffers.push_back(buffer);
-		}
+		vpParam->mRingAllocator = mRingAllocator;
 
 		mUniformParams.push_back(vpParam);
 
-		auto objectParam = Wrapper::UniformParameter::create();
-		objectParam->mBinding = 1;
-		objectParam->mCount = 1;
-		objectParam->mDescriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		objectParam->mSize = sizeof(ObjectUniform);
-		objectParam->mStage = VK_SHADER_STAGE_VERTEX_BIT;
-
-		for (int i = 0; i < frameCount; ++i) {
-			auto buffer = Wrapper::Buffer::createUniformBuffer(device, objectParam->mSize, nullptr);
-			objectParam->mBuffers.push_back(buffer);
-		}
-
-		mUniformParams.push_back(objectParam);
-
 		auto textureParam = Wrapper::UniformParameter::create();
 		textureParam->mBinding = 2;
 		textureParam->mCount = 1;
 		textureParam->mDescriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		textureParam->mStage = VK_SHADER_STAGE_FRAGMENT_BIT;
-		textureParam->mTexture = Texture::create(mDevice, commandPool, "assets/dragonBall.jpg");
+		auto uploadBatch = Wrapper::UploadBatch::create(mDevice);
+		textureParam->mTexture = Texture::create(mDevice, commandPool, *uploadBatch, "assets/dragonBall.jpg");
+		uploadBatch->wait(uploadBatch->submit());
 
 		mUniformParams.push_back(textureParam);  
 
-		mDescriptorSetLayout = Wrapper::DescriptorSetLayout::create(device);
-		mDescriptorSetLayout->build(mUniformParams);
+		//the shaders decide the layout, the parameters only provide the resources for it
+		const auto& bindings = layout->getBindings();
+		for (const auto& param : mUniformParams) {
+			auto binding = std::find_if(bindings.begin(), bindings.end(), [&param](const VkDescriptorSetLayoutBinding& layoutBinding) {
+				return layoutBinding.binding == param->mBinding;
+			});
+
+			if (binding == bindings.end() || binding->descriptorType != param->mDescriptorType || binding->descriptorCount != param->mCount) {
+				throw std::runtime_error("Error: uniform at binding " + std::to_string(param->mBinding) + " does not match the shaders");
+			}
+		}
+		if (bindings.size() != mUniformParams.size()) {
+			throw std::runtime_error("Error: the shaders use bindings no uniform is provided for");
+		}
+		mDescriptorSetLayout = layout;
 
 		mDescriptorPool = Wrapper::DescriptorPool::create(device);
 		mDescriptorPool->build(mUniformParams, frameCount);
@@ -58,9 +59,23 @@ namespace Tea {
 		mDescriptorSet = Wrapper::DescriptorSet::create(device, mUniformParams, mDescriptorPool, mDescriptorSetLayout, frameCount);
 	}
 
-	void UniformManager::update(const VPMatrices& vpMatrices, const ObjectUniform& objectUniform, const int& frameCount) {
-		mUniformParams[0]->mBuffers[frameCount]->updateBufferByMap((void*)(&vpMatrices), sizeof(VPMatrices));
+	void UniformManager::update(const VPMatrices& vpMatrices, const int& frameCount) {
+		beginFrame(frameCount);
+
+		mDynamicOffsets = { pushViewProjection(vpMatrices) };
+
+		endFrame();
+	}
+
+	void UniformManager::beginFrame(const int& frameCount) {
+		mRingAllocator->beginFrame(static_cast<uint32_t>(frameCount));
+	}
+
+	uint32_t UniformManager::pushViewProjection(const VPMatrices& vpMatrices) {
+		return mRingAllocator->push(vpMatrices);
+	}
 
-		mUniformParams[1]->mBuffers[frameCount]->updateBufferByMap((void*)(&objectUniform), sizeof(objectUniform));
+	void UniformManager::endFrame() {
+		mRingAllocator->endFrame();
 	}
 }
\ No newline at end of file
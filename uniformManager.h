@@ -5,6 +5,8 @@
 #include "vulkanWrapper/descriptorPool.h"
 #include "vulkanWrapper/descriptorSet.h"
 #include "vulkanWrapper/description.h"
+#include "vulkanWrapper/uniformRingAllocator.h"
+#include "vulkanWrapper/reflectedLayout.h"
 #include "base.h"
 
 //Usage of descriptors consists of three parts:
@@ -23,19 +25,37 @@ namespace Tea {
 
 		~UniformManager();
 
-		void init(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, int frameCount);
+		//layout: the set the shaders declare for these uniforms (ReflectedLayout), init throws if a uniform does not match it
+		void init(const Wrapper::Device::Ptr& device, const Wrapper::CommandPool::Ptr& commandPool, int frameCount, const Wrapper::DescriptorSetLayout::Ptr& layout);
 
-		void update(const VPMatrices& vpMatrices, const ObjectUniform& objectUniform, const int& frameCount);
+		//pushes the view/projection and keeps its offset in getDynamicOffsets(). Per object data is not kept here,
+		//every draw sends its ObjectUniform with CommandBuffer::pushConstants
+		void update(const VPMatrices& vpMatrices, const int& frameCount);
+
+		//several views per frame: beginFrame, push each view/projection and bind the frame's descriptor set with
+		//{ vpOffset }, then call endFrame before submit
+		void beginFrame(const int& frameCount);
+
+		uint32_t pushViewProjection(const VPMatrices& vpMatrices);
+
+		void endFrame();
 
 		[[nodiscard]] auto getDescriptorLayout() const { return mDescriptorSetLayout->getLayout(); }
 
+		[[nodiscard]] auto getDescriptorSetLayout() const { return mDescriptorSetLayout; }
+
 		[[nodiscard]] auto getDescriptorSet(int frameCount) const { return mDescriptorSet->getDescriptorSet(frameCount); }
 
+		[[nodiscard]] const auto& getDynamicOffsets() const { return mDynamicOffsets; }
+
 	private:
 		Wrapper::Device::Ptr mDevice{ nullptr };
 
 		std::vector<Wrapper::UniformParameter::Ptr> mUniformParams{};
 
+		Wrapper::UniformRingAllocator::Ptr mRingAllocator{ nullptr };
+		std::vector<uint32_t> mDynamicOffsets{};
+
 		//descriptor layout describes the type of descriptors that can be bound. 
 		// for each VkBuffer, bind it to the uniform buffer descriptor.
 		Wrapper::DescriptorSetLayout::Ptr mDescriptorSetLayout{ nullptr };
@@ -1,33 +1,57 @@
 #include "buffer.h"
 #include "commandBuffer.h"
 #include "commandPool.h"
+#include "uploadBatch.h"
 
 namespace Tea::Wrapper {
-   Buffer::Ptr Buffer::createVertexBuffer(const Device::Ptr& device, VkDeviceSize size, void* pData){
-      auto buffer = create(device, size,
-                           static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
-                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+   static MemoryCategory getMemoryCategory(VkBufferUsageFlags usage) {
+      if (usage & VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)  return MemoryCategory::Vertex;
+      if (usage & VK_BUFFER_USAGE_INDEX_BUFFER_BIT)   return MemoryCategory::Index;
+      if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) return MemoryCategory::Uniform;
+      if (usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT)  return MemoryCategory::Staging;
+      return MemoryCategory::Other;
+   }
 
-      return buffer;
+   Buffer::Ptr Buffer::createVertexBuffer(const Device::Ptr& device, VkDeviceSize size){
+      return create(device, size,
+                    static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
+                    MemoryUsage::GpuOnly);
    }
 
-   Buffer::Ptr Buffer::createIndexBuffer(const Device::Ptr& device, VkDeviceSize size, void* pData){
-      auto buffer = create(device, size,
-                           static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
-                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+   Buffer::Ptr Buffer::createVertexBuffer(const Device::Ptr& device, VkDeviceSize size, const void* pData, UploadBatch& uploadBatch){
+      auto buffer = createVertexBuffer(device, size);
+
+      //the batch keeps the buffer alive until the copy has executed
+      uploadBatch.uploadBuffer(buffer, pData, size);
 
       return buffer;
+   }
 
+   Buffer::Ptr Buffer::createIndexBuffer(const Device::Ptr& device, VkDeviceSize size){
+      return create(device, size,
+                    static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
+                    MemoryUsage::GpuOnly);
+   }
+
+   Buffer::Ptr Buffer::createIndexBuffer(const Device::Ptr& device, VkDeviceSize size, const void* pData, UploadBatch& uploadBatch){
+      auto buffer = createIndexBuffer(device, size);
+
+      uploadBatch.uploadBuffer(buffer, pData, size);
+
+      return buffer;
    }
 
    Buffer::Ptr Buffer::createUniformBuffer(const Device::Ptr& device, VkDeviceSize size, void* pData) {
        auto buffer = create(device, size,
            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+           MemoryUsage::CpuToGpu
        );
 
+       buffer->mapPersistently();
+
        if (pData != nullptr)
-           buffer->updateBufferByStage(pData, size);
+           buffer->updateBufferByMap(pData, size);
+
 
        return buffer;
    }
@@ -36,59 +60,71 @@ namespace Tea::Wrapper {
    {
        auto buffer = create(device, size,
            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+           MemoryUsage::CpuOnly);
+
+       buffer->mapPersistently();
 
        if (pData != nullptr) {
-           buffer->updateBufferByStage(pData, size);
+           buffer->updateBufferByMap(pData, size);
        }
 
+
        return buffer;
    }
 
-    uint32_t Buffer::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties){
-      VkPhysicalDeviceMemoryProperties memProperties;
-      vkGetPhysicalDeviceMemoryProperties(mDevice->getPhysicalDevice(), &memProperties);
-
-      for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-         if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) ) {
-            return i;
-         }
-      }
-      
-      throw std::runtime_error("failed to find suitable memory type!");
-    }
-
     Buffer::Buffer(const Device::Ptr& device, VkDeviceSize size, VkBufferUsageFlagBits usage,
                    VkMemoryPropertyFlags properties) {
        mDevice = device;
+
+       auto memReq = createBuffer(size, usage);
+
+       //bufferڴ͵IDs:0x001 0x010
+       bindMemory(memReq, mDevice->findMemoryType(memReq.memoryTypeBits, properties), getMemoryCategory(usage));
+   }
+
+    Buffer::Buffer(const Device::Ptr& device, VkDeviceSize size, VkBufferUsageFlagBits usage, MemoryUsage memoryUsage) {
+       mDevice = device;
+
+       auto memReq = createBuffer(size, usage);
+
+       bindMemory(memReq, mDevice->findMemoryType(memReq.memoryTypeBits, memoryUsage), getMemoryCategory(usage));
+   }
+
+    VkMemoryRequirements Buffer::createBuffer(VkDeviceSize size, VkBufferUsageFlagBits usage) {
        VkBufferCreateInfo createInfo{};
        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
        createInfo.size = size;
        createInfo.usage = usage;
        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+       //filled by the transfer queue and read by the graphics queue, concurrent sharing saves the ownership transfer barriers
+       auto queueFamilies = mDevice->getUploadQueueFamilies();
+       if ((usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) && queueFamilies.size() > 1) {
+           createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+           createInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+           createInfo.pQueueFamilyIndices = queueFamilies.data();
+       }
+
+
        if(vkCreateBuffer(mDevice->getDevice(), &createInfo, nullptr, &mBuffer)!= VK_SUCCESS){
            throw std::runtime_error("Error: failed to allocate memory");
        }
 
+       mBufferInfo.buffer = mBuffer;
+       mBufferInfo.offset = 0;
+       mBufferInfo.range = size;
+
        VkMemoryRequirements memReq{};
        vkGetBufferMemoryRequirements(mDevice->getDevice(), mBuffer, &memReq);
 
-       VkMemoryAllocateInfo allocInfo{};
-       allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-       allocInfo.allocationSize = memReq.size;
-       //bufferڴ͵IDs:0x001 0x010
-       allocInfo.memoryTypeIndex = findMemoryType(memReq.memoryTypeBits, properties);
-
-       if (vkAllocateMemory(mDevice->getDevice(), &allocInfo, nullptr, &mBufferMemory) != VK_SUCCESS) {
-            throw std::runtime_error("Error: failed to allocate memory");
-       }
+       return memReq;
+   }
 
-       vkBindBufferMemory(mDevice->getDevice(), mBuffer, mBufferMemory, 0);
+    void Buffer::bindMemory(const VkMemoryRequirements& memReq, uint32_t memoryTypeIndex, MemoryCategory category) {
+       //sub-allocated from a shared block, so the buffer has to be bound at the allocation offset
+       mAllocation = mDevice->getAllocator()->allocate(memReq, memoryTypeIndex, true, category);
 
-       mBufferInfo.buffer = mBuffer;
-       mBufferInfo.offset = 0;
-       mBufferInfo.range = size;
+       vkBindBufferMemory(mDevice->getDevice(), mBuffer, mAllocation.mMemory, mAllocation.mOffset);
    }
 
     Buffer::~Buffer() {
@@ -96,43 +132,46 @@ namespace Tea::Wrapper {
             vkDestroyBuffer(mDevice->getDevice(), mBuffer, nullptr);
         }
 
-        if (mBufferMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(mDevice->getDevice(), mBufferMemory, nullptr);
+        if (mMappedData != nullptr) {
+            mDevice->getAllocator()->unmap(mAllocation);
         }
-    }
-
-    void Buffer::updateBufferByMap(void* data, size_t size) {
-        void* memPtr{nullptr};
 
-        vkMapMemory(mDevice->getDevice(), mBufferMemory, 0, size, 0, &memPtr);
-        memcpy(memPtr, data, size);
-        vkUnmapMemory(mDevice->getDevice(), mBufferMemory);
+        mDevice->getAllocator()->free(mAllocation);
     }
 
-    void Buffer::updateBufferByStage(void* data, size_t size) {
-        auto stageBuffer = create(mDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        stageBuffer->updateBufferByMap(data, size);
+    void* Buffer::mapPersistently() {
+        if (mMappedData == nullptr) {
+            mMappedData = mDevice->getAllocator()->map(mAllocation);
+        }
 
-        copyBuffer(stageBuffer->getBuffer(), mBuffer, static_cast<VkDeviceSize>(size));
+        return mMappedData;
     }
 
-    void Buffer::copyBuffer(const VkBuffer& srcBuffer, const VkBuffer& dstBuffer, VkDeviceSize size){
-        auto commandPool = CommandPool::create(mDevice);
-        auto commandBuffer = CommandBuffer::create(mDevice, commandPool);
+    void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) {
+        mDevice->getAllocator()->flush(mAllocation, offset, size);
+    }
 
-        commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    void Buffer::updateBufferByMap(void* data, size_t size) {
+        if (mMappedData != nullptr) {
+            memcpy(mMappedData, data, size);
+            flush(0, size);
+            return;
+        }
 
-        VkBufferCopy copyInfo{};
-        copyInfo.size = size;
-        copyInfo.dstOffset = 0;
-        copyInfo.srcOffset = 0;
+        //the block may hold other resources, so it is mapped through the allocator instead of vkMapMemory on the shared VkDeviceMemory
+        void* memPtr = mDevice->getAllocator()->map(mAllocation);
+        memcpy(memPtr, data, size);
+        flush(0, size);
+        mDevice->getAllocator()->unmap(mAllocation);
+    }
 
-        commandBuffer->copyBufferToBuffer(srcBuffer, dstBuffer, 1, { copyInfo });
 
-        commandBuffer->end();
+    void Buffer::updateBufferByStage(UploadBatch& uploadBatch, const void* data, size_t size) {
+        uploadBatch.uploadBuffer(mBuffer, data, static_cast<VkDeviceSize>(size));
+    }
 
-        commandBuffer->submitSync(mDevice->getGraphicQueue(), VK_NULL_HANDLE);
+    void Buffer::copyBuffer(UploadBatch& uploadBatch, const VkBuffer& srcBuffer, const VkBuffer& dstBuffer, VkDeviceSize size){
+        uploadBatch.copyBuffer(srcBuffer, dstBuffer, size);
     }
 
 
@@ -3,6 +3,7 @@
 #include "../base.h"
 #include "device.h"
 namespace Tea::Wrapper {
+   class UploadBatch;
 
    class Buffer{
    public: 
@@ -11,15 +12,27 @@ namespace Tea::Wrapper {
          return std::make_shared<Buffer>(device, size, usage, properties);
       }
 
-      static Ptr createVertexBuffer(const Device::Ptr& device, VkDeviceSize size, void * pData);
+      //memory type chosen by placement policy instead of exact flags, see MemoryUsage
+      static Ptr create(const Device::Ptr& device, VkDeviceSize size, VkBufferUsageFlagBits usage, MemoryUsage memoryUsage){
+         return std::make_shared<Buffer>(device, size, usage, memoryUsage);
+      }
+
+      static Ptr createVertexBuffer(const Device::Ptr& device, VkDeviceSize size);
+
+      //pData is recorded into uploadBatch, the buffer holds it once the batch's ticket has completed
+      static Ptr createVertexBuffer(const Device::Ptr& device, VkDeviceSize size, const void* pData, UploadBatch& uploadBatch);
+
+      static Ptr createIndexBuffer(const Device::Ptr& device, VkDeviceSize size);
 
-      static Ptr createIndexBuffer(const Device::Ptr& device, VkDeviceSize size, void * pData);
+      static Ptr createIndexBuffer(const Device::Ptr& device, VkDeviceSize size, const void* pData, UploadBatch& uploadBatch);
 
       static Ptr createUniformBuffer(const Device::Ptr& device, VkDeviceSize size, void* pData);
 
       static Ptr createStageBuffer(const Device::Ptr& device, VkDeviceSize size, void* pData);
 
       Buffer(const Device::Ptr& device, VkDeviceSize size, VkBufferUsageFlagBits usage, VkMemoryPropertyFlags properties);
+
+      Buffer(const Device::Ptr& device, VkDeviceSize size, VkBufferUsageFlagBits usage, MemoryUsage memoryUsage);
          
       ~Buffer();
 
@@ -30,22 +43,41 @@ namespace Tea::Wrapper {
 
       void updateBufferByMap(void* data, size_t size);
 
-      void updateBufferByStage(void* data, size_t size);
+      //host visible buffers that are written every frame stay mapped for their whole lifetime,
+      //updateBufferByMap is then a plain memcpy (plus a flush on non coherent memory)
+      void* mapPersistently();
+
+      //only needed after writing through getMappedData() directly, updateBufferByMap flushes by itself
+      void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
 
-      void copyBuffer(const VkBuffer& srcBuffer, const VkBuffer& dstBuffer, VkDeviceSize size);
+      //recorded into the caller's batch, so many uploads share one command buffer and submission.
+      //The caller submits the batch and waits for its ticket before the buffer is used
+      void updateBufferByStage(UploadBatch& uploadBatch, const void* data, size_t size);
+
+      void copyBuffer(UploadBatch& uploadBatch, const VkBuffer& srcBuffer, const VkBuffer& dstBuffer, VkDeviceSize size);
 
       [[nodiscard]] auto getBuffer() const { return mBuffer; }
 
       [[nodiscard]] VkDescriptorBufferInfo& getBufferInfo() { return mBufferInfo; }
+
+      [[nodiscard]] auto getMappedData() const { return mMappedData; }
+
       
    private:
-      uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+      VkMemoryRequirements createBuffer(VkDeviceSize size, VkBufferUsageFlagBits usage);
+
+      void bindMemory(const VkMemoryRequirements& memReq, uint32_t memoryTypeIndex, MemoryCategory category);
 
       Device::Ptr mDevice;
       //description in cpu, vkCreateBuffer һǷcpuϵ
       VkBuffer mBuffer{VK_NULL_HANDLE };
       //memory in gpu
-      VkDeviceMemory mBufferMemory{VK_NULL_HANDLE };
+      MemoryAllocation mAllocation{};
+
+      void* mMappedData{ nullptr };
+
+
 
       VkDescriptorBufferInfo mBufferInfo{};
    };
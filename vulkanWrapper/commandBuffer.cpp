@@ -48,10 +48,69 @@ namespace Tea::Wrapper {
 		vkCmdBindPipeline(mCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 	}
 
-	void CommandBuffer::bindDescriptorSet(const VkPipelineLayout layout, const VkDescriptorSet& descriptorSet) {
-		vkCmdBindDescriptorSets(mCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptorSet, 0, nullptr);
+	void CommandBuffer::setViewport(const VkViewport& viewport) {
+		vkCmdSetViewport(mCommandBuffer, 0, 1, &viewport);
 	}
 
+	void CommandBuffer::setScissor(const VkRect2D& scissor) {
+		vkCmdSetScissor(mCommandBuffer, 0, 1, &scissor);
+	}
+
+	void CommandBuffer::setViewportAndScissor(VkExtent2D extent) {
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(extent.width);
+		viewport.height = static_cast<float>(extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		setViewport(viewport);
+
+		VkRect2D scissor{};
+		scissor.offset = { 0, 0 };
+		scissor.extent = extent;
+		setScissor(scissor);
+	}
+
+	void CommandBuffer::setCullMode(VkCullModeFlags cullMode) {
+		mDevice->getExtendedDynamicStateCommands().mSetCullMode(mCommandBuffer, cullMode);
+	}
+
+	void CommandBuffer::setFrontFace(VkFrontFace frontFace) {
+		mDevice->getExtendedDynamicStateCommands().mSetFrontFace(mCommandBuffer, frontFace);
+	}
+
+	void CommandBuffer::setPrimitiveTopology(VkPrimitiveTopology topology) {
+		mDevice->getExtendedDynamicStateCommands().mSetPrimitiveTopology(mCommandBuffer, topology);
+	}
+
+	void CommandBuffer::setDepthTestEnable(bool enable) {
+		mDevice->getExtendedDynamicStateCommands().mSetDepthTestEnable(mCommandBuffer, enable ? VK_TRUE : VK_FALSE);
+	}
+
+	void CommandBuffer::setDepthWriteEnable(bool enable) {
+		mDevice->getExtendedDynamicStateCommands().mSetDepthWriteEnable(mCommandBuffer, enable ? VK_TRUE : VK_FALSE);
+	}
+
+	void CommandBuffer::setDepthCompareOp(VkCompareOp compareOp) {
+		mDevice->getExtendedDynamicStateCommands().mSetDepthCompareOp(mCommandBuffer, compareOp);
+	}
+
+	void CommandBuffer::bindDescriptorSet(const VkPipelineLayout layout, const VkDescriptorSet& descriptorSet, const std::vector<uint32_t>& dynamicOffsets) {
+		vkCmdBindDescriptorSets(
+			mCommandBuffer, 
+			VK_PIPELINE_BIND_POINT_GRAPHICS, 
+			layout, 
+			0, 1, &descriptorSet, 
+			static_cast<uint32_t>(dynamicOffsets.size()), 
+			dynamicOffsets.empty() ? nullptr : dynamicOffsets.data());
+	}
+
+	void CommandBuffer::pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data) {
+		vkCmdPushConstants(mCommandBuffer, layout, stages, offset, size, data);
+	}
+
+
 	void CommandBuffer::bindVertexBuffer(const std::vector<VkBuffer>& buffers){
 		std::vector<VkDeviceSize> offsets(buffers.size(), 0);
 
@@ -84,7 +143,12 @@ namespace Tea::Wrapper {
 	}
 	
 	void CommandBuffer::copyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height) {
+		copyBufferToImage(srcBuffer, 0, dstImage, dstImageLayout, width, height, 0);
+	}
+
+	void CommandBuffer::copyBufferToImage(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height, int32_t yOffset) {
 		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
 
 		//Ϊ0Ҫpadding
 		region.bufferRowLength = 0;
@@ -94,22 +158,28 @@ namespace Tea::Wrapper {
 		region.imageSubresource.mipLevel = 0;
 		region.imageSubresource.baseArrayLayer = 0;
 		region.imageSubresource.layerCount = 1;
-		region.imageOffset = { 0, 0, 0 };
+		region.imageOffset = { 0, yOffset, 0 };
 		region.imageExtent = { width, height, 1 };
 
 		vkCmdCopyBufferToImage(mCommandBuffer, srcBuffer, dstImage, dstImageLayout, 1, &region);
 	}
 
-	void CommandBuffer::submitSync(VkQueue queue, VkFence fence){
-		//The submitSync method is called to submit the command buffer to the graphics queue and wait for the operation to complete
-		VkSubmitInfo submitInfo{};
-		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &mCommandBuffer;
+	void CommandBuffer::submitSync(QueueType queue) {
+		//waits for this submission's timeline value only, vkQueueWaitIdle would also drain all rendering work on the queue
+		auto scheduler = mDevice->getFrameScheduler();
+		scheduler->wait(queue, scheduler->submit(queue, { mCommandBuffer }));
+	}
 
-		vkQueueSubmit(queue, 1, &submitInfo, fence);
+	uint64_t CommandBuffer::submit(QueueType queue, const std::vector<SubmitWait>& waits, const std::vector<VkSemaphore>& binarySignals) {
+		return mDevice->getFrameScheduler()->submit(queue, { mCommandBuffer }, waits, binarySignals);
+	}
+
+	void CommandBuffer::resetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount) {
+		vkCmdResetQueryPool(mCommandBuffer, queryPool, firstQuery, queryCount);
+	}
 
-		vkQueueWaitIdle(queue);
+	void CommandBuffer::writeTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query) {
+		vkCmdWriteTimestamp(mCommandBuffer, stage, queryPool, query);
 	}
 
 	void CommandBuffer::transferImageLayout(const VkImageMemoryBarrier& imageMemoryBarrier, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask) {
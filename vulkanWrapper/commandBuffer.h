@@ -23,7 +23,43 @@ namespace Tea::Wrapper {
 
 		void bindGraphicPipeline(const VkPipeline& pipeline);
 
-		void bindDescriptorSet(const VkPipelineLayout layout, const VkDescriptorSet& descriptorSet);
+		//only valid for pipelines built with the matching Pipeline::setDynamicStates entry
+		void setViewport(const VkViewport& viewport);
+
+		void setScissor(const VkRect2D& scissor);
+
+		//viewport and scissor covering the whole extent
+		void setViewportAndScissor(VkExtent2D extent);
+
+		//the setters below need Device::isExtendedDynamicStateSupported
+		void setCullMode(VkCullModeFlags cullMode);
+
+		void setFrontFace(VkFrontFace frontFace);
+
+		void setPrimitiveTopology(VkPrimitiveTopology topology);
+
+		void setDepthTestEnable(bool enable);
+
+		void setDepthWriteEnable(bool enable);
+
+		void setDepthCompareOp(VkCompareOp compareOp);
+
+		//dynamicOffsets: one offset per dynamic descriptor in the set, ordered by binding number
+		void bindDescriptorSet(const VkPipelineLayout layout, const VkDescriptorSet& descriptorSet, const std::vector<uint32_t>& dynamicOffsets = {});
+
+		//small per draw data goes straight into the command buffer, no descriptor or buffer update is needed.
+		//layout must have a range covering [offset, offset + size) for exactly these stages (Pipeline::addPushConstantRange)
+		void pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data);
+
+		template<typename T>
+		void pushConstants(VkPipelineLayout layout, VkShaderStageFlags stages, const T& data, uint32_t offset = 0) {
+			static_assert(std::is_trivially_copyable_v<T>, "push constants are copied byte wise");
+			static_assert(sizeof(T) % 4 == 0, "push constant size has to be a multiple of 4");
+			static_assert(sizeof(T) <= 128, "more than the 128 bytes of push constants every device supports");
+
+			pushConstants(layout, stages, offset, static_cast<uint32_t>(sizeof(T)), &data);
+		}
+
 
 		void bindVertexBuffer(const std::vector<VkBuffer>& buffers);
 
@@ -41,9 +77,24 @@ namespace Tea::Wrapper {
 
 		void copyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height);
 
+		//copies rows [yOffset, yOffset + height) of the image from tightly packed rows starting at srcOffset
+		void copyBufferToImage(VkBuffer srcBuffer, VkDeviceSize srcOffset, VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height, int32_t yOffset);
+
+
+		//queries have to be reset outside of a render pass before they are written again
+		void resetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount);
+
+		void writeTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query);
+
 		void transferImageLayout(const VkImageMemoryBarrier& imageMemoryBarrier, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask);
 
-		void submitSync(VkQueue queue, VkFence fence = {VK_NULL_HANDLE});
+		//submits to the queue of that type and waits until this submission has completed
+		void submitSync(QueueType queue);
+
+		//returns right after vkQueueSubmit with the timeline value the submission signals,
+		//the command buffer must stay alive until the queue has reached it (see FrameScheduler)
+		uint64_t submit(QueueType queue, const std::vector<SubmitWait>& waits = {}, const std::vector<VkSemaphore>& binarySignals = {});
+
 
 		[[nodiscard]] auto getCommandBuffer() const { return mCommandBuffer; }
 
@@ -2,12 +2,12 @@
 
 namespace Tea::Wrapper {
 	
-	CommandPool::CommandPool(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag) {
+	CommandPool::CommandPool(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag, std::optional<uint32_t> queueFamilyIndex) {
 		mDevice = device;
 
 		VkCommandPoolCreateInfo poolCreateInfo{};
 		poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		poolCreateInfo.queueFamilyIndex = device->getGraphicQueueFamily().value();
+		poolCreateInfo.queueFamilyIndex = queueFamilyIndex.value_or(device->getGraphicQueueFamily().value());
 		poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
 		if (vkCreateCommandPool(mDevice->getDevice(), &poolCreateInfo, nullptr, &mCommandPool) != VK_SUCCESS) {
@@ -10,11 +10,12 @@ namespace Tea::Wrapper {
 	class CommandPool {
 	public:
 		using Ptr = std::shared_ptr<CommandPool>;
-		static Ptr create(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT) {
-			return std::make_shared<CommandPool>(device, flag);
+		//queueFamilyIndex defaults to the graphics family, command buffers from the pool can only be submitted to queues of that family
+		static Ptr create(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, std::optional<uint32_t> queueFamilyIndex = std::nullopt) {
+			return std::make_shared<CommandPool>(device, flag, queueFamilyIndex);
 		}
 
-		CommandPool(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+		CommandPool(const Device::Ptr& device, VkCommandPoolCreateFlagBits flag = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, std::optional<uint32_t> queueFamilyIndex = std::nullopt);
 
 		~CommandPool();
 
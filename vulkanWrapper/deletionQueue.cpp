@@ -0,0 +1,51 @@
+#include "deletionQueue.h"
+
+namespace Tea::Wrapper {
+
+	DeletionQueue::DeletionQueue(const Device::Ptr& device) {
+		mDevice = device;
+	}
+
+	DeletionQueue::~DeletionQueue() {
+		flush();
+	}
+
+	void DeletionQueue::retire(std::shared_ptr<void> resource, QueueType queue, uint64_t value) {
+		if (resource == nullptr) {
+			return;
+		}
+
+		Entry entry{};
+		entry.mResource = std::move(resource);
+		entry.mQueue = queue;
+		entry.mValue = value;
+
+		mEntries.push_back(std::move(entry));
+	}
+
+	void DeletionQueue::retire(std::shared_ptr<void> resource) {
+		auto value = mDevice->getFrameScheduler()->getSubmittedValue(QueueType::Graphics);
+		retire(std::move(resource), QueueType::Graphics, value);
+	}
+
+	void DeletionQueue::collect() {
+		auto scheduler = mDevice->getFrameScheduler();
+
+		mEntries.erase(
+			std::remove_if(mEntries.begin(), mEntries.end(), [&scheduler](const Entry& entry) {
+				return scheduler->isComplete(entry.mQueue, entry.mValue);
+			}),
+			mEntries.end()
+		);
+	}
+
+	void DeletionQueue::flush() {
+		auto scheduler = mDevice->getFrameScheduler();
+
+		for (const auto& entry : mEntries) {
+			scheduler->wait(entry.mQueue, entry.mValue);
+		}
+
+		mEntries.clear();
+	}
+}
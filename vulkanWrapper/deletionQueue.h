@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+
+namespace Tea::Wrapper {
+	//Keeps resources alive until the GPU work that may still use them has completed, instead of draining the device
+	//with vkDeviceWaitIdle before destroying them. A resource is any wrapper Ptr, whose destructor releases the Vulkan
+	//objects: e.g. a retired SwapChain takes its image views, framebuffers and depth image with it.
+	//collect() once per frame releases whatever has completed, flush() waits for and releases everything.
+
+	class DeletionQueue {
+	public:
+		using Ptr = std::shared_ptr<DeletionQueue>;
+		static Ptr create(const Device::Ptr& device) { return std::make_shared<DeletionQueue>(device); }
+
+		DeletionQueue(const Device::Ptr& device);
+
+		~DeletionQueue();
+
+		//released once queue has reached value, usually the last value submitted to it
+		void retire(std::shared_ptr<void> resource, QueueType queue, uint64_t value);
+
+		//released once everything submitted to the graphics queue so far has completed
+		void retire(std::shared_ptr<void> resource);
+
+		void collect();
+
+		void flush();
+
+		[[nodiscard]] auto getPendingCount() const { return mEntries.size(); }
+
+	private:
+		struct Entry {
+			std::shared_ptr<void>	mResource{ nullptr };
+			QueueType				mQueue{ QueueType::Graphics };
+			uint64_t				mValue{ 0 };
+		};
+
+		//values of different queues complete out of order, so every entry is checked
+		std::vector<Entry> mEntries{};
+
+		Device::Ptr mDevice{ nullptr };
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "buffer.h"
+#include "uniformRingAllocator.h"
+
 #include "../texture/texture.h"
 
 namespace Tea::Wrapper {
@@ -18,6 +20,11 @@ namespace Tea::Wrapper {
 		VkShaderStageFlagBits	mStage;
 
 		std::vector<Buffer::Ptr> mBuffers{};
+
+		//VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC: every frame's descriptor points at the ring buffer with range mSize,
+		//the slice that is actually read is selected by the dynamic offset at bind time
+		UniformRingAllocator::Ptr mRingAllocator{ nullptr };
+
 		Texture::Ptr mTexture{ nullptr };
 	};
 
@@ -13,12 +13,16 @@ namespace Tea::Wrapper {
 
 	void DescriptorPool::build(std::vector<UniformParameter::Ptr>& params, const int& frameCount) {
 		int uniformBufferCount{ 0 };
+		int dynamicUniformBufferCount{ 0 };
 		int textureCount{ 0 };
 
 		for (const auto& param : params) {
 			if(param->mDescriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
 				uniformBufferCount++;
 
+			if (param->mDescriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+				dynamicUniformBufferCount++;
+
 			if (param->mDescriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) 
 				textureCount++; 
 		}
@@ -26,15 +30,27 @@ namespace Tea::Wrapper {
 		//ÿһuniformжٸ
 		std::vector<VkDescriptorPoolSize> poolSizes{};
 
-		VkDescriptorPoolSize uniformBufferSize{};
-		uniformBufferSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		uniformBufferSize.descriptorCount = uniformBufferCount * frameCount;
-		poolSizes.push_back(uniformBufferSize);
+		//descriptorCount of a pool size must not be 0, so unused types are skipped
+		if (uniformBufferCount > 0) {
+			VkDescriptorPoolSize uniformBufferSize{};
+			uniformBufferSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			uniformBufferSize.descriptorCount = uniformBufferCount * frameCount;
+			poolSizes.push_back(uniformBufferSize);
+		}
 
-		VkDescriptorPoolSize textureSize{};
-		textureSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		textureSize.descriptorCount = textureCount * frameCount;//ߵsizeָжٸdescriptor
-		poolSizes.push_back(textureSize);
+		if (dynamicUniformBufferCount > 0) {
+			VkDescriptorPoolSize dynamicUniformBufferSize{};
+			dynamicUniformBufferSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+			dynamicUniformBufferSize.descriptorCount = dynamicUniformBufferCount * frameCount;
+			poolSizes.push_back(dynamicUniformBufferSize);
+		}
+
+		if (textureCount > 0) {
+			VkDescriptorPoolSize textureSize{};
+			textureSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			textureSize.descriptorCount = textureCount * frameCount;//ߵsizeָжٸdescriptor
+			poolSizes.push_back(textureSize);
+		}
 
 		VkDescriptorPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
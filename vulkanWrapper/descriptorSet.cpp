@@ -27,6 +27,11 @@ namespace Tea::Wrapper {
 		for (int i = 0; i < frameCount; ++i) {
 			std::vector<VkWriteDescriptorSet> descriptorSetWrites{};
 
+			//pBufferInfo must stay valid until vkUpdateDescriptorSets, so no reallocation is allowed
+			std::vector<VkDescriptorBufferInfo> dynamicBufferInfos{};
+			dynamicBufferInfos.reserve(params.size());
+
+
 			for (const auto& param : params) {
 				VkWriteDescriptorSet descriptorSetWrite{};
 				descriptorSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -40,6 +45,17 @@ namespace Tea::Wrapper {
 					descriptorSetWrite.pBufferInfo = &param->mBuffers[i]->getBufferInfo();
 				}
 
+				if (param->mDescriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) {
+					VkDescriptorBufferInfo bufferInfo{};
+					bufferInfo.buffer = param->mRingAllocator->getBuffer()->getBuffer();
+					bufferInfo.offset = 0;
+					bufferInfo.range = param->mSize;
+
+					dynamicBufferInfos.push_back(bufferInfo);
+					descriptorSetWrite.pBufferInfo = &dynamicBufferInfos.back();
+				}
+
+
 				if (param->mDescriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
 					descriptorSetWrite.pImageInfo = &param->mTexture->getImageInfo();
 				}
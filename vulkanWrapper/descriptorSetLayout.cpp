@@ -15,9 +15,6 @@ namespace Tea::Wrapper{
 	void DescriptorSetLayout::build(const std::vector<UniformParameter::Ptr>& params) {
 		mParams = params;
 
-		if (mLayout != VK_NULL_HANDLE) {
-			vkDestroyDescriptorSetLayout(mDevice->getDevice(), mLayout, nullptr);
-		}
 		std::vector<VkDescriptorSetLayoutBinding> layoutBindings{};
 
 		for (const auto& param : mParams) {
@@ -30,10 +27,20 @@ namespace Tea::Wrapper{
 			layoutBindings.push_back(layoutBinding);
 		}
 
+		build(layoutBindings);
+	}
+
+	void DescriptorSetLayout::build(const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+		mBindings = bindings;
+
+		if (mLayout != VK_NULL_HANDLE) {
+			vkDestroyDescriptorSetLayout(mDevice->getDevice(), mLayout, nullptr);
+		}
+
 		VkDescriptorSetLayoutCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-		createInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
-		createInfo.pBindings= layoutBindings.data();
+		createInfo.bindingCount = static_cast<uint32_t>(mBindings.size());
+		createInfo.pBindings= mBindings.data();
 
 		if (vkCreateDescriptorSetLayout(mDevice->getDevice(), &createInfo, nullptr, &mLayout) != VK_SUCCESS) {
 			throw std::runtime_error("Error: failed to create descriptor set layout");
@@ -17,14 +17,20 @@ namespace Tea::Wrapper {
 
 		void build(const std::vector<UniformParameter::Ptr>& params);
 
+		//immutable samplers are not supported
+		void build(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
 		[[nodiscard]] auto getLayout() const { return mLayout; }
 
+		[[nodiscard]] const auto& getBindings() const { return mBindings; }
+
 	private:
 		Wrapper::Device::Ptr mDevice{ nullptr };
 
 		VkDescriptorSetLayout mLayout{ VK_NULL_HANDLE };
 
 		std::vector<UniformParameter::Ptr> mParams{};
+		std::vector<VkDescriptorSetLayoutBinding> mBindings{};
 	};
 
 }
\ No newline at end of file
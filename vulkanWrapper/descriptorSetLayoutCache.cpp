@@ -0,0 +1,46 @@
+#include "descriptorSetLayoutCache.h"
+#include "descriptorSetLayout.h"
+
+namespace Tea::Wrapper {
+
+	std::shared_ptr<DescriptorSetLayout> DescriptorSetLayoutCache::get(const std::shared_ptr<Device>& device, const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+		//binding order does not matter to Vulkan, so it does not to the key either
+		auto sorted = bindings;
+		std::sort(sorted.begin(), sorted.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+			return a.binding < b.binding;
+		});
+
+		StateKey key{};
+		key.add(sorted.size());
+		for (const auto& binding : sorted) {
+			key.add(binding.binding);
+			key.add(binding.descriptorType);
+			key.add(binding.descriptorCount);
+			key.add(binding.stageFlags);
+		}
+		auto hash = key.getHash();
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto range = mLayouts.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second.first == key) {
+				if (auto layout = it->second.second.lock()) {
+					return layout;
+				}
+			}
+		}
+
+		//drops entries whose layout is gone
+		for (auto it = mLayouts.begin(); it != mLayouts.end();) {
+			it = it->second.second.expired() ? mLayouts.erase(it) : std::next(it);
+		}
+
+		auto layout = DescriptorSetLayout::create(device);
+		layout->build(sorted);
+
+		mLayouts.emplace(hash, std::make_pair(std::move(key), std::weak_ptr<DescriptorSetLayout>(layout)));
+
+		return layout;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../base.h"
+#include "pipelineStateCache.h"
+
+namespace Tea::Wrapper {
+	class Device;
+	class DescriptorSetLayout;
+
+	//Hands out one DescriptorSetLayout per set of bindings, so pipelines built from equal descriptions
+	//(e.g. reflected from the same shaders, see ReflectedLayout) share set layouts and with them compatible
+	//pipeline layouts: a descriptor set bound for one can stay bound for the next.
+	//Entries are weak like PipelineStateCache's. Thread safe, owned by Device.
+	class DescriptorSetLayoutCache {
+	public:
+		using Ptr = std::shared_ptr<DescriptorSetLayoutCache>;
+		static Ptr create() { return std::make_shared<DescriptorSetLayoutCache>(); }
+
+		DescriptorSetLayoutCache() = default;
+
+		~DescriptorSetLayoutCache() = default;
+
+		//the device is passed in because the cache is owned by it, immutable samplers are not supported
+		std::shared_ptr<DescriptorSetLayout> get(const std::shared_ptr<Device>& device, const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+	private:
+		std::unordered_multimap<uint64_t, std::pair<StateKey, std::weak_ptr<DescriptorSetLayout>>> mLayouts{};
+
+		std::mutex mMutex;
+	};
+}
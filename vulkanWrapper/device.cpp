@@ -10,12 +10,37 @@ namespace Tea::Wrapper {
 		mInstance = instance;
 		mSurface = surface;
 		pickPhysicalDevice();
+		vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &mMemoryProperties);
 		initQueueFamilies(mPhysicalDevice);
+
 		createLogicalDevice();
 	}
 
 	Device::~Device() {
+		//finishes the pipelines still compiling
+		mPipelineCompiler.reset();
+
+		mUploadHeap.reset();
+		//waits for every submission still in flight
+		mFrameScheduler.reset();
+		mAllocator.reset();
+
+		mPipelineStateCache.reset();
+
+		if (mPipelineCache != nullptr && !mPipelineCache->save()) {
+			std::cerr << "Error: failed to save pipeline cache to " << PipelineCache::DefaultPath << std::endl;
+		}
+		mPipelineCache.reset();
+
+		if (mPipelineManifest != nullptr && !mPipelineManifest->save()) {
+			std::cerr << "Error: failed to save pipeline manifest to " << PipelineManifest::DefaultPath << std::endl;
+		}
+		mPipelineManifest.reset();
+
+		mShaderLibrary.reset();
+
 		vkDestroyDevice(mDevice, nullptr);
+
 		mSurface.reset();
 		mInstance.reset();
 	}
@@ -36,8 +61,12 @@ namespace Tea::Wrapper {
 			candidates.insert(std::make_pair(score, device));
 		}
 
-		if (candidates.rbegin()->first > 0 && isDeviceSuitable(candidates.rbegin()->second)) {
-			mPhysicalDevice = candidates.rbegin()->second;
+		//best rated first, the first one that can run the renderer wins
+		for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+			if (isDeviceSuitable(it->second)) {
+				mPhysicalDevice = it->second;
+				break;
+			}
 		}
 
 		if (mPhysicalDevice == VK_NULL_HANDLE) {
@@ -51,32 +80,50 @@ namespace Tea::Wrapper {
 		VkPhysicalDeviceProperties  deviceProp;
 		vkGetPhysicalDeviceProperties(device, &deviceProp);
 
-		//ѹ  ӿȾ
-		VkPhysicalDeviceFeatures deviceFeatures;
-		vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
-
+		//integrated GPUs and CPU implementations (lavapipe on CI and render servers) are accepted, just rated lower
 		if (deviceProp.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
 			score += 1000;
 		}
+		else if (deviceProp.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) {
+			score += 500;
+		}
 
 		score += deviceProp.limits.maxImageDimension2D;
 
-		if (!deviceFeatures.geometryShader) {
-			return 0;
-		}
-
 		return score;
 
 	}
 	bool Device::isDeviceSuitable(VkPhysicalDevice device) {
-		VkPhysicalDeviceProperties deviceProp;
-		vkGetPhysicalDeviceProperties(device, &deviceProp);
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+
+		bool graphicsSupport = false;
+		bool presentSupport = false;
+		for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+			if (queueFamilies[i].queueCount > 0 && (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+				graphicsSupport = true;
+
+			if (mSurface != nullptr) {
+				VkBool32 support = VK_FALSE;
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, mSurface->getSurface(), &support);
+				presentSupport = presentSupport || support;
+			}
+		}
 
-		VkPhysicalDeviceFeatures deviceFeatures;
-		vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
+		//every submission is tracked with a timeline semaphore
+		if (!graphicsSupport || !isTimelineSemaphoreSupported(device)) {
+			return false;
+		}
+
+		//headless: no surface, nothing to present to
+		if (mSurface == nullptr) {
+			return true;
+		}
 
-		return deviceProp.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU &&
-			deviceFeatures.geometryShader;
+		return presentSupport && isExtensionSupported(device, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 	}
 
 	void Device::initQueueFamilies(VkPhysicalDevice device) {
@@ -90,26 +137,66 @@ namespace Tea::Wrapper {
 		from vkGetPhysicalDeviceQueueFamilyProperties()*/
 		int i = 0;
 		for (const auto& queueFamily : queueFamilies) {
-			if (queueFamily.queueCount > 0 && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) 
+			if (queueFamily.queueCount > 0 && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !mQueueFamilyIndices.graphicsFamily.has_value()) 
 				mQueueFamilyIndices.graphicsFamily = i;
 			
+			if (mSurface == nullptr) {
+				i++;
+				continue;
+			}
+
 			//Ѱ֧ʾĶ
 			VkBool32 presentSupport = VK_FALSE;
 			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, mSurface->getSurface(), &presentSupport);
 
-			if (presentSupport) 
+			if (presentSupport && !mQueueFamilyIndices.presentFamily.has_value()) 
 				mQueueFamilyIndices.presentFamily = i;
 
-			if (mQueueFamilyIndices.isComplete())
-				break;
-			
 			i++;
 		}
+
+		//prefer the graphics family for presenting, one family for both avoids a concurrent swapchain
+		if (mQueueFamilyIndices.graphicsFamily.has_value() && mSurface != nullptr) {
+			VkBool32 presentSupport = VK_FALSE;
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, mQueueFamilyIndices.graphicsFamily.value(), mSurface->getSurface(), &presentSupport);
+
+			if (presentSupport)
+				mQueueFamilyIndices.presentFamily = mQueueFamilyIndices.graphicsFamily;
+		}
+
+		//a transfer only family is usually the DMA engine, a compute family without graphics still beats sharing the graphics queue
+		for (uint32_t index = 0; index < queueFamilyCount; ++index) {
+			auto flags = queueFamilies[index].queueFlags;
+			if (queueFamilies[index].queueCount == 0 || (flags & VK_QUEUE_GRAPHICS_BIT))
+				continue;
+
+			if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_COMPUTE_BIT) && !mQueueFamilyIndices.transferFamily.has_value())
+				mQueueFamilyIndices.transferFamily = index;
+
+			if ((flags & VK_QUEUE_COMPUTE_BIT) && !mQueueFamilyIndices.computeFamily.has_value())
+				mQueueFamilyIndices.computeFamily = index;
+		}
+
+		//compute families can always transfer
+		if (!mQueueFamilyIndices.transferFamily.has_value())
+			mQueueFamilyIndices.transferFamily = mQueueFamilyIndices.computeFamily;
+
+		if (mQueueFamilyIndices.graphicsFamily.has_value())
+			mTransferImageGranularity = queueFamilies[getTransferQueueFamily()].minImageTransferGranularity;
 	}
 
 	void Device::createLogicalDevice() {
 		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-		std::set<uint32_t> queueFamilies = { mQueueFamilyIndices.graphicsFamily.value(), mQueueFamilyIndices.presentFamily.value() };
+		std::set<uint32_t> queueFamilies = { 
+			mQueueFamilyIndices.graphicsFamily.value(), 
+			getTransferQueueFamily(),
+			getComputeQueueFamily()
+		};
+
+		//headless devices have no present family
+		if (mQueueFamilyIndices.presentFamily.has_value()) {
+			queueFamilies.insert(mQueueFamilyIndices.presentFamily.value());
+		}
 
 		float queuePriority = 1.0f;
 		for (uint32_t queueFamily : queueFamilies) {
@@ -129,8 +216,53 @@ namespace Tea::Wrapper {
 		deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 		deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-		deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceRequiredExtensions.size());
-		deviceCreateInfo.ppEnabledExtensionNames = deviceRequiredExtensions.data();
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineFeatures.timelineSemaphore = VK_TRUE;
+		deviceCreateInfo.pNext = &timelineFeatures;
+
+		//optional, pipelines fall back to baking the state when it is missing
+		mExtendedDynamicStateSupported = isExtensionSupported(mPhysicalDevice, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)
+			&& isExtendedDynamicStateFeatureSupported(mPhysicalDevice);
+
+		VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{};
+		extendedDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+		extendedDynamicStateFeatures.extendedDynamicState = VK_TRUE;
+		if (mExtendedDynamicStateSupported) {
+			timelineFeatures.pNext = &extendedDynamicStateFeatures;
+		}
+
+		//the swapchain is only needed when there is a surface to present to
+		std::vector<const char*> enabledExtensions{};
+		if (mSurface != nullptr) {
+			enabledExtensions = deviceRequiredExtensions;
+		}
+
+		//optional, only used for reporting. Its properties are read through vkGetPhysicalDeviceMemoryProperties2 (core 1.1),
+		//which instance and physical device both have to support
+		VkPhysicalDeviceProperties deviceProp{};
+		vkGetPhysicalDeviceProperties(mPhysicalDevice, &deviceProp);
+
+		mMemoryBudgetSupported = mInstance->getApiVersion() >= VK_API_VERSION_1_1 && deviceProp.apiVersion >= VK_API_VERSION_1_1
+			&& isExtensionSupported(mPhysicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		if (mMemoryBudgetSupported) {
+			enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
+		if (mExtendedDynamicStateSupported) {
+			enabledExtensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+		}
+
+		//optional, only used for reporting, has no feature to enable
+		mPipelineCreationFeedbackSupported = isExtensionSupported(mPhysicalDevice, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+		if (mPipelineCreationFeedbackSupported) {
+			enabledExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+		}
+
+		deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+		deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.data();
+
 
 		if (mInstance->getEnableValidationLayer() ) {
 			deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
@@ -148,6 +280,178 @@ namespace Tea::Wrapper {
 		//The queues are automatically created along with the logical device, but we don't have a handle to interface with them yet
 		//add a class member::VkQueue graphics(present)Queue;  to store a handle to the xxqueue retrieve the queue handle:
 		vkGetDeviceQueue(mDevice, mQueueFamilyIndices.graphicsFamily.value(), 0, &mGraphicQueue);
-		vkGetDeviceQueue(mDevice, mQueueFamilyIndices.presentFamily.value(), 0, &mPresentQueue);
+		if (mQueueFamilyIndices.presentFamily.has_value()) {
+			vkGetDeviceQueue(mDevice, mQueueFamilyIndices.presentFamily.value(), 0, &mPresentQueue);
+		}
+		vkGetDeviceQueue(mDevice, getTransferQueueFamily(), 0, &mTransferQueue);
+		vkGetDeviceQueue(mDevice, getComputeQueueFamily(), 0, &mComputeQueue);
+
+		if (mExtendedDynamicStateSupported) {
+			loadExtendedDynamicStateCommands();
+		}
+
+		mAllocator = MemoryAllocator::create(mPhysicalDevice, mDevice);
+
+		mFrameScheduler = FrameScheduler::create(mDevice, { mGraphicQueue, mTransferQueue, mComputeQueue });
+
+		mPipelineCache = PipelineCache::create(mDevice, mPhysicalDevice, PipelineCache::DefaultPath);
+		mPipelineStateCache = PipelineStateCache::create(mDevice, mPipelineCache->getPipelineCache(), mPipelineCreationFeedbackSupported);
+		mPipelineManifest = PipelineManifest::create(PipelineManifest::DefaultPath);
+		mShaderLibrary = ShaderLibrary::create(mDevice);
+		mDescriptorSetLayoutCache = DescriptorSetLayoutCache::create();
+
 	}
+
+	bool Device::isExtensionSupported(VkPhysicalDevice device, const char* extensionName) const {
+		uint32_t extensionCount = 0;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+		std::vector<VkExtensionProperties> extensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+
+		for (const auto& extension : extensions) {
+			if (strcmp(extension.extensionName, extensionName) == 0) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool Device::isTimelineSemaphoreSupported(VkPhysicalDevice device) const {
+		VkPhysicalDeviceProperties deviceProp{};
+		vkGetPhysicalDeviceProperties(device, &deviceProp);
+
+		if (mInstance->getApiVersion() < VK_API_VERSION_1_2 || deviceProp.apiVersion < VK_API_VERSION_1_2) {
+			return false;
+		}
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &timelineFeatures;
+
+		vkGetPhysicalDeviceFeatures2(device, &features);
+
+		return timelineFeatures.timelineSemaphore == VK_TRUE;
+	}
+
+	bool Device::isExtendedDynamicStateFeatureSupported(VkPhysicalDevice device) const {
+		VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{};
+		extendedDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &extendedDynamicStateFeatures;
+
+		vkGetPhysicalDeviceFeatures2(device, &features);
+
+		return extendedDynamicStateFeatures.extendedDynamicState == VK_TRUE;
+	}
+
+	void Device::loadExtendedDynamicStateCommands() {
+		auto& commands = mExtendedDynamicStateCommands;
+		commands.mSetCullMode = reinterpret_cast<PFN_vkCmdSetCullModeEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetCullModeEXT"));
+		commands.mSetFrontFace = reinterpret_cast<PFN_vkCmdSetFrontFaceEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetFrontFaceEXT"));
+		commands.mSetPrimitiveTopology = reinterpret_cast<PFN_vkCmdSetPrimitiveTopologyEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetPrimitiveTopologyEXT"));
+		commands.mSetDepthTestEnable = reinterpret_cast<PFN_vkCmdSetDepthTestEnableEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetDepthTestEnableEXT"));
+		commands.mSetDepthWriteEnable = reinterpret_cast<PFN_vkCmdSetDepthWriteEnableEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetDepthWriteEnableEXT"));
+		commands.mSetDepthCompareOp = reinterpret_cast<PFN_vkCmdSetDepthCompareOpEXT>(vkGetDeviceProcAddr(mDevice, "vkCmdSetDepthCompareOpEXT"));
+
+		if (commands.mSetCullMode == nullptr || commands.mSetFrontFace == nullptr || commands.mSetPrimitiveTopology == nullptr
+			|| commands.mSetDepthTestEnable == nullptr || commands.mSetDepthWriteEnable == nullptr || commands.mSetDepthCompareOp == nullptr) {
+			throw std::runtime_error("Error: failed to load VK_EXT_extended_dynamic_state commands");
+		}
+	}
+
+	std::vector<uint32_t> Device::getUploadQueueFamilies() const {
+
+		std::vector<uint32_t> families = { mQueueFamilyIndices.graphicsFamily.value() };
+		if (getTransferQueueFamily() != families[0]) {
+			families.push_back(getTransferQueueFamily());
+		}
+
+		return families;
+	}
+
+	uint32_t Device::findMemoryType(uint32_t typeFilter, MemoryUsage usage) const {
+		auto memoryTypeIndex = findMemoryTypeIndex(mMemoryProperties, typeFilter, usage);
+		if (!memoryTypeIndex.has_value()) {
+			throw std::runtime_error("Error: no memory type fits the requested memory usage");
+		}
+
+		return memoryTypeIndex.value();
+	}
+
+	uint32_t Device::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+		auto memoryTypeIndex = findMemoryTypeIndex(mMemoryProperties, typeFilter, properties);
+		if (!memoryTypeIndex.has_value()) {
+			throw std::runtime_error("Error: cannot find the property memory type!");
+		}
+
+		return memoryTypeIndex.value();
+	}
+
+	PipelineCompiler::Ptr Device::getPipelineCompiler() {
+		if (mPipelineCompiler == nullptr) {
+			mPipelineCompiler = PipelineCompiler::create();
+		}
+
+		return mPipelineCompiler;
+	}
+
+	UploadHeap::Ptr Device::getUploadHeap() {
+		if (mUploadHeap == nullptr) {
+			mUploadHeap = UploadHeap::create(mDevice, mAllocator, mFrameScheduler);
+		}
+
+
+		return mUploadHeap;
+	}
+
+	std::vector<MemoryHeapBudget> Device::getMemoryBudget() const {
+		auto stats = mAllocator->getStats();
+
+		std::vector<MemoryHeapBudget> heaps(mMemoryProperties.memoryHeapCount);
+		for (uint32_t i = 0; i < mMemoryProperties.memoryHeapCount; ++i) {
+			heaps[i].mSize = mMemoryProperties.memoryHeaps[i].size;
+			heaps[i].mDeviceLocal = (mMemoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+			heaps[i].mBudget = heaps[i].mSize;
+			heaps[i].mAllocatorBytes = i < stats.mHeapReservedBytes.size() ? stats.mHeapReservedBytes[i] : 0;
+			heaps[i].mUsage = heaps[i].mAllocatorBytes;
+		}
+
+		if (!mMemoryBudgetSupported) {
+			return heaps;
+		}
+
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+		budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+		memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memoryProperties.pNext = &budgetProperties;
+
+		vkGetPhysicalDeviceMemoryProperties2(mPhysicalDevice, &memoryProperties);
+
+		for (uint32_t i = 0; i < mMemoryProperties.memoryHeapCount; ++i) {
+			heaps[i].mBudget = budgetProperties.heapBudget[i];
+			heaps[i].mUsage = budgetProperties.heapUsage[i];
+		}
+
+		return heaps;
+	}
+
+	MemoryReport Device::getMemoryReport() const {
+		MemoryReport report{};
+		report.mBudgetSupported = mMemoryBudgetSupported;
+		report.mHeaps = getMemoryBudget();
+		report.mAllocator = mAllocator->getStats();
+
+		return report;
+	}
+
+
 }
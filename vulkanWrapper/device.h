@@ -3,6 +3,19 @@
 #include "../base.h"
 #include "instance.h"
 #include "windowSurface.h"
+#include "memoryAllocator.h"
+#include "frameScheduler.h"
+#include "pipelineCache.h"
+#include "pipelineStateCache.h"
+#include "pipelineCompiler.h"
+#include "pipelineManifest.h"
+#include "shaderLibrary.h"
+#include "descriptorSetLayoutCache.h"
+#include "uploadHeap.h"
+#include "memoryReport.h"
+
+
+
 
 namespace Tea::Wrapper {
 	struct QueueFamilyIndices
@@ -10,11 +23,27 @@ namespace Tea::Wrapper {
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
 
+		//only set when the device has a family besides the graphics one, otherwise the graphics queue is used
+		std::optional<uint32_t> transferFamily;
+		std::optional<uint32_t> computeFamily;
+
 		bool isComplete() {
 			return graphicsFamily.has_value() && presentFamily.has_value();
 		}
 	};
 
+
+	//VK_EXT_extended_dynamic_state entry points, null when the extension is not enabled
+	struct ExtendedDynamicStateCommands {
+		PFN_vkCmdSetCullModeEXT			mSetCullMode{ nullptr };
+		PFN_vkCmdSetFrontFaceEXT		mSetFrontFace{ nullptr };
+		PFN_vkCmdSetPrimitiveTopologyEXT	mSetPrimitiveTopology{ nullptr };
+		PFN_vkCmdSetDepthTestEnableEXT		mSetDepthTestEnable{ nullptr };
+		PFN_vkCmdSetDepthWriteEnableEXT		mSetDepthWriteEnable{ nullptr };
+		PFN_vkCmdSetDepthCompareOpEXT		mSetDepthCompareOp{ nullptr };
+	};
+
+
 	class Device {
 	public:
 		using Ptr = std::shared_ptr<Device>;
@@ -22,6 +51,7 @@ namespace Tea::Wrapper {
 			return std::make_shared<Device>(instance, surface);
 		}
 
+		//surface is nullptr for headless rendering: no present family/queue and no swapchain extension
 		Device(Instance::Ptr instance, WindowSurface::Ptr surface);
 
 		~Device();
@@ -43,12 +73,100 @@ namespace Tea::Wrapper {
 		[[nodiscard]] auto getGraphicQueueFamily() const { return mQueueFamilyIndices.graphicsFamily; }
 		[[nodiscard]] auto getPresentQueueFamily() const { return mQueueFamilyIndices.presentFamily; }
 
+		[[nodiscard]] bool isHeadless() const { return mSurface == nullptr; }
+
 		[[nodiscard]] auto getGraphicQueue() const { return mGraphicQueue; }
 		[[nodiscard]] auto getPresentQueue() const { return mPresentQueue; }
 
+		//transfer and compute fall back to the graphics family/queue on devices with a single family (e.g. lavapipe)
+		[[nodiscard]] uint32_t getTransferQueueFamily() const { return mQueueFamilyIndices.transferFamily.value_or(mQueueFamilyIndices.graphicsFamily.value()); }
+		[[nodiscard]] uint32_t getComputeQueueFamily() const { return mQueueFamilyIndices.computeFamily.value_or(mQueueFamilyIndices.graphicsFamily.value()); }
+
+		[[nodiscard]] auto getTransferQueue() const { return mTransferQueue; }
+		[[nodiscard]] auto getComputeQueue() const { return mComputeQueue; }
+
+		[[nodiscard]] bool hasDedicatedTransferQueue() const { return mQueueFamilyIndices.transferFamily.has_value(); }
+		[[nodiscard]] bool hasAsyncComputeQueue() const { return mQueueFamilyIndices.computeFamily.has_value(); }
+
+		//image copies on the transfer queue must be multiples of this (or reach the image edge), (0,0,0) means whole images only
+		[[nodiscard]] auto getTransferImageGranularity() const { return mTransferImageGranularity; }
+
+
+		//resources written by the transfer queue and read by the graphics queue are created CONCURRENT over these families,
+		//a single entry means EXCLUSIVE is enough
+		[[nodiscard]] std::vector<uint32_t> getUploadQueueFamilies() const;
+
+
+		[[nodiscard]] auto getAllocator() const { return mAllocator; }
+
+		//cached once, memory type lookups happen for every buffer and image
+		[[nodiscard]] const auto& getMemoryProperties() const { return mMemoryProperties; }
+
+		uint32_t findMemoryType(uint32_t typeFilter, MemoryUsage usage) const;
+
+		//the type must have every flag of properties
+		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+		//every queue submission goes through it, see FrameScheduler
+		[[nodiscard]] auto getFrameScheduler() const { return mFrameScheduler; }
+
+		//every pipeline is created through it, loaded from PipelineCache::DefaultPath and saved back when the device is destroyed
+		[[nodiscard]] auto getPipelineCache() const { return mPipelineCache; }
+
+		//pipelines and layouts with equal state are compiled once and shared, see Pipeline::build
+		[[nodiscard]] auto getPipelineStateCache() const { return mPipelineStateCache; }
+
+		//worker threads for Pipeline::buildAsync, created on first use
+		PipelineCompiler::Ptr getPipelineCompiler();
+
+		//descriptions of the pipelines built this run, loaded from PipelineManifest::DefaultPath for PipelineWarmup
+		//and saved back when the device is destroyed
+		[[nodiscard]] auto getPipelineManifest() const { return mPipelineManifest; }
+
+		//every Shader loads its module through it, each SPIR-V file is read once per run
+		[[nodiscard]] auto getShaderLibrary() const { return mShaderLibrary; }
+
+		//set layouts with equal bindings are shared, see ReflectedLayout
+		[[nodiscard]] auto getDescriptorSetLayoutCache() const { return mDescriptorSetLayoutCache; }
+
+		//staging ring shared by every upload, created on first use
+
+		UploadHeap::Ptr getUploadHeap();
+
+		//VK_EXT_memory_budget is enabled when the device supports it and the instance is at least Vulkan 1.1
+		[[nodiscard]] auto isMemoryBudgetSupported() const { return mMemoryBudgetSupported; }
+
+		//queried on every call, the driver numbers change with every allocation of this and other processes
+		[[nodiscard]] std::vector<MemoryHeapBudget> getMemoryBudget() const;
+
+		[[nodiscard]] MemoryReport getMemoryReport() const;
+
+		//VK_EXT_extended_dynamic_state is enabled when supported, pipelines can then leave cull mode, front face,
+		//topology and depth test state to the command buffer instead of baking them
+		[[nodiscard]] auto isExtendedDynamicStateSupported() const { return mExtendedDynamicStateSupported; }
+
+		//VK_EXT_pipeline_creation_feedback is enabled when supported, the pipeline creation log then has the
+		//driver's compile times and cache hits instead of CPU time only
+		[[nodiscard]] auto isPipelineCreationFeedbackSupported() const { return mPipelineCreationFeedbackSupported; }
+
+		[[nodiscard]] const auto& getExtendedDynamicStateCommands() const { return mExtendedDynamicStateCommands; }
+
+
+
+
 	private:
+		bool isExtensionSupported(VkPhysicalDevice device, const char* extensionName) const;
+
+		//timeline semaphores are core in Vulkan 1.2, both the instance and the device have to be at least 1.2
+		bool isTimelineSemaphoreSupported(VkPhysicalDevice device) const;
+
+		bool isExtendedDynamicStateFeatureSupported(VkPhysicalDevice device) const;
+
+		void loadExtendedDynamicStateCommands();
+
 		VkPhysicalDevice mPhysicalDevice{ VK_NULL_HANDLE };
 
+
 		VkDevice mDevice{ VK_NULL_HANDLE };
 
 		//洢ǰȾid
@@ -58,6 +176,37 @@ namespace Tea::Wrapper {
 
 		VkQueue	mGraphicQueue{ VK_NULL_HANDLE };
 		VkQueue mPresentQueue{ VK_NULL_HANDLE };
+		VkQueue mTransferQueue{ VK_NULL_HANDLE };
+		VkQueue mComputeQueue{ VK_NULL_HANDLE };
+
+		VkExtent3D mTransferImageGranularity{ 1, 1, 1 };
+
+		VkPhysicalDeviceMemoryProperties mMemoryProperties{};
+
+		bool mMemoryBudgetSupported{ false };
+
+		bool mExtendedDynamicStateSupported{ false };
+		ExtendedDynamicStateCommands mExtendedDynamicStateCommands{};
+
+		bool mPipelineCreationFeedbackSupported{ false };
+
+
+
+
+
+		//owned by the device, so they (and what they own) keep the raw VkDevice instead of a Device::Ptr,
+		//which would be a reference cycle. Destroyed in ~Device before vkDestroyDevice
+		MemoryAllocator::Ptr mAllocator{ nullptr };
+		FrameScheduler::Ptr mFrameScheduler{ nullptr };
+		PipelineCache::Ptr mPipelineCache{ nullptr };
+		PipelineStateCache::Ptr mPipelineStateCache{ nullptr };
+		PipelineCompiler::Ptr mPipelineCompiler{ nullptr };
+		PipelineManifest::Ptr mPipelineManifest{ nullptr };
+		ShaderLibrary::Ptr mShaderLibrary{ nullptr };
+		DescriptorSetLayoutCache::Ptr mDescriptorSetLayoutCache{ nullptr };
+		UploadHeap::Ptr mUploadHeap{ nullptr };
+
+
 
 		Instance::Ptr mInstance{ nullptr };
 		WindowSurface::Ptr mSurface{ nullptr };
@@ -0,0 +1,129 @@
+#include "frameScheduler.h"
+
+namespace Tea::Wrapper {
+
+	FrameScheduler::FrameScheduler(VkDevice device, const std::array<VkQueue, QueueTypeCount>& queues) {
+		mDevice = device;
+		mQueues = queues;
+
+		for (auto& timeline : mTimelines) {
+			timeline = TimelineSemaphore::create(mDevice);
+		}
+	}
+
+	FrameScheduler::~FrameScheduler() {
+		//must not throw, e.g. after a device loss at shutdown the other queues are still waited for
+		for (uint32_t i = 0; i < QueueTypeCount; ++i) {
+			auto queue = static_cast<QueueType>(i);
+			try {
+				wait(queue, getSubmittedValue(queue));
+			}
+			catch (const std::exception& e) {
+				std::cerr << e.what() << std::endl;
+			}
+		}
+	}
+
+	uint64_t FrameScheduler::submit(
+		QueueType queue,
+		const std::vector<VkCommandBuffer>& commandBuffers,
+		const std::vector<SubmitWait>& waits,
+		const std::vector<VkSemaphore>& binarySignals
+	) {
+		uint32_t queueIndex = static_cast<uint32_t>(queue);
+
+		std::vector<VkSemaphore> waitSemaphores{};
+		std::vector<uint64_t> waitValues{};
+		std::vector<VkPipelineStageFlags> waitStages{};
+		for (const auto& wait : waits) {
+			waitSemaphores.push_back(wait.mSemaphore);
+			waitValues.push_back(wait.mValue);
+			waitStages.push_back(wait.mStage);
+		}
+
+		//the timeline first, binary semaphores take a (ignored) value each as well
+		std::vector<VkSemaphore> signalSemaphores = { mTimelines[queueIndex]->getSemaphore() };
+		signalSemaphores.insert(signalSemaphores.end(), binarySignals.begin(), binarySignals.end());
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		uint64_t value = mSubmittedValues[queueIndex] + 1;
+		std::vector<uint64_t> signalValues(signalSemaphores.size(), 0);
+		signalValues[0] = value;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+		timelineInfo.pWaitSemaphoreValues = waitValues.data();
+		timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+		timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+		submitInfo.pCommandBuffers = commandBuffers.data();
+		submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+		submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+		if (vkQueueSubmit(mQueues[queueIndex], 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to submit to queue");
+		}
+
+		mSubmittedValues[queueIndex] = value;
+
+		return value;
+	}
+
+	SubmitWait FrameScheduler::makeWait(QueueType queue, uint64_t value, VkPipelineStageFlags stage) const {
+		SubmitWait wait{};
+		wait.mSemaphore = mTimelines[static_cast<uint32_t>(queue)]->getSemaphore();
+		wait.mValue = value;
+		wait.mStage = stage;
+
+		return wait;
+	}
+
+	uint64_t FrameScheduler::getCompletedValue(QueueType queue) const {
+		return mTimelines[static_cast<uint32_t>(queue)]->getValue();
+	}
+
+	uint64_t FrameScheduler::getSubmittedValue(QueueType queue) const {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		return mSubmittedValues[static_cast<uint32_t>(queue)];
+	}
+
+	bool FrameScheduler::isComplete(QueueType queue, uint64_t value) const {
+		return value == 0 || getCompletedValue(queue) >= value;
+	}
+
+	void FrameScheduler::wait(QueueType queue, uint64_t value) const {
+		if (value == 0) {
+			return;
+		}
+
+		mTimelines[static_cast<uint32_t>(queue)]->wait(value);
+	}
+
+	void FrameScheduler::waitIdle() const {
+		for (uint32_t i = 0; i < QueueTypeCount; ++i) {
+			auto queue = static_cast<QueueType>(i);
+			wait(queue, getSubmittedValue(queue));
+		}
+	}
+
+	uint32_t FrameScheduler::beginFrame() {
+		wait(QueueType::Graphics, mFrameValues[mFrameIndex]);
+
+		return mFrameIndex;
+	}
+
+	void FrameScheduler::endFrame(uint64_t graphicsValue) {
+		mFrameValues[mFrameIndex] = graphicsValue;
+		mFrameIndex = (mFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../base.h"
+#include "timelineSemaphore.h"
+
+namespace Tea::Wrapper {
+	//Every queue submission (rendering, uploads, compute) goes through the scheduler and gets the next value of
+	//its queue's timeline semaphore. "The GPU has reached value N" then says that submission and every earlier one
+	//on that queue has completed, so CPU code waits for or polls a value instead of owning a fence per submission.
+	//Each queue has its own timeline because queues complete out of order relative to each other.
+	//Submissions to another queue can wait on a value through makeWait, e.g. rendering on an upload ticket.
+
+	enum class QueueType {
+		Graphics,
+		Transfer,
+		Compute
+	};
+
+	constexpr uint32_t QueueTypeCount = 3;
+
+	//a semaphore a submission waits on before stage, mValue is ignored for binary semaphores
+	struct SubmitWait {
+		VkSemaphore				mSemaphore{ VK_NULL_HANDLE };
+		uint64_t				mValue{ 0 };
+		VkPipelineStageFlags	mStage{ VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+	};
+
+	class FrameScheduler {
+	public:
+		using Ptr = std::shared_ptr<FrameScheduler>;
+		static Ptr create(VkDevice device, const std::array<VkQueue, QueueTypeCount>& queues) {
+			return std::make_shared<FrameScheduler>(device, queues);
+		}
+
+		//queues in QueueType order, several types may share one VkQueue
+		FrameScheduler(VkDevice device, const std::array<VkQueue, QueueTypeCount>& queues);
+
+		~FrameScheduler();
+
+		//returns the timeline value the submission signals on completion.
+		//binarySignals are signaled as well, e.g. for vkQueuePresentKHR which cannot wait on a timeline
+		uint64_t submit(
+			QueueType queue,
+			const std::vector<VkCommandBuffer>& commandBuffers,
+			const std::vector<SubmitWait>& waits = {},
+			const std::vector<VkSemaphore>& binarySignals = {}
+		);
+
+		//lets a submission wait until queue has reached value
+		[[nodiscard]] SubmitWait makeWait(QueueType queue, uint64_t value, VkPipelineStageFlags stage) const;
+
+		[[nodiscard]] uint64_t getCompletedValue(QueueType queue) const;
+
+		[[nodiscard]] uint64_t getSubmittedValue(QueueType queue) const;
+
+		//value 0 is never submitted and always complete
+		[[nodiscard]] bool isComplete(QueueType queue, uint64_t value) const;
+
+		void wait(QueueType queue, uint64_t value) const;
+
+		//waits for everything submitted so far on every queue, cheaper than vkDeviceWaitIdle when work of other
+		//threads is still being recorded
+		void waitIdle() const;
+
+		//frame pacing: waits until the frame submitted MAX_FRAMES_IN_FLIGHT frames ago has completed
+		//and returns the frame slot whose per-frame resources may now be reused
+		uint32_t beginFrame();
+
+		//graphicsValue is the value of the frame's last graphics submission
+		void endFrame(uint64_t graphicsValue);
+
+		[[nodiscard]] auto getFrameIndex() const { return mFrameIndex; }
+
+		[[nodiscard]] auto getTimeline(QueueType queue) const { return mTimelines[static_cast<uint32_t>(queue)]; }
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+
+		std::array<VkQueue, QueueTypeCount> mQueues{};
+		std::array<TimelineSemaphore::Ptr, QueueTypeCount> mTimelines{};
+		std::array<uint64_t, QueueTypeCount> mSubmittedValues{};
+
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> mFrameValues{};
+		uint32_t mFrameIndex{ 0 };
+
+		//vkQueueSubmit needs the queue externally synchronized, and types may share a queue
+		mutable std::mutex mMutex;
+	};
+}
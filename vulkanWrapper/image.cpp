@@ -1,4 +1,5 @@
 #include "image.h"
+#include "uploadBatch.h"
 
 namespace Tea::Wrapper {
 	Image::Ptr Image::createDepthImage(
@@ -24,9 +25,9 @@ namespace Tea::Wrapper {
 			resultFormat,
 			VK_IMAGE_TYPE_2D,
 			VK_IMAGE_TILING_OPTIMAL,
-			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
 			VK_SAMPLE_COUNT_1_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			MemoryUsage::Transient,
 			VK_IMAGE_ASPECT_DEPTH_BIT
 		);
 	}
@@ -47,6 +48,48 @@ namespace Tea::Wrapper {
 		mWidth = width;
 		mHeight = height;
 
+		auto memRequirements = createImage(width, height, format, imageType, tiling, usage, sample);
+
+		//ڴռ
+		bindMemory(memRequirements, mDevice->findMemoryType(memRequirements.memoryTypeBits, properties), usage, tiling);
+
+		//imageview
+		createImageView(format, imageType, aspectFlags);
+	}
+
+	Image::Image(
+		const Device::Ptr& device,
+		const int& width,
+		const int& height,
+		const VkFormat& format,
+		const VkImageType& imageType,
+		const VkImageTiling& tiling,
+		const VkImageUsageFlags& usage,
+		const VkSampleCountFlagBits& sample,
+		MemoryUsage memoryUsage,
+		const VkImageAspectFlags& aspectFlags
+	) {
+		mDevice = device;
+		mLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		mWidth = width;
+		mHeight = height;
+
+		auto memRequirements = createImage(width, height, format, imageType, tiling, usage, sample);
+
+		bindMemory(memRequirements, mDevice->findMemoryType(memRequirements.memoryTypeBits, memoryUsage), usage, tiling);
+
+		createImageView(format, imageType, aspectFlags);
+	}
+
+	VkMemoryRequirements Image::createImage(
+		const int& width,
+		const int& height,
+		const VkFormat& format,
+		const VkImageType& imageType,
+		const VkImageTiling& tiling,
+		const VkImageUsageFlags& usage,
+		const VkSampleCountFlagBits& sample
+	) {
 		VkImageCreateInfo imageCreateInfo{};
 		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageCreateInfo.extent.width = width;
@@ -62,26 +105,41 @@ namespace Tea::Wrapper {
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;//image memory barrier can be used to transition image layouts and transfer queue family ownership when VK_SHARING_MODE_EXCLUSIVE is use
 
+		//uploaded on the transfer queue, sampled on the graphics queue
+		auto queueFamilies = mDevice->getUploadQueueFamilies();
+		if ((usage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && queueFamilies.size() > 1) {
+			imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			imageCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+			imageCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+		}
+
+
 		if (vkCreateImage(mDevice->getDevice(), &imageCreateInfo, nullptr, &mImage) != VK_SUCCESS) {
 			throw std::runtime_error("Error:failed to create image");
 		}
 
-		//ڴռ
 		VkMemoryRequirements memRequirements;
 		vkGetImageMemoryRequirements(mDevice->getDevice(), mImage, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+		return memRequirements;
+	}
 
-		if (vkAllocateMemory(mDevice->getDevice(), &allocInfo, nullptr, &mImageMemory) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate image memory!");
+	void Image::bindMemory(const VkMemoryRequirements& memRequirements, uint32_t memoryTypeIndex, VkImageUsageFlags usage, VkImageTiling tiling) {
+		//depth/color targets (including the swapchain depth images) are reported as attachments, sampled images as textures
+		MemoryCategory category = MemoryCategory::Other;
+		if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT)) {
+			category = MemoryCategory::Attachment;
+		}
+		else if (usage & (VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT)) {
+			category = MemoryCategory::Texture;
 		}
 
-		vkBindImageMemory(mDevice->getDevice(), mImage, mImageMemory, 0);
+		mAllocation = mDevice->getAllocator()->allocate(memRequirements, memoryTypeIndex, tiling == VK_IMAGE_TILING_LINEAR, category);
 
-		//imageview
+		vkBindImageMemory(mDevice->getDevice(), mImage, mAllocation.mMemory, mAllocation.mOffset);
+	}
+
+	void Image::createImageView(const VkFormat& format, const VkImageType& imageType, const VkImageAspectFlags& aspectFlags) {
 		VkImageViewCreateInfo imageViewCreateInfo{};
 		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		imageViewCreateInfo.viewType = imageType == VK_IMAGE_TYPE_2D ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_3D;
@@ -103,13 +161,12 @@ namespace Tea::Wrapper {
 			vkDestroyImageView(mDevice->getDevice(), mImageView, nullptr);
 		}
 
-		if (mImageMemory != VK_NULL_HANDLE) {
-			vkFreeMemory(mDevice->getDevice(), mImageMemory, nullptr);
-		}
-
 		if (mImage != VK_NULL_HANDLE) {
 			vkDestroyImage(mDevice->getDevice(), mImage, nullptr);
 		}
+
+		mDevice->getAllocator()->free(mAllocation);
+
 	}
 	void Image::setImageLayout(
 		VkImageLayout newLayout,
@@ -173,21 +230,7 @@ namespace Tea::Wrapper {
 		commandBuffer->transferImageLayout(imageMemoryBarrier, srcStageMask, dstStageMask);
 		commandBuffer->end();
 
-		commandBuffer->submitSync(mDevice->getGraphicQueue());
-	}
-
-	uint32_t Image::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-		VkPhysicalDeviceMemoryProperties memProps;
-		vkGetPhysicalDeviceMemoryProperties(mDevice->getPhysicalDevice(), &memProps);
-
-		//0x001 | 0x100 = 0x101  i = 0 iӦ;  1 << i 1   i = 1 0x010
-		for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i) {
-			if ((typeFilter & (1 << i)) && ((memProps.memoryTypes[i].propertyFlags & properties) == properties)) {
-				return i;
-			}
-		}
-
-		throw std::runtime_error("Error: cannot find the property memory type!");
+		commandBuffer->submitSync(QueueType::Graphics);
 	}
 
 	VkFormat Image::findDepthFormat(const Device::Ptr& device) {
@@ -228,20 +271,13 @@ namespace Tea::Wrapper {
 		throw std::runtime_error("Error: can not find proper format");
 	}
 
-	void Image::fillImageData(size_t size, void* pData, const CommandPool::Ptr& commandPool){
+	void Image::fillImageData(UploadBatch& uploadBatch, size_t size, void* pData){
 		assert(pData);
 		assert(size);
 
-		//create a buffer in host visible memory so that we can use vkMapMemory and copy the pixels to it.
-		auto stageBuffer = Buffer::createStageBuffer(mDevice, size, pData);
-		
-		auto commandBuffer = CommandBuffer::create(mDevice, commandPool);
-		commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-		commandBuffer->copyBufferToImage(stageBuffer->getBuffer(), mImage, mLayout, mWidth, mHeight);
-		commandBuffer->end();
-
-		commandBuffer->submitSync(mDevice->getGraphicQueue());
+		uploadBatch.uploadImage(mImage, mLayout, static_cast<uint32_t>(mWidth), static_cast<uint32_t>(mHeight), pData, size);
 	}
 
 
+
 }
\ No newline at end of file
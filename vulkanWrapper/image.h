@@ -5,7 +5,8 @@
 #include "commandBuffer.h"
 
 namespace Tea::Wrapper {
-	
+	class UploadBatch;
+
 	class Image {
 	public:
 		using Ptr = std::shared_ptr<Image>;
@@ -35,6 +36,34 @@ namespace Tea::Wrapper {
 			);
 		}
 
+		static Ptr create(
+			const Device::Ptr& device,
+			const int& width,
+			const int& height,
+			const VkFormat& format,
+			const VkImageType& imageType,
+			const VkImageTiling& tiling,
+			const VkImageUsageFlags& usage,
+			const VkSampleCountFlagBits& sample,
+			MemoryUsage memoryUsage,
+			const VkImageAspectFlags& aspectFlags
+		) {
+			return std::make_shared<Image>(
+				device,
+				width,
+				height,
+				format,
+				imageType,
+				tiling,
+				usage,
+				sample,
+				memoryUsage,
+				aspectFlags
+			);
+		}
+
+		//TRANSIENT_ATTACHMENT in lazily allocated memory where available: the depth is cleared at load and never stored,
+		//so on tilers it only lives in tile memory. One image can serve every framebuffer, see SwapChain
 		static Ptr createDepthImage(
 			const Device::Ptr& device,
 			const int& width,
@@ -54,9 +83,22 @@ namespace Tea::Wrapper {
 			const VkImageAspectFlags& aspectFlags//view
 		);
 
+		Image(
+			const Device::Ptr& device,
+			const int& width,
+			const int& height,
+			const VkFormat& format,
+			const VkImageType& imageType,
+			const VkImageTiling& tiling,
+			const VkImageUsageFlags& usage,
+			const VkSampleCountFlagBits& sample,
+			MemoryUsage memoryUsage,
+			const VkImageAspectFlags& aspectFlags
+		);
+
 		~Image();
 
-		static uint32_t Image::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
 		static VkFormat Image::findDepthFormat(const Device::Ptr& device);
 		static VkFormat Image::findSupportedFormat(const Device::Ptr& device, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 		
@@ -68,7 +110,9 @@ namespace Tea::Wrapper {
 			const CommandPool::Ptr& commandPool
 		);
 
-		void fillImageData(size_t size, void* pData, const CommandPool::Ptr& commandPool);
+		//recorded into uploadBatch, the data is in the image once its ticket has completed.
+		//The image has to be in TRANSFER_DST_OPTIMAL or GENERAL by then
+		void fillImageData(UploadBatch& uploadBatch, size_t size, void* pData);
 
 		[[nodiscard]] auto getImage() const { return mImage; }
 
@@ -81,7 +125,19 @@ namespace Tea::Wrapper {
 		[[nodiscard]] auto getImageView() const { return mImageView; }
 
 	private:
-		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+		VkMemoryRequirements createImage(
+			const int& width,
+			const int& height,
+			const VkFormat& format,
+			const VkImageType& imageType,
+			const VkImageTiling& tiling,
+			const VkImageUsageFlags& usage,
+			const VkSampleCountFlagBits& sample
+		);
+
+		void bindMemory(const VkMemoryRequirements& memRequirements, uint32_t memoryTypeIndex, VkImageUsageFlags usage, VkImageTiling tiling);
+
+		void createImageView(const VkFormat& format, const VkImageType& imageType, const VkImageAspectFlags& aspectFlags);
 
 		size_t				mWidth{ 0 };
 		size_t				mHeight{ 0 };
@@ -89,7 +145,8 @@ namespace Tea::Wrapper {
 		Device::Ptr mDevice{ nullptr };
 
 		VkImage mImage{ VK_NULL_HANDLE };
-		VkDeviceMemory	mImageMemory{ VK_NULL_HANDLE };
+		MemoryAllocation mAllocation{};
+
 		VkImageView mImageView{ VK_NULL_HANDLE };
 		VkImageLayout mLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
 	};
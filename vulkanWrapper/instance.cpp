@@ -38,8 +38,9 @@ namespace Tea::Wrapper {
         }
     }
 
-    Instance::Instance(bool enableValidationLayer) {
+    Instance::Instance(bool enableValidationLayer, bool headless) {
         mEnableValidationLayer = enableValidationLayer;
+        mHeadless = headless;
 
         if (mEnableValidationLayer && !checkValidationLayerSupport()) {
             throw std::runtime_error("validation layers requested, but not available!");
@@ -52,7 +53,17 @@ namespace Tea::Wrapper {
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "No Engine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        //1.1 brings vkGetPhysicalDeviceMemoryProperties2 (memory budget), 1.2 timeline semaphores.
+        //a 1.0 loader has no vkEnumerateInstanceVersion and rejects anything above 1.0
+        mApiVersion = VK_API_VERSION_1_0;
+        auto enumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion) vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+        if (enumerateInstanceVersion != nullptr) {
+            uint32_t loaderVersion = VK_API_VERSION_1_0;
+            enumerateInstanceVersion(&loaderVersion);
+            mApiVersion = std::min<uint32_t>(loaderVersion, VK_API_VERSION_1_2);
+        }
+        appInfo.apiVersion = mApiVersion;
+
 
         VkInstanceCreateInfo instCreateInfo = {};
         instCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -121,6 +132,10 @@ namespace Tea::Wrapper {
     }
 
     std::vector<const char *> Instance::getRequiredExtensions() {
+        if (mHeadless) {
+            return { VK_EXT_DEBUG_UTILS_EXTENSION_NAME };
+        }
+
         uint32_t glfwExtensionCount = 0;
 
         const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
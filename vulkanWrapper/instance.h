@@ -6,9 +6,10 @@ namespace Tea::Wrapper {
 	class Instance {
 	public:
 		using Ptr = std::shared_ptr<Instance>;
-		static Ptr create(bool enableValidationLayer) { return std::make_shared<Instance>(enableValidationLayer); }
+		static Ptr create(bool enableValidationLayer, bool headless = false) { return std::make_shared<Instance>(enableValidationLayer, headless); }
 
-		explicit Instance(bool enableValidationLayer);
+		//a headless instance skips the GLFW surface extensions, GLFW does not even have to be initialized
+		explicit Instance(bool enableValidationLayer, bool headless = false);
 
 		~Instance();
 
@@ -24,9 +25,16 @@ namespace Tea::Wrapper {
 
 		[[nodiscard]] bool getEnableValidationLayer() const { return mEnableValidationLayer; }
 
+		[[nodiscard]] bool isHeadless() const { return mHeadless; }
+
+		//highest version the loader supports, capped at 1.2
+		[[nodiscard]] auto getApiVersion() const { return mApiVersion; }
+
 	private:
 		VkInstance mInstance{ VK_NULL_HANDLE };
 		bool mEnableValidationLayer{ false };
+		bool mHeadless{ false };
+		uint32_t mApiVersion{ VK_API_VERSION_1_0 };
 		VkDebugUtilsMessengerEXT mDebugger{ VK_NULL_HANDLE };
 	};
 }
\ No newline at end of file
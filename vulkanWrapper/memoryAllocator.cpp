@@ -0,0 +1,496 @@
+#include "memoryAllocator.h"
+
+namespace Tea::Wrapper {
+
+	static VkDeviceSize nextPowerOfTwo(VkDeviceSize value) {
+		VkDeviceSize result = 1;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+	static VkDeviceSize previousPowerOfTwo(VkDeviceSize value) {
+		VkDeviceSize result = 1;
+		while ((result << 1) <= value) {
+			result <<= 1;
+		}
+		return result;
+	}
+
+	const char* toString(MemoryCategory category) {
+		switch (category) {
+		case MemoryCategory::Vertex:		return "vertex";
+		case MemoryCategory::Index:			return "index";
+		case MemoryCategory::Uniform:		return "uniform";
+		case MemoryCategory::Staging:		return "staging";
+		case MemoryCategory::Texture:		return "texture";
+		case MemoryCategory::Attachment:	return "attachment";
+		default:							return "other";
+		}
+	}
+
+	static uint32_t countBits(VkMemoryPropertyFlags flags) {
+		uint32_t count = 0;
+		for (; flags != 0; flags &= flags - 1) {
+			count++;
+		}
+		return count;
+	}
+
+	std::optional<uint32_t> findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeBits, MemoryUsage usage) {
+		VkMemoryPropertyFlags required{ 0 };
+		VkMemoryPropertyFlags preferred{ 0 };	//worth 2 points per flag
+		VkMemoryPropertyFlags niceToHave{ 0 };	//worth 1 point per flag
+		VkMemoryPropertyFlags unwanted{ 0 };	//costs 2 points per flag
+
+		switch (usage) {
+		case MemoryUsage::GpuOnly:
+			required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			unwanted = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+			break;
+		case MemoryUsage::CpuToGpu:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			niceToHave = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			break;
+		case MemoryUsage::CpuOnly:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			unwanted = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			break;
+		case MemoryUsage::GpuToCpu:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+			niceToHave = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			break;
+		case MemoryUsage::Transient:
+			required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			preferred = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+			unwanted = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+			break;
+		}
+
+		std::optional<uint32_t> best{};
+		int bestScore = 0;
+		VkDeviceSize bestHeapSize = 0;
+
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+			VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[i].propertyFlags;
+
+			//protected memory needs the protectedMemory feature and protected queues
+			if (!(typeBits & (1u << i)) || (flags & required) != required || (flags & VK_MEMORY_PROPERTY_PROTECTED_BIT)) {
+				continue;
+			}
+
+			int score = 2 * countBits(flags & preferred) + countBits(flags & niceToHave) - 2 * countBits(flags & unwanted);
+			VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+
+			if (!best.has_value() || score > bestScore || (score == bestScore && heapSize > bestHeapSize)) {
+				best = i;
+				bestScore = score;
+				bestHeapSize = heapSize;
+			}
+		}
+
+		return best;
+	}
+
+	std::optional<uint32_t> findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeBits, VkMemoryPropertyFlags requiredProperties) {
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+			if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & requiredProperties) == requiredProperties) {
+				return i;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	MemoryBlock::MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, bool linear) {
+		mMemory = memory;
+		mSize = size;
+		mMemoryTypeIndex = memoryTypeIndex;
+		mLinear = linear;
+
+		while (getNodeSize(mMaxOrder) < mSize) {
+			mMaxOrder++;
+		}
+
+		//at first the whole block is one free node of the biggest order
+		mFreeNodes.resize(mMaxOrder + 1);
+		mFreeNodes[mMaxOrder].insert(0);
+	}
+
+	MemoryBlock::~MemoryBlock() {}
+
+	std::optional<VkDeviceSize> MemoryBlock::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+		VkDeviceSize nodeSize = nextPowerOfTwo(std::max({ size, alignment, MinNodeSize }));
+		if (nodeSize > mSize) {
+			return std::nullopt;
+		}
+
+		uint32_t order = 0;
+		while (getNodeSize(order) < nodeSize) {
+			order++;
+		}
+
+		//find the smallest free node that is big enough
+		uint32_t freeOrder = order;
+		while (freeOrder <= mMaxOrder && mFreeNodes[freeOrder].empty()) {
+			freeOrder++;
+		}
+
+		if (freeOrder > mMaxOrder) {
+			return std::nullopt;
+		}
+
+		VkDeviceSize offset = *mFreeNodes[freeOrder].begin();
+		mFreeNodes[freeOrder].erase(mFreeNodes[freeOrder].begin());
+
+		//split it in halves until it has the requested size, the upper halves go back to the free lists
+		while (freeOrder > order) {
+			freeOrder--;
+			mFreeNodes[freeOrder].insert(offset + getNodeSize(freeOrder));
+		}
+
+		mAllocations[offset] = Node{ order, size };
+
+		return offset;
+	}
+
+	void MemoryBlock::free(VkDeviceSize offset) {
+		auto it = mAllocations.find(offset);
+		if (it == mAllocations.end()) {
+			throw std::runtime_error("Error: freeing an offset that was not allocated from this memory block");
+		}
+
+		uint32_t order = it->second.mOrder;
+		mAllocations.erase(it);
+
+		//merge with the buddy as long as the buddy is free as well
+		while (order < mMaxOrder) {
+			VkDeviceSize buddy = offset ^ getNodeSize(order);
+			auto buddyIt = mFreeNodes[order].find(buddy);
+			if (buddyIt == mFreeNodes[order].end()) {
+				break;
+			}
+
+			mFreeNodes[order].erase(buddyIt);
+			offset = std::min(offset, buddy);
+			order++;
+		}
+
+		mFreeNodes[order].insert(offset);
+	}
+
+	MemoryBlockStats MemoryBlock::getStats() const {
+		MemoryBlockStats stats{};
+		stats.mMemoryTypeIndex = mMemoryTypeIndex;
+		stats.mLinear = mLinear;
+		stats.mBlockSize = mSize;
+		stats.mAllocationCount = static_cast<uint32_t>(mAllocations.size());
+
+		for (const auto& [offset, node] : mAllocations) {
+			stats.mUsedBytes += getNodeSize(node.mOrder);
+			stats.mRequestedBytes += node.mRequestedSize;
+		}
+
+		for (uint32_t order = 0; order <= mMaxOrder; ++order) {
+			stats.mFreeRangeCount += static_cast<uint32_t>(mFreeNodes[order].size());
+			if (!mFreeNodes[order].empty()) {
+				stats.mLargestFreeRange = getNodeSize(order);
+			}
+		}
+
+		return stats;
+	}
+
+	MemoryAllocator::MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize) {
+		mDevice = device;
+
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &mMemoryProperties);
+
+		VkPhysicalDeviceProperties deviceProp;
+		vkGetPhysicalDeviceProperties(physicalDevice, &deviceProp);
+		mMaxAllocationCount = deviceProp.limits.maxMemoryAllocationCount;
+		mNonCoherentAtomSize = std::max<VkDeviceSize>(deviceProp.limits.nonCoherentAtomSize, 1);
+
+		//small heaps (e.g. the 256MB host visible device local heap) should not be eaten by a single block
+		mBlockSizes.resize(mMemoryProperties.memoryTypeCount);
+		for (uint32_t i = 0; i < mMemoryProperties.memoryTypeCount; ++i) {
+			VkDeviceSize heapSize = mMemoryProperties.memoryHeaps[mMemoryProperties.memoryTypes[i].heapIndex].size;
+			mBlockSizes[i] = std::max<VkDeviceSize>(previousPowerOfTwo(std::min(blockSize, heapSize / 8)), 1024 * 1024);
+		}
+	}
+
+	MemoryAllocator::~MemoryAllocator() {
+		for (auto& block : mBlocks) {
+			freeDeviceMemory(block->getMemory());
+		}
+		mBlocks.clear();
+
+		for (auto& [memory, dedicated] : mDedicatedAllocations) {
+			freeDeviceMemory(memory);
+		}
+		mDedicatedAllocations.clear();
+	}
+
+	VkDeviceMemory MemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex) {
+		if (mMaxAllocationCount != 0 && mDeviceMemoryCount >= mMaxAllocationCount) {
+			throw std::runtime_error("Error: maxMemoryAllocationCount reached");
+		}
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory memory{ VK_NULL_HANDLE };
+		mAllocateMemoryCalls++;
+		if (vkAllocateMemory(mDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+			return VK_NULL_HANDLE;
+		}
+
+		mDeviceMemoryCount++;
+		return memory;
+	}
+
+	void MemoryAllocator::freeDeviceMemory(VkDeviceMemory memory) {
+		vkFreeMemory(mDevice, memory, nullptr);
+		mDeviceMemoryCount--;
+	}
+
+	MemoryAllocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool linear, MemoryCategory category) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		MemoryAllocation allocation{};
+		allocation.mMemoryTypeIndex = memoryTypeIndex;
+		allocation.mSize = requirements.size;
+		allocation.mCategory = category;
+
+		//counted only once memory was actually handed out, allocateDeviceMemory may throw on the way
+		auto succeeded = [this, &allocation]() {
+			mCategoryBytes[static_cast<uint32_t>(allocation.mCategory)] += allocation.mSize;
+			mCategoryCounts[static_cast<uint32_t>(allocation.mCategory)]++;
+			return allocation;
+		};
+
+		VkDeviceSize blockSize = mBlockSizes[memoryTypeIndex];
+
+		//big resources (render targets, large textures) get their own VkDeviceMemory, buddy rounding would waste too much of a block.
+		//lazily allocated memory is only committed per VkDeviceMemory on tilers, so transient attachments never share a block
+		bool lazilyAllocated = (mMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+		if (requirements.size <= blockSize / 2 && !lazilyAllocated) {
+			for (auto& block : mBlocks) {
+				if (block->getMemoryTypeIndex() != memoryTypeIndex || block->isLinear() != linear) {
+					continue;
+				}
+
+				auto offset = block->allocate(requirements.size, requirements.alignment);
+				if (offset.has_value()) {
+					allocation.mMemory = block->getMemory();
+					allocation.mOffset = offset.value();
+					allocation.mBlock = block.get();
+					return succeeded();
+				}
+			}
+
+			VkDeviceMemory memory = allocateDeviceMemory(blockSize, memoryTypeIndex);
+			if (memory != VK_NULL_HANDLE) {
+				mBlocks.push_back(std::make_unique<MemoryBlock>(memory, blockSize, memoryTypeIndex, linear));
+
+				auto& block = mBlocks.back();
+				allocation.mMemory = memory;
+				allocation.mOffset = block->allocate(requirements.size, requirements.alignment).value();
+				allocation.mBlock = block.get();
+				return succeeded();
+			}
+			//not enough room for a whole new block, try to fit the resource alone
+		}
+
+		VkDeviceMemory memory = allocateDeviceMemory(requirements.size, memoryTypeIndex);
+		if (memory == VK_NULL_HANDLE) {
+			throw std::runtime_error("Error: failed to allocate device memory");
+		}
+
+		DedicatedAllocation dedicated{};
+		dedicated.mMemoryTypeIndex = memoryTypeIndex;
+		dedicated.mLinear = linear;
+		dedicated.mSize = requirements.size;
+		mDedicatedAllocations[memory] = dedicated;
+
+		allocation.mMemory = memory;
+		allocation.mOffset = 0;
+		allocation.mBlock = nullptr;
+		return succeeded();
+	}
+
+	void MemoryAllocator::free(MemoryAllocation& allocation) {
+		if (!allocation.isValid()) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mCategoryBytes[static_cast<uint32_t>(allocation.mCategory)] -= allocation.mSize;
+		mCategoryCounts[static_cast<uint32_t>(allocation.mCategory)]--;
+
+		if (allocation.mBlock == nullptr) {
+			auto it = mDedicatedAllocations.find(allocation.mMemory);
+			if (it != mDedicatedAllocations.end()) {
+				if (it->second.mMappedData != nullptr) {
+					vkUnmapMemory(mDevice, allocation.mMemory);
+				}
+				mDedicatedAllocations.erase(it);
+				freeDeviceMemory(allocation.mMemory);
+			}
+		}
+		else {
+			MemoryBlock* block = allocation.mBlock;
+			block->free(allocation.mOffset);
+
+			//keep one empty block per pool around, so a create/destroy loop does not hit vkAllocateMemory every time
+			if (block->isEmpty() && block->mMapCount == 0) {
+				auto sameKind = std::count_if(mBlocks.begin(), mBlocks.end(), [block](const std::unique_ptr<MemoryBlock>& other) {
+					return other->getMemoryTypeIndex() == block->getMemoryTypeIndex() && other->isLinear() == block->isLinear();
+				});
+
+				if (sameKind > 1) {
+					if (block->mMappedData != nullptr) {
+						vkUnmapMemory(mDevice, block->getMemory());
+					}
+					freeDeviceMemory(block->getMemory());
+					mBlocks.erase(std::find_if(mBlocks.begin(), mBlocks.end(), [block](const std::unique_ptr<MemoryBlock>& other) {
+						return other.get() == block;
+					}));
+				}
+			}
+		}
+
+		allocation = MemoryAllocation{};
+	}
+
+	void* MemoryAllocator::map(const MemoryAllocation& allocation) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		void** mappedData{ nullptr };
+		uint32_t* mapCount{ nullptr };
+
+		if (allocation.mBlock != nullptr) {
+			mappedData = &allocation.mBlock->mMappedData;
+			mapCount = &allocation.mBlock->mMapCount;
+		}
+		else {
+			auto& dedicated = mDedicatedAllocations.at(allocation.mMemory);
+			mappedData = &dedicated.mMappedData;
+			mapCount = &dedicated.mMapCount;
+		}
+
+		if (*mappedData == nullptr) {
+			if (vkMapMemory(mDevice, allocation.mMemory, 0, VK_WHOLE_SIZE, 0, mappedData) != VK_SUCCESS) {
+				throw std::runtime_error("Error: failed to map memory");
+			}
+		}
+		(*mapCount)++;
+
+		return static_cast<uint8_t*>(*mappedData) + allocation.mOffset;
+	}
+
+	void MemoryAllocator::unmap(const MemoryAllocation& allocation) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		void** mappedData{ nullptr };
+		uint32_t* mapCount{ nullptr };
+
+		if (allocation.mBlock != nullptr) {
+			mappedData = &allocation.mBlock->mMappedData;
+			mapCount = &allocation.mBlock->mMapCount;
+		}
+		else {
+			auto& dedicated = mDedicatedAllocations.at(allocation.mMemory);
+			mappedData = &dedicated.mMappedData;
+			mapCount = &dedicated.mMapCount;
+		}
+
+		if (*mapCount == 0) {
+			return;
+		}
+
+		(*mapCount)--;
+		if (*mapCount == 0) {
+			vkUnmapMemory(mDevice, allocation.mMemory);
+			*mappedData = nullptr;
+		}
+	}
+
+	bool MemoryAllocator::isHostCoherent(const MemoryAllocation& allocation) const {
+		return (mMemoryProperties.memoryTypes[allocation.mMemoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+	}
+
+	void MemoryAllocator::flush(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) {
+		if (!allocation.isValid() || isHostCoherent(allocation)) {
+			return;
+		}
+
+		VkDeviceSize memorySize{ 0 };
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			memorySize = allocation.mBlock != nullptr ? allocation.mBlock->getSize() : mDedicatedAllocations.at(allocation.mMemory).mSize;
+		}
+
+		VkDeviceSize begin = allocation.mOffset + offset;
+		VkDeviceSize end = size == VK_WHOLE_SIZE ? allocation.mOffset + allocation.mSize : begin + size;
+
+		//the flushed range has to start and end on nonCoherentAtomSize, or reach the end of the VkDeviceMemory
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = allocation.mMemory;
+		range.offset = begin / mNonCoherentAtomSize * mNonCoherentAtomSize;
+
+		VkDeviceSize alignedEnd = (end + mNonCoherentAtomSize - 1) / mNonCoherentAtomSize * mNonCoherentAtomSize;
+		range.size = alignedEnd >= memorySize ? VK_WHOLE_SIZE : alignedEnd - range.offset;
+
+		if (vkFlushMappedMemoryRanges(mDevice, 1, &range) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to flush mapped memory");
+		}
+	}
+
+	MemoryAllocatorStats MemoryAllocator::getStats() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		MemoryAllocatorStats stats{};
+		stats.mDeviceMemoryCount = mDeviceMemoryCount;
+		stats.mAllocateMemoryCalls = mAllocateMemoryCalls;
+		stats.mCategoryBytes = mCategoryBytes;
+		stats.mCategoryCounts = mCategoryCounts;
+		stats.mHeapReservedBytes.resize(mMemoryProperties.memoryHeapCount, 0);
+
+		for (const auto& block : mBlocks) {
+			auto blockStats = block->getStats();
+			stats.mAllocationCount += blockStats.mAllocationCount;
+			stats.mReservedBytes += blockStats.mBlockSize;
+			stats.mUsedBytes += blockStats.mUsedBytes;
+			stats.mHeapReservedBytes[mMemoryProperties.memoryTypes[blockStats.mMemoryTypeIndex].heapIndex] += blockStats.mBlockSize;
+			stats.mBlocks.push_back(blockStats);
+		}
+
+		for (const auto& [memory, dedicated] : mDedicatedAllocations) {
+			MemoryBlockStats blockStats{};
+			blockStats.mMemoryTypeIndex = dedicated.mMemoryTypeIndex;
+			blockStats.mLinear = dedicated.mLinear;
+			blockStats.mDedicated = true;
+			blockStats.mBlockSize = dedicated.mSize;
+			blockStats.mUsedBytes = dedicated.mSize;
+			blockStats.mRequestedBytes = dedicated.mSize;
+			blockStats.mAllocationCount = 1;
+
+			stats.mAllocationCount += 1;
+			stats.mReservedBytes += dedicated.mSize;
+			stats.mUsedBytes += dedicated.mSize;
+			stats.mHeapReservedBytes[mMemoryProperties.memoryTypes[dedicated.mMemoryTypeIndex].heapIndex] += dedicated.mSize;
+			stats.mBlocks.push_back(blockStats);
+		}
+
+		return stats;
+	}
+}
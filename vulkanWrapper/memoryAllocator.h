@@ -0,0 +1,208 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//Every vkAllocateMemory is a driver round-trip and the number of live VkDeviceMemory objects is capped by maxMemoryAllocationCount (often 4096),
+	//so Buffer and Image do not own a VkDeviceMemory each. Instead we allocate large blocks per memory type and hand out sub-ranges of them.
+	//Each block is managed as a buddy system: the block size is a power of two, a request is rounded up to the next power of two,
+	//and a node of size 2^k always starts at a multiple of 2^k, so any power-of-two alignment up to the node size comes for free.
+
+	class MemoryBlock;
+
+	//what an allocation is used for, only for reporting (Device::getMemoryReport)
+	enum class MemoryCategory : uint32_t {
+		Vertex,
+		Index,
+		Uniform,
+		Staging,
+		Texture,
+		Attachment,
+		Other,
+		Count
+	};
+
+	constexpr uint32_t MemoryCategoryCount = static_cast<uint32_t>(MemoryCategory::Count);
+
+	const char* toString(MemoryCategory category);
+
+	struct MemoryAllocation {
+		VkDeviceMemory	mMemory{ VK_NULL_HANDLE };
+		VkDeviceSize	mOffset{ 0 };
+		VkDeviceSize	mSize{ 0 };
+		uint32_t		mMemoryTypeIndex{ 0 };
+		MemoryCategory	mCategory{ MemoryCategory::Other };
+
+		//nullptr means the allocation owns mMemory on its own (dedicated allocation)
+		MemoryBlock*	mBlock{ nullptr };
+
+		[[nodiscard]] bool isValid() const { return mMemory != VK_NULL_HANDLE; }
+	};
+
+	struct MemoryBlockStats {
+		uint32_t		mMemoryTypeIndex{ 0 };
+		bool			mLinear{ true };
+		bool			mDedicated{ false };
+
+		VkDeviceSize	mBlockSize{ 0 };
+		VkDeviceSize	mUsedBytes{ 0 };
+		VkDeviceSize	mRequestedBytes{ 0 };
+		VkDeviceSize	mLargestFreeRange{ 0 };
+
+		uint32_t		mAllocationCount{ 0 };
+		uint32_t		mFreeRangeCount{ 0 };
+
+		//0 means all free space is one contiguous range, close to 1 means free space is scattered into small holes
+		[[nodiscard]] float getFragmentation() const {
+			VkDeviceSize freeBytes = mBlockSize - mUsedBytes;
+			return freeBytes == 0 ? 0.0f : 1.0f - static_cast<float>(mLargestFreeRange) / static_cast<float>(freeBytes);
+		}
+	};
+
+	struct MemoryAllocatorStats {
+		std::vector<MemoryBlockStats> mBlocks{};
+
+		uint32_t		mDeviceMemoryCount{ 0 };	//live VkDeviceMemory objects
+		uint64_t		mAllocateMemoryCalls{ 0 };	//vkAllocateMemory calls since startup
+		uint64_t		mAllocationCount{ 0 };		//live sub-allocations, including dedicated ones
+
+		VkDeviceSize	mReservedBytes{ 0 };
+		VkDeviceSize	mUsedBytes{ 0 };
+
+		//requested bytes and live allocations per MemoryCategory
+		std::array<VkDeviceSize, MemoryCategoryCount>	mCategoryBytes{};
+		std::array<uint32_t, MemoryCategoryCount>		mCategoryCounts{};
+
+		//VkDeviceMemory bytes per memory heap, what the driver budget is compared against
+		std::vector<VkDeviceSize> mHeapReservedBytes{};
+	};
+
+	//where a resource should be placed, resolved to a memory type by findMemoryTypeIndex
+	enum class MemoryUsage {
+		GpuOnly,	//filled through staging and only read by the GPU: DEVICE_LOCAL, avoiding host visible types so the small ReBAR heap stays free
+		CpuToGpu,	//rewritten by the CPU every frame (uniforms): HOST_VISIBLE, preferably DEVICE_LOCAL (ReBAR) so the GPU reads it at VRAM speed
+		CpuOnly,	//staging memory: HOST_VISIBLE, preferably coherent system memory
+		GpuToCpu,	//read back by the CPU: HOST_VISIBLE, preferably HOST_CACHED
+		Transient	//attachments that never leave the tile: LAZILY_ALLOCATED where it exists, DEVICE_LOCAL otherwise
+	};
+
+	//scores every allowed memory type by the required/preferred/unwanted flags of usage, ties go to the bigger heap
+	std::optional<uint32_t> findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeBits, MemoryUsage usage);
+
+	//first allowed memory type that has all of requiredProperties
+	std::optional<uint32_t> findMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeBits, VkMemoryPropertyFlags requiredProperties);
+
+	class MemoryBlock {
+	public:
+		MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex, bool linear);
+
+		~MemoryBlock();
+
+		std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+		void free(VkDeviceSize offset);
+
+		[[nodiscard]] bool isEmpty() const { return mAllocations.empty(); }
+
+		[[nodiscard]] MemoryBlockStats getStats() const;
+
+		[[nodiscard]] auto getMemory() const { return mMemory; }
+
+		[[nodiscard]] auto getMemoryTypeIndex() const { return mMemoryTypeIndex; }
+
+		[[nodiscard]] auto isLinear() const { return mLinear; }
+
+		[[nodiscard]] auto getSize() const { return mSize; }
+
+		//host mapping of the whole block, shared by every allocation inside it
+		void*			mMappedData{ nullptr };
+		uint32_t		mMapCount{ 0 };
+
+	private:
+		[[nodiscard]] VkDeviceSize getNodeSize(uint32_t order) const { return MinNodeSize << order; }
+
+		static constexpr VkDeviceSize MinNodeSize = 256;
+
+		VkDeviceMemory	mMemory{ VK_NULL_HANDLE };
+		VkDeviceSize	mSize{ 0 };
+		uint32_t		mMemoryTypeIndex{ 0 };
+		bool			mLinear{ true };
+		uint32_t		mMaxOrder{ 0 };
+
+		//mFreeNodes[k] holds the offsets of the free nodes with size MinNodeSize << k
+		std::vector<std::set<VkDeviceSize>> mFreeNodes{};
+
+		struct Node {
+			uint32_t		mOrder{ 0 };
+			VkDeviceSize	mRequestedSize{ 0 };
+		};
+		std::map<VkDeviceSize, Node> mAllocations{};
+	};
+
+	//created and owned by Device, Buffer and Image allocate through Device::getAllocator()
+	class MemoryAllocator {
+	public:
+		using Ptr = std::shared_ptr<MemoryAllocator>;
+		static Ptr create(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize = DefaultBlockSize) {
+			return std::make_shared<MemoryAllocator>(physicalDevice, device, blockSize);
+		}
+
+		MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize = DefaultBlockSize);
+
+		~MemoryAllocator();
+
+		//linear: buffers and linear images, !linear: optimal tiling images. They never share a block so bufferImageGranularity cannot be violated
+		MemoryAllocation allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool linear, MemoryCategory category = MemoryCategory::Other);
+
+		void free(MemoryAllocation& allocation);
+
+		//map/unmap are reference counted per VkDeviceMemory, because one block can only be mapped once at a time
+		void* map(const MemoryAllocation& allocation);
+
+		void unmap(const MemoryAllocation& allocation);
+
+		//make host writes visible to the device, a no-op on HOST_COHERENT memory types.
+		//offset and size are relative to the allocation and get widened to nonCoherentAtomSize
+		void flush(const MemoryAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+		[[nodiscard]] bool isHostCoherent(const MemoryAllocation& allocation) const;
+
+		[[nodiscard]] MemoryAllocatorStats getStats() const;
+
+		[[nodiscard]] const auto& getMemoryProperties() const { return mMemoryProperties; }
+
+		static constexpr VkDeviceSize DefaultBlockSize = 64ull * 1024 * 1024;
+
+	private:
+		VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex);
+
+		void freeDeviceMemory(VkDeviceMemory memory);
+
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		VkPhysicalDeviceMemoryProperties mMemoryProperties{};
+		uint32_t mMaxAllocationCount{ 0 };
+		VkDeviceSize mNonCoherentAtomSize{ 1 };
+
+		//per memory type block size, a power of two no bigger than 1/8 of the heap
+		std::vector<VkDeviceSize> mBlockSizes{};
+
+		std::vector<std::unique_ptr<MemoryBlock>> mBlocks{};
+
+		struct DedicatedAllocation {
+			uint32_t		mMemoryTypeIndex{ 0 };
+			bool			mLinear{ true };
+			VkDeviceSize	mSize{ 0 };
+			void*			mMappedData{ nullptr };
+			uint32_t		mMapCount{ 0 };
+		};
+		std::map<VkDeviceMemory, DedicatedAllocation> mDedicatedAllocations{};
+
+		uint32_t mDeviceMemoryCount{ 0 };
+		uint64_t mAllocateMemoryCalls{ 0 };
+
+		std::array<VkDeviceSize, MemoryCategoryCount> mCategoryBytes{};
+		std::array<uint32_t, MemoryCategoryCount> mCategoryCounts{};
+
+		mutable std::mutex mMutex;
+	};
+}
@@ -0,0 +1,52 @@
+#include "memoryReport.h"
+
+namespace Tea::Wrapper {
+
+	std::string MemoryReport::toJson() const {
+		std::ostringstream json;
+
+		json << "{\n";
+		json << "  \"budgetSupported\": " << (mBudgetSupported ? "true" : "false") << ",\n";
+
+		json << "  \"heaps\": [\n";
+		for (size_t i = 0; i < mHeaps.size(); ++i) {
+			const auto& heap = mHeaps[i];
+			json << "    { \"index\": " << i
+				<< ", \"deviceLocal\": " << (heap.mDeviceLocal ? "true" : "false")
+				<< ", \"size\": " << heap.mSize
+				<< ", \"budget\": " << heap.mBudget
+				<< ", \"usage\": " << heap.mUsage
+				<< ", \"allocatorBytes\": " << heap.mAllocatorBytes
+				<< " }" << (i + 1 < mHeaps.size() ? "," : "") << "\n";
+		}
+		json << "  ],\n";
+
+		json << "  \"categories\": {\n";
+		for (uint32_t i = 0; i < MemoryCategoryCount; ++i) {
+			json << "    \"" << toString(static_cast<MemoryCategory>(i)) << "\": { \"bytes\": " << mAllocator.mCategoryBytes[i]
+				<< ", \"count\": " << mAllocator.mCategoryCounts[i]
+				<< " }" << (i + 1 < MemoryCategoryCount ? "," : "") << "\n";
+		}
+		json << "  },\n";
+
+		json << "  \"allocator\": { \"deviceMemoryCount\": " << mAllocator.mDeviceMemoryCount
+			<< ", \"allocateMemoryCalls\": " << mAllocator.mAllocateMemoryCalls
+			<< ", \"allocationCount\": " << mAllocator.mAllocationCount
+			<< ", \"reservedBytes\": " << mAllocator.mReservedBytes
+			<< ", \"usedBytes\": " << mAllocator.mUsedBytes
+			<< " }\n";
+
+		json << "}\n";
+
+		return json.str();
+	}
+
+	void MemoryReport::writeJson(const std::string& path) const {
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file) {
+			throw std::runtime_error("Error: failed to open memory report file " + path);
+		}
+
+		file << toJson();
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../base.h"
+#include "memoryAllocator.h"
+
+namespace Tea::Wrapper {
+	//A snapshot of device memory usage: what the driver reports per heap (VK_EXT_memory_budget)
+	//next to what MemoryAllocator has reserved and which categories of resources it went to.
+	//Taken with Device::getMemoryReport(), cheap enough to be logged every few seconds to spot leaks.
+
+	struct MemoryHeapBudget {
+		VkDeviceSize	mSize{ 0 };
+		bool			mDeviceLocal{ false };
+
+		//without VK_EXT_memory_budget mBudget is the heap size and mUsage only counts this allocator
+		VkDeviceSize	mBudget{ 0 };
+		VkDeviceSize	mUsage{ 0 };
+
+		//VkDeviceMemory reserved by MemoryAllocator in this heap
+		VkDeviceSize	mAllocatorBytes{ 0 };
+	};
+
+	struct MemoryReport {
+		bool							mBudgetSupported{ false };
+		std::vector<MemoryHeapBudget>	mHeaps{};
+		MemoryAllocatorStats			mAllocator{};
+
+		[[nodiscard]] std::string toJson() const;
+
+		//throws if the file cannot be written
+		void writeJson(const std::string& path) const;
+	};
+}
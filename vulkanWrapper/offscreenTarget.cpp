@@ -0,0 +1,55 @@
+#include "offscreenTarget.h"
+
+namespace Tea::Wrapper {
+
+	OffscreenTarget::OffscreenTarget(const Device::Ptr& device, uint32_t width, uint32_t height, uint32_t imageCount, VkFormat format) {
+		mDevice = device;
+		mFormat = format;
+		mExtent = { width, height };
+		mImageCount = imageCount;
+
+		mColorImages.resize(mImageCount);
+		for (uint32_t i = 0; i < mImageCount; ++i) {
+			mColorImages[i] = Image::create(
+				mDevice,
+				width, height,
+				mFormat,
+				VK_IMAGE_TYPE_2D,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+				VK_SAMPLE_COUNT_1_BIT,
+				MemoryUsage::GpuOnly,
+				VK_IMAGE_ASPECT_COLOR_BIT
+			);
+		}
+
+		//the render pass starts from UNDEFINED, no layout transition is needed up front
+		mDepthImage = Image::createDepthImage(mDevice, width, height);
+	}
+
+	OffscreenTarget::~OffscreenTarget() {
+		for (auto& frameBuffer : mFrameBuffers) {
+			vkDestroyFramebuffer(mDevice->getDevice(), frameBuffer, nullptr);
+		}
+	}
+
+	void OffscreenTarget::createFrameBuffers(const RenderPass::Ptr& renderPass) {
+		mFrameBuffers.resize(mImageCount);
+		for (uint32_t i = 0; i < mImageCount; ++i) {
+			std::array<VkImageView, 2> attachments{ mColorImages[i]->getImageView(), mDepthImage->getImageView() };
+
+			VkFramebufferCreateInfo frameBufferCreateInfo{};
+			frameBufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			frameBufferCreateInfo.renderPass = renderPass->getRenderPass();
+			frameBufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+			frameBufferCreateInfo.pAttachments = attachments.data();
+			frameBufferCreateInfo.width = mExtent.width;
+			frameBufferCreateInfo.height = mExtent.height;
+			frameBufferCreateInfo.layers = 1;
+
+			if (vkCreateFramebuffer(mDevice->getDevice(), &frameBufferCreateInfo, nullptr, &mFrameBuffers[i]) != VK_SUCCESS) {
+				throw std::runtime_error("Error:Failed to create offscreen frameBuffer");
+			}
+		}
+	}
+}
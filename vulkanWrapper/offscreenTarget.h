@@ -0,0 +1,52 @@
+#pragma once
+#include "../base.h"
+#include "device.h"
+#include "image.h"
+#include "renderPass.h"
+
+namespace Tea::Wrapper {
+	//The headless counterpart of SwapChain: imageCount color images plus one shared depth image and a framebuffer per color image,
+	//rendered with the same RenderPass and Pipeline. Nothing is presented, the color images end in TRANSFER_SRC_OPTIMAL
+	//so they can be read back or copied.
+
+	class OffscreenTarget {
+	public:
+		using Ptr = std::shared_ptr<OffscreenTarget>;
+		static Ptr create(const Device::Ptr& device, uint32_t width, uint32_t height, uint32_t imageCount, VkFormat format = DefaultFormat) {
+			return std::make_shared<OffscreenTarget>(device, width, height, imageCount, format);
+		}
+
+		OffscreenTarget(const Device::Ptr& device, uint32_t width, uint32_t height, uint32_t imageCount, VkFormat format = DefaultFormat);
+
+		~OffscreenTarget();
+
+		void createFrameBuffers(const RenderPass::Ptr& renderPass);
+
+		[[nodiscard]] auto getFormat() const { return mFormat; }
+
+		[[nodiscard]] auto getImageCount() const { return mImageCount; }
+
+		[[nodiscard]] auto getFrameBuffer(const int index) const { return mFrameBuffers[index]; }
+
+		[[nodiscard]] auto getColorImage(const int index) const { return mColorImages[index]; }
+
+		[[nodiscard]] auto getExtent() const { return mExtent; }
+
+		//color attachment support for this format is mandatory
+		static constexpr VkFormat DefaultFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+	private:
+		VkFormat mFormat{ DefaultFormat };
+		VkExtent2D mExtent{ 0, 0 };
+		uint32_t mImageCount{ 0 };
+
+		std::vector<Image::Ptr> mColorImages{};
+
+		//shared like the swapchain depth image
+		Image::Ptr mDepthImage{ nullptr };
+
+		std::vector<VkFramebuffer> mFrameBuffers{};
+
+		Device::Ptr mDevice{ nullptr };
+	};
+}
@@ -1,6 +1,30 @@
 #include "pipeline.h"
 
 namespace Tea::Wrapper {
+
+	namespace {
+		//the states VK_EXT_extended_dynamic_state adds, everything else in VkDynamicState is core 1.0
+		bool isExtendedDynamicState(VkDynamicState state) {
+			switch (state) {
+			case VK_DYNAMIC_STATE_CULL_MODE_EXT:
+			case VK_DYNAMIC_STATE_FRONT_FACE_EXT:
+			case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT:
+			case VK_DYNAMIC_STATE_VIEWPORT_WITH_COUNT_EXT:
+			case VK_DYNAMIC_STATE_SCISSOR_WITH_COUNT_EXT:
+			case VK_DYNAMIC_STATE_VERTEX_INPUT_BINDING_STRIDE_EXT:
+			case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT:
+			case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT:
+			case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT:
+			case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT:
+			case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT:
+			case VK_DYNAMIC_STATE_STENCIL_OP_EXT:
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
+
 	Pipeline::Pipeline(const Device::Ptr& device, const RenderPass::Ptr& renderPass) {
 		mDevice = device;
 		mRenderPass = renderPass;
@@ -16,12 +40,8 @@ namespace Tea::Wrapper {
 	}
 
 	Pipeline::~Pipeline() {
-		if (mLayout != VK_NULL_HANDLE) {
-			vkDestroyPipelineLayout(mDevice->getDevice(), mLayout, nullptr);
-		}
-
-		if (mPipeline != VK_NULL_HANDLE) {
-			vkDestroyPipeline(mDevice->getDevice(), mPipeline, nullptr);
+		if (mPendingPipeline.valid()) {
+			mPendingPipeline.wait();
 		}
 	}
 
@@ -29,48 +49,254 @@ namespace Tea::Wrapper {
 		mShaders = shaderGroup;
 	}
 
+	void Pipeline::setDescriptorSetLayouts(const std::vector<DescriptorSetLayout::Ptr>& setLayouts) {
+		mSetLayouts = setLayouts;
+
+		mSetLayoutHandles.clear();
+		for (const auto& setLayout : mSetLayouts) {
+			mSetLayoutHandles.push_back(setLayout->getLayout());
+		}
+
+		mLayoutState.setLayoutCount = static_cast<uint32_t>(mSetLayoutHandles.size());
+		mLayoutState.pSetLayouts = mSetLayoutHandles.data();
+	}
+
+	void Pipeline::setPushConstantRanges(const std::vector<VkPushConstantRange>& ranges) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+
+		//at least 128 bytes on every device, enough for a model matrix and a few indices
+		VkShaderStageFlags usedStages = 0;
+		for (const auto& range : ranges) {
+			if (range.size == 0 || range.offset % 4 != 0 || range.size % 4 != 0 || range.offset + range.size > properties.limits.maxPushConstantsSize) {
+				throw std::runtime_error("Error: push constant range [" + std::to_string(range.offset) + ", " + std::to_string(range.offset + range.size)
+					+ ") does not fit the device limit of " + std::to_string(properties.limits.maxPushConstantsSize) + " bytes");
+			}
+
+			//a stage may appear in one range only, a stage reading several blocks needs one range covering them
+			if ((range.stageFlags & usedStages) != 0) {
+				throw std::runtime_error("Error: push constant ranges share shader stages " + std::to_string(range.stageFlags & usedStages));
+			}
+			usedStages |= range.stageFlags;
+		}
+
+		mPushConstantRanges = ranges;
+
+		mLayoutState.pushConstantRangeCount = static_cast<uint32_t>(mPushConstantRanges.size());
+		mLayoutState.pPushConstantRanges = mPushConstantRanges.empty() ? nullptr : mPushConstantRanges.data();
+	}
+
+	void Pipeline::setReflectedLayout(const ReflectedLayout::Ptr& layout) {
+		mReflectedLayout = layout;
+
+		setDescriptorSetLayouts(mReflectedLayout->getSetLayouts());
+		setPushConstantRanges(mReflectedLayout->getPushConstantRanges());
+	}
+
+	bool Pipeline::isDynamicState(VkDynamicState state) const {
+		return std::find(mDynamicStates.begin(), mDynamicStates.end(), state) != mDynamicStates.end();
+	}
+
 	void Pipeline::build() {
+		auto state = makeBuildState();
+
+		//pipeline cacheԽݴ뻺棬ڶpipelineʹ,ҲԴ浽ļͬs
+		//compiled through the device's cache, which is saved to disk at shutdown (see PipelineCache)
+		mPipeline = mDevice->getPipelineStateCache()->getPipeline(state->mCreateInfo, state->mIdentity);
+		mPendingPipeline = {};
+	}
+
+	void Pipeline::buildAsync() {
+		auto state = makeBuildState();
+		auto stateCache = mDevice->getPipelineStateCache();
+
+		//the job only touches the snapshot, this Pipeline may be changed or destroyed while it runs
+		auto job = std::make_shared<std::packaged_task<SharedPipeline::Ptr()>>([state, stateCache]() {
+			return stateCache->getPipeline(state->mCreateInfo, state->mIdentity);
+		});
+
+		mPipeline.reset();
+		mPendingPipeline = job->get_future().share();
+
+		mDevice->getPipelineCompiler()->submit([job]() { (*job)(); });
+	}
+
+	bool Pipeline::isReady() const {
+		if (mPipeline != nullptr) {
+			return true;
+		}
+
+		return mPendingPipeline.valid() && mPendingPipeline.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	void Pipeline::wait() {
+		if (mPipeline == nullptr && mPendingPipeline.valid()) {
+			mPipeline = mPendingPipeline.get();
+			mPendingPipeline = {};
+		}
+	}
+
+	VkPipeline Pipeline::getPipeline() const {
+		if (mPipeline != nullptr) {
+			return mPipeline->getPipeline();
+		}
+
+		//get() rethrows a failed compile
+		if (isReady()) {
+			return mPendingPipeline.get()->getPipeline();
+		}
+
+		return mFallback != nullptr ? mFallback->getPipeline() : VK_NULL_HANDLE;
+	}
+
+	void Pipeline::checkDynamicStates() const {
+		if (mDevice->isExtendedDynamicStateSupported()) {
+			return;
+		}
+
+		for (auto state : mDynamicStates) {
+			if (isExtendedDynamicState(state)) {
+				throw std::runtime_error("Error: dynamic state " + std::to_string(state) + " requires VK_EXT_extended_dynamic_state");
+			}
+		}
+	}
+
+	std::shared_ptr<Pipeline::BuildState> Pipeline::makeBuildState() {
+		//build and buildAsync both come through here
+		checkDynamicStates();
+
+		//the create info points into the snapshot only, never into this Pipeline or the caller's arrays
+		auto state = std::make_shared<BuildState>();
+
 		//shader
-		std::vector<VkPipelineShaderStageCreateInfo> shaderCreateInfos{};
+		//reserved, the create infos point into these
+		state->mEntryPoints.reserve(mShaders.size());
+		state->mSpecializationConstants.reserve(mShaders.size());
+		state->mSpecializations.reserve(mShaders.size());
 		for (const auto& shader : mShaders) {
+			//the module only keeps the raw device handle, unlike the Shader
+			state->mModules.push_back(shader->getSharedModule());
+			state->mEntryPoints.push_back(shader->getShaderEntryPoint());
+
 			VkPipelineShaderStageCreateInfo shaderCreateInfo{};
 			shaderCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 			shaderCreateInfo.stage = shader->getShaderStage();
-			shaderCreateInfo.pName = shader->getShaderEntryPoint().c_str();
+			shaderCreateInfo.pName = state->mEntryPoints.back().c_str();
 			shaderCreateInfo.module = shader->getShaderModule();
 
-			shaderCreateInfos.push_back(shaderCreateInfo);
+			//the variant is part of the pipeline key, see PipelineStateCache::makePipelineKey
+			if (!shader->getSpecialization().empty()) {
+				state->mSpecializationConstants.push_back(shader->getSpecialization());
+				state->mSpecializations.push_back(state->mSpecializationConstants.back().getInfo());
+				shaderCreateInfo.pSpecializationInfo = &state->mSpecializations.back();
+			}
+
+			state->mStages.push_back(shaderCreateInfo);
+			state->mIdentity.mStageCodeHashes.push_back(shader->getCodeHash());
+			state->mIdentity.mLabel += (state->mIdentity.mLabel.empty() ? "" : " + ") + shader->getFileName();
+			if (!shader->getSpecialization().empty()) {
+				state->mIdentity.mLabel += " [" + shader->getSpecialization().toString() + "]";
+			}
 		}
+
+		state->mVertexBindings.assign(mVertexInputState.pVertexBindingDescriptions, mVertexInputState.pVertexBindingDescriptions + mVertexInputState.vertexBindingDescriptionCount);
+		state->mVertexAttributes.assign(mVertexInputState.pVertexAttributeDescriptions, mVertexInputState.pVertexAttributeDescriptions + mVertexInputState.vertexAttributeDescriptionCount);
+		state->mVertexInputState = mVertexInputState;
+		state->mVertexInputState.pVertexBindingDescriptions = state->mVertexBindings.data();
+		state->mVertexInputState.pVertexAttributeDescriptions = state->mVertexAttributes.data();
+
+		state->mAssemblyState = mAssemblyState;
+
 		//ӿڼ
-		mViewportState.viewportCount = static_cast<uint32_t>(mViewports.size());
-		mViewportState.pViewports = mViewports.data();
-		mViewportState.scissorCount = static_cast<uint32_t>(mScissors.size());
-		mViewportState.pScissors = mScissors.data();
+		state->mViewports = mViewports;
+		state->mScissors = mScissors;
+		state->mViewportState = mViewportState;
+		state->mViewportState.viewportCount = static_cast<uint32_t>(state->mViewports.size());
+		state->mViewportState.pViewports = state->mViewports.data();
+		state->mViewportState.scissorCount = static_cast<uint32_t>(state->mScissors.size());
+		state->mViewportState.pScissors = state->mScissors.data();
+
+		//dynamic viewports/scissors only need their count, the values come from the command buffer
+		if (isDynamicState(VK_DYNAMIC_STATE_VIEWPORT)) {
+			state->mViewportState.viewportCount = std::max(state->mViewportState.viewportCount, 1u);
+			state->mViewportState.pViewports = nullptr;
+		}
+		if (isDynamicState(VK_DYNAMIC_STATE_SCISSOR)) {
+			state->mViewportState.scissorCount = std::max(state->mViewportState.scissorCount, 1u);
+			state->mViewportState.pScissors = nullptr;
+		}
 
-		mBlendState.attachmentCount = static_cast<uint32_t>(mBlendAttachmentStates.size());
-		mBlendState.pAttachments = mBlendAttachmentStates.data();
+		state->mRasterState = mRasterState;
 
-		if (mLayout != VK_NULL_HANDLE) {
-			vkDestroyPipelineLayout(mDevice->getDevice(), mLayout, nullptr);
+		state->mSampleState = mSampleState;
+		if (mSampleState.pSampleMask != nullptr) {
+			uint32_t maskWords = (static_cast<uint32_t>(mSampleState.rasterizationSamples) + 31) / 32;
+			state->mSampleMask.assign(mSampleState.pSampleMask, mSampleState.pSampleMask + maskWords);
+			state->mSampleState.pSampleMask = state->mSampleMask.data();
 		}
-		if (vkCreatePipelineLayout(mDevice->getDevice(), &mLayoutState, nullptr, &mLayout) != VK_SUCCESS) {
-			throw std::runtime_error("Error: failed to create pipeline layout");
+
+		state->mBlendAttachmentStates = mBlendAttachmentStates;
+		state->mBlendState = mBlendState;
+		state->mBlendState.attachmentCount = static_cast<uint32_t>(state->mBlendAttachmentStates.size());
+		state->mBlendState.pAttachments = state->mBlendAttachmentStates.data();
+
+		state->mDepthStencilState = mDepthStencilState;
+
+		state->mDynamicStates = mDynamicStates;
+		state->mDynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		state->mDynamicState.dynamicStateCount = static_cast<uint32_t>(state->mDynamicStates.size());
+		state->mDynamicState.pDynamicStates = state->mDynamicStates.data();
+
+		//layouts are cheap, created right away so getLayout works before the pipeline is ready
+		mLayout = mDevice->getPipelineStateCache()->getLayout(mLayoutState);
+		state->mLayout = mLayout;
+
+		state->mIdentity.mLayout = mLayout;
+		state->mIdentity.mRenderPassHash = mRenderPass->getDescriptionHash();
+
+		//known set layouts let equal layouts from other objects match, e.g. the ones PipelineWarmup creates
+		auto description = describe();
+		if (description.has_value()) {
+			StateKey layoutKey{};
+			layoutKey.add(mLayoutState.flags);
+			layoutKey.add(description->mSetLayouts.size());
+			for (const auto& setLayout : description->mSetLayouts) {
+				layoutKey.add(setLayout.size());
+				for (const auto& binding : setLayout) {
+					layoutKey.add(binding.binding);
+					layoutKey.add(binding.descriptorType);
+					layoutKey.add(binding.descriptorCount);
+					layoutKey.add(binding.stageFlags);
+				}
+			}
+			layoutKey.add(description->mPushConstantRanges.size());
+			for (const auto& range : description->mPushConstantRanges) {
+				layoutKey.add(range.stageFlags);
+				layoutKey.add(range.offset);
+				layoutKey.add(range.size);
+			}
+			state->mIdentity.mLayoutHash = layoutKey.getHash();
+
+			if (mRecorded) {
+				mDevice->getPipelineManifest()->record(description.value());
+			}
 		}
 
-		VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+		auto& pipelineCreateInfo = state->mCreateInfo;
 		pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
-		pipelineCreateInfo.stageCount = static_cast<uint32_t>(shaderCreateInfos.size());
-		pipelineCreateInfo.pStages = shaderCreateInfos.data();
-
-		pipelineCreateInfo.pVertexInputState = &mVertexInputState;
-		pipelineCreateInfo.pInputAssemblyState = &mAssemblyState;
-		pipelineCreateInfo.pViewportState = &mViewportState;
-		pipelineCreateInfo.pRasterizationState = &mRasterState;
-		pipelineCreateInfo.pMultisampleState = &mSampleState;
-		pipelineCreateInfo.pDepthStencilState = &mDepthStencilState;	//TODO: add depth and stencil
-		pipelineCreateInfo.pColorBlendState = &mBlendState;
-		pipelineCreateInfo.layout = mLayout;
+		pipelineCreateInfo.stageCount = static_cast<uint32_t>(state->mStages.size());
+		pipelineCreateInfo.pStages = state->mStages.data();
+
+		pipelineCreateInfo.pVertexInputState = &state->mVertexInputState;
+		pipelineCreateInfo.pInputAssemblyState = &state->mAssemblyState;
+		pipelineCreateInfo.pViewportState = &state->mViewportState;
+		pipelineCreateInfo.pRasterizationState = &state->mRasterState;
+		pipelineCreateInfo.pMultisampleState = &state->mSampleState;
+		pipelineCreateInfo.pDepthStencilState = &state->mDepthStencilState;	//TODO: add depth and stencil
+		pipelineCreateInfo.pColorBlendState = &state->mBlendState;
+		pipelineCreateInfo.pDynamicState = state->mDynamicStates.empty() ? nullptr : &state->mDynamicState;
+		pipelineCreateInfo.layout = mLayout->getLayout();
 		pipelineCreateInfo.renderPass = mRenderPass->getRenderPass(); //TODO : add render pass
 		pipelineCreateInfo.subpass = 0;
 
@@ -78,13 +304,64 @@ namespace Tea::Wrapper {
 		pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 		pipelineCreateInfo.basePipelineIndex = -1;
 
-		if (mPipeline != VK_NULL_HANDLE) {
-			vkDestroyPipeline(mDevice->getDevice(), mPipeline, nullptr);
+		return state;
+	}
+
+	std::optional<PipelineDescription> Pipeline::describe() const {
+		//the raw handles may have been replaced after setDescriptorSetLayouts
+		if (mLayoutState.setLayoutCount != mSetLayoutHandles.size()
+			|| (mLayoutState.setLayoutCount > 0 && mLayoutState.pSetLayouts != mSetLayoutHandles.data())) {
+			return std::nullopt;
 		}
 
-		//pipeline cacheԽݴ뻺棬ڶpipelineʹ,ҲԴ浽ļͬs
-		if (vkCreateGraphicsPipelines(mDevice->getDevice(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &mPipeline) != VK_SUCCESS) {
-			throw std::runtime_error("Error:failed to create pipeline");
+		PipelineDescription description{};
+
+		for (const auto& shader : mShaders) {
+			ShaderStageDescription stage{};
+			stage.mFileName = shader->getFileName();
+			stage.mEntryPoint = shader->getShaderEntryPoint();
+			stage.mStage = shader->getShaderStage();
+			stage.mCodeHash = shader->getCodeHash();
+			stage.mSpecialization = shader->getSpecialization();
+
+			description.mStages.push_back(stage);
 		}
+
+		description.mVertexBindings.assign(mVertexInputState.pVertexBindingDescriptions, mVertexInputState.pVertexBindingDescriptions + mVertexInputState.vertexBindingDescriptionCount);
+		description.mVertexAttributes.assign(mVertexInputState.pVertexAttributeDescriptions, mVertexInputState.pVertexAttributeDescriptions + mVertexInputState.vertexAttributeDescriptionCount);
+
+		description.mAssemblyState = mAssemblyState;
+		description.mRasterState = mRasterState;
+		description.mSampleState = mSampleState;
+		description.mDepthStencilState = mDepthStencilState;
+		description.mBlendState = mBlendState;
+
+		description.mViewports = mViewports;
+		description.mScissors = mScissors;
+		if (mSampleState.pSampleMask != nullptr) {
+			uint32_t maskWords = (static_cast<uint32_t>(mSampleState.rasterizationSamples) + 31) / 32;
+			description.mSampleMask.assign(mSampleState.pSampleMask, mSampleState.pSampleMask + maskWords);
+		}
+		description.mBlendAttachments = mBlendAttachmentStates;
+		description.mDynamicStates = mDynamicStates;
+
+		for (const auto& setLayout : mSetLayouts) {
+			description.mSetLayouts.push_back(setLayout->getBindings());
+		}
+		description.mPushConstantRanges.assign(mLayoutState.pPushConstantRanges, mLayoutState.pPushConstantRanges + mLayoutState.pushConstantRangeCount);
+
+		description.mAttachments = mRenderPass->getAttachments();
+		for (const auto& subPass : mRenderPass->getSubPasses()) {
+			SubPassDescription subPassDescription{};
+			subPassDescription.mColorAttachments = subPass.getColorAttachmentReferences();
+			subPassDescription.mInputAttachments = subPass.getInputAttachmentReferences();
+			subPassDescription.mDepthStencilAttachment = subPass.getDepthStencilAttachmentReference();
+
+			description.mSubPasses.push_back(subPassDescription);
+		}
+		description.mDependencies = mRenderPass->getDependencies();
+		description.mSubPass = 0;
+
+		return description;
 	}
 }
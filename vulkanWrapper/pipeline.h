@@ -4,6 +4,8 @@
 #include "device.h"
 #include "shader.h"
 #include "renderPass.h"
+#include "descriptorSetLayout.h"
+#include "reflectedLayout.h"
 
 namespace Tea::Wrapper {
 
@@ -16,17 +18,63 @@ namespace Tea::Wrapper {
 
 		Pipeline(const Device::Ptr& device, const RenderPass::Ptr& renderPass);
 
+		//waits for a compile buildAsync started, the render pass it uses stays alive through this Pipeline
 		~Pipeline();
 
+		//the layout and pipeline come from the device's PipelineStateCache, a Pipeline with the same state as
+		//a live one shares its VkPipeline instead of compiling again
 		void build();
+
+		//like build, but the pipeline is compiled on the device's PipelineCompiler. The state is copied right away,
+		//so the arrays the create infos point to may go out of scope after the call. The layout is ready at once
+		void buildAsync();
+
+		//false while buildAsync is still compiling
+		[[nodiscard]] bool isReady() const;
+
+		//blocks until buildAsync has finished, rethrows if the compile failed
+		void wait();
+
+		//bound instead of this pipeline until buildAsync has finished, it must use a compatible layout and render pass.
+		//Without a fallback getPipeline returns VK_NULL_HANDLE meanwhile and the draws should be skipped
+		void setFallback(const Ptr& fallback) { mFallback = fallback; }
 		
 		//pass at application
 		void setShaderGroup(const std::vector<Shader::Ptr>& shaderGroup);
 
+		//fills mLayoutState's set layouts. Preferred over setting the raw handles: only then the pipeline can be
+		//matched by content and recorded in the device's PipelineManifest for the warm-up of the next run
+		void setDescriptorSetLayouts(const std::vector<DescriptorSetLayout::Ptr>& setLayouts);
+
+		//fills mLayoutState's push constant ranges, throws if they exceed the device's maxPushConstantsSize
+		//or two of them share a stage
+		void setPushConstantRanges(const std::vector<VkPushConstantRange>& ranges);
+
+		//appends a range of sizeof(T) bytes at offset, fed with CommandBuffer::pushConstants<T>
+		template<typename T>
+		void addPushConstantRange(VkShaderStageFlags stages, uint32_t offset = 0) {
+			auto ranges = mPushConstantRanges;
+			ranges.push_back({ stages, offset, static_cast<uint32_t>(sizeof(T)) });
+			setPushConstantRanges(ranges);
+		}
+
+		//set layouts and push constant ranges as the shaders declare them, instead of filling mLayoutState by hand
+		void setReflectedLayout(const ReflectedLayout::Ptr& layout);
+
+		//false for pipelines that should not end up in the manifest, e.g. the ones PipelineWarmup builds
+		void setRecorded(bool recorded) { mRecorded = recorded; }
+
 		void setViewports(const std::vector<VkViewport>& viewports) { mViewports = viewports; }
 
 		void setScissors(const std::vector<VkRect2D>& scissors) { mScissors = scissors; }
 
+		//states listed here are not baked but set while recording (CommandBuffer::setViewport etc.), so e.g. a resize
+		//does not need a new pipeline. Dynamic viewports/scissors still take their count from setViewports/setScissors (at least 1).
+		//cull mode, front face, topology and depth test state need Device::isExtendedDynamicStateSupported
+		void setDynamicStates(const std::vector<VkDynamicState>& dynamicStates) { mDynamicStates = dynamicStates; }
+
+		[[nodiscard]] bool isDynamicState(VkDynamicState state) const;
+
 		void pushBlendAttachment(const VkPipelineColorBlendAttachmentState& blendAttachment) {
 			mBlendAttachmentStates.push_back(blendAttachment);
 		}
@@ -41,16 +89,72 @@ namespace Tea::Wrapper {
 		VkPipelineDepthStencilStateCreateInfo mDepthStencilState{};
 		VkPipelineLayoutCreateInfo mLayoutState{};
 
-		[[nodiscard]] auto getPipeline() const { return mPipeline; }
-		[[nodiscard]] auto getLayout() const { return mLayout; }
+		[[nodiscard]] VkPipeline getPipeline() const;
+		[[nodiscard]] VkPipelineLayout getLayout() const { return mLayout != nullptr ? mLayout->getLayout() : VK_NULL_HANDLE; }
 	private:
-		VkPipeline mPipeline{ VK_NULL_HANDLE };
-		VkPipelineLayout mLayout{ VK_NULL_HANDLE };
+		//everything a vkCreateGraphicsPipelines call reads, the create info only points into the snapshot itself.
+		//Nothing in it owns the Device: the snapshot may be destroyed on a compiler thread, where the last
+		//Device reference would join that very thread. The render pass is kept by the Pipeline instead
+		struct BuildState {
+			std::vector<ShaderModule::Ptr> mModules{};
+			std::vector<std::string> mEntryPoints{};
+			std::vector<SpecializationConstants> mSpecializationConstants{};
+			std::vector<VkPipelineShaderStageCreateInfo> mStages{};
+			std::vector<VkSpecializationInfo> mSpecializations{};	//point into mSpecializationConstants, which do not change
+			PipelineIdentity mIdentity{};
+
+			std::vector<VkVertexInputBindingDescription> mVertexBindings{};
+			std::vector<VkVertexInputAttributeDescription> mVertexAttributes{};
+			VkPipelineVertexInputStateCreateInfo mVertexInputState{};
+			VkPipelineInputAssemblyStateCreateInfo mAssemblyState{};
+
+			std::vector<VkViewport> mViewports{};
+			std::vector<VkRect2D> mScissors{};
+			VkPipelineViewportStateCreateInfo mViewportState{};
+
+			VkPipelineRasterizationStateCreateInfo mRasterState{};
+			std::vector<VkSampleMask> mSampleMask{};
+			VkPipelineMultisampleStateCreateInfo mSampleState{};
+			std::vector<VkPipelineColorBlendAttachmentState> mBlendAttachmentStates{};
+			VkPipelineColorBlendStateCreateInfo mBlendState{};
+			VkPipelineDepthStencilStateCreateInfo mDepthStencilState{};
+
+			std::vector<VkDynamicState> mDynamicStates{};
+			VkPipelineDynamicStateCreateInfo mDynamicState{};
+
+			SharedPipelineLayout::Ptr mLayout{ nullptr };
+
+			VkGraphicsPipelineCreateInfo mCreateInfo{};
+		};
+
+		//throws for states that need VK_EXT_extended_dynamic_state on a device without it
+		void checkDynamicStates() const;
+
+		//also creates the layout and records the description in the manifest
+		std::shared_ptr<BuildState> makeBuildState();
+
+		//empty if the set layouts were passed as raw handles
+		[[nodiscard]] std::optional<PipelineDescription> describe() const;
+
+	private:
+		SharedPipeline::Ptr mPipeline{ nullptr };
+		SharedPipelineLayout::Ptr mLayout{ nullptr };
+
+		//set by buildAsync until wait() moves the result into mPipeline
+		std::shared_future<SharedPipeline::Ptr> mPendingPipeline{};
+		Ptr mFallback{ nullptr };
 		Device::Ptr mDevice;
 		RenderPass::Ptr mRenderPass;
 
 		std::vector<Shader::Ptr> mShaders{};
 		std::vector<VkViewport> mViewports{};
 		std::vector<VkRect2D> mScissors{};
+		std::vector<VkDynamicState> mDynamicStates{};
+
+		std::vector<DescriptorSetLayout::Ptr> mSetLayouts{};
+		std::vector<VkDescriptorSetLayout> mSetLayoutHandles{};
+		std::vector<VkPushConstantRange> mPushConstantRanges{};
+		ReflectedLayout::Ptr mReflectedLayout{ nullptr };
+		bool mRecorded{ true };
 	};
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "pipelineCache.h"
+#include <filesystem>
+
+namespace Tea::Wrapper {
+
+	PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path) {
+		mDevice = device;
+		mPath = path;
+
+		vkGetPhysicalDeviceProperties(physicalDevice, &mDeviceProperties);
+
+		auto data = loadData();
+		mLoadedSize = data.size();
+
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+		if (vkCreatePipelineCache(mDevice, &createInfo, nullptr, &mPipelineCache) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create pipeline cache");
+		}
+	}
+
+	PipelineCache::~PipelineCache() {
+		if (mPipelineCache != VK_NULL_HANDLE) {
+			vkDestroyPipelineCache(mDevice, mPipelineCache, nullptr);
+		}
+	}
+
+	bool PipelineCache::save() const {
+		size_t size = 0;
+		if (vkGetPipelineCacheData(mDevice, mPipelineCache, &size, nullptr) != VK_SUCCESS) {
+			return false;
+		}
+
+		std::vector<uint8_t> data(size);
+		if (size > 0 && vkGetPipelineCacheData(mDevice, mPipelineCache, &size, data.data()) != VK_SUCCESS) {
+			return false;
+		}
+		data.resize(size);
+
+		auto header = makeHeader();
+		header.mDataSize = data.size();
+		header.mChecksum = checksum(data.data(), data.size());
+
+		//written next to the cache and renamed over it, rename replaces the old file in one step
+		std::string tempPath = mPath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file) {
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			file.flush();
+
+			if (!file) {
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, mPath, error);
+		if (error) {
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	uint64_t PipelineCache::checksum(const uint8_t* data, size_t size) {
+		//FNV-1a, only meant to catch truncated or damaged files
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	PipelineCache::FileHeader PipelineCache::makeHeader() const {
+		FileHeader header{};
+		header.mMagic = Magic;
+		header.mVersion = Version;
+		header.mVendorID = mDeviceProperties.vendorID;
+		header.mDeviceID = mDeviceProperties.deviceID;
+		header.mDriverVersion = mDeviceProperties.driverVersion;
+		std::memcpy(header.mCacheUUID, mDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+		return header;
+	}
+
+	std::vector<uint8_t> PipelineCache::loadData() const {
+		std::ifstream file(mPath, std::ios::ate | std::ios::binary | std::ios::in);
+		if (!file) {
+			return {};
+		}
+
+		auto fileSize = static_cast<size_t>(file.tellg());
+		if (fileSize < sizeof(FileHeader)) {
+			return {};
+		}
+		file.seekg(0);
+
+		FileHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		auto expected = makeHeader();
+		if (!file || header.mMagic != expected.mMagic || header.mVersion != expected.mVersion
+			|| header.mVendorID != expected.mVendorID || header.mDeviceID != expected.mDeviceID
+			|| header.mDriverVersion != expected.mDriverVersion
+			|| std::memcmp(header.mCacheUUID, expected.mCacheUUID, VK_UUID_SIZE) != 0
+			|| header.mDataSize != fileSize - sizeof(FileHeader)) {
+			std::cerr << "Pipeline cache " << mPath << " is stale or damaged, starting with an empty cache" << std::endl;
+			return {};
+		}
+
+		std::vector<uint8_t> data(static_cast<size_t>(header.mDataSize));
+		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		if (!file || checksum(data.data(), data.size()) != header.mChecksum || !isDataValid(data)) {
+			std::cerr << "Pipeline cache " << mPath << " is stale or damaged, starting with an empty cache" << std::endl;
+			return {};
+		}
+
+		return data;
+	}
+
+	bool PipelineCache::isDataValid(const std::vector<uint8_t>& data) const {
+		//VkPipelineCacheHeaderVersionOne: headerSize, headerVersion, vendorID, deviceID, pipelineCacheUUID
+		constexpr size_t vulkanHeaderSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+		if (data.size() < vulkanHeaderSize) {
+			return false;
+		}
+
+		uint32_t fields[4]{};
+		std::memcpy(fields, data.data(), sizeof(fields));
+
+		return fields[0] >= vulkanHeaderSize
+			&& fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& fields[2] == mDeviceProperties.vendorID
+			&& fields[3] == mDeviceProperties.deviceID
+			&& std::memcmp(data.data() + sizeof(fields), mDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+}
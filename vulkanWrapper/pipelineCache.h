@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//A VkPipelineCache that survives restarts: the blob saved by the last run is loaded at startup, so the driver
+	//can skip compiling pipelines it has seen before. A blob from another GPU, driver version or a truncated/corrupt
+	//file is ignored and the cache starts empty. Saving writes a temporary file and renames it over the old one,
+	//so a crash while saving never leaves a half written cache behind.
+
+	class PipelineCache {
+	public:
+		using Ptr = std::shared_ptr<PipelineCache>;
+		static Ptr create(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path) {
+			return std::make_shared<PipelineCache>(device, physicalDevice, path);
+		}
+
+		//relative to the working directory, like the shaders
+		static constexpr const char* DefaultPath = "pipeline_cache.bin";
+
+		PipelineCache(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path);
+
+		~PipelineCache();
+
+		//writes the current cache to path, false if the data could not be read or the file not be written
+		bool save() const;
+
+		[[nodiscard]] auto getPipelineCache() const { return mPipelineCache; }
+
+		//bytes of the blob accepted at startup, 0 if there was no valid cache file
+		[[nodiscard]] auto getLoadedSize() const { return mLoadedSize; }
+
+	private:
+		//prepended to the driver's blob, the driver version is not part of the Vulkan cache header
+		struct FileHeader {
+			uint32_t	mMagic{ 0 };
+			uint32_t	mVersion{ 0 };
+			uint32_t	mVendorID{ 0 };
+			uint32_t	mDeviceID{ 0 };
+			uint32_t	mDriverVersion{ 0 };
+			uint8_t		mCacheUUID[VK_UUID_SIZE]{};
+			uint64_t	mDataSize{ 0 };
+			uint64_t	mChecksum{ 0 };
+		};
+
+		static constexpr uint32_t Magic = 0x43505454;	//"TTPC"
+		static constexpr uint32_t Version = 1;
+
+		static uint64_t checksum(const uint8_t* data, size_t size);
+
+		[[nodiscard]] FileHeader makeHeader() const;
+
+		//the blob of the file at mPath if both its header and the Vulkan cache header match this device, empty otherwise
+		[[nodiscard]] std::vector<uint8_t> loadData() const;
+
+		[[nodiscard]] bool isDataValid(const std::vector<uint8_t>& data) const;
+
+	private:
+		VkPipelineCache mPipelineCache{ VK_NULL_HANDLE };
+		VkDevice mDevice{ VK_NULL_HANDLE };
+
+		VkPhysicalDeviceProperties mDeviceProperties{};
+
+		std::string mPath{};
+		size_t mLoadedSize{ 0 };
+	};
+}
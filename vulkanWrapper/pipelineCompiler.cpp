@@ -0,0 +1,75 @@
+#include "pipelineCompiler.h"
+
+namespace Tea::Wrapper {
+
+	PipelineCompiler::PipelineCompiler(uint32_t threadCount) {
+		if (threadCount == 0) {
+			uint32_t cores = std::thread::hardware_concurrency();
+			threadCount = cores > 1 ? cores - 1 : 1;
+		}
+
+		for (uint32_t i = 0; i < threadCount; ++i) {
+			mThreads.emplace_back(&PipelineCompiler::workerLoop, this);
+		}
+	}
+
+	PipelineCompiler::~PipelineCompiler() {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStopping = true;
+		}
+		mJobAvailable.notify_all();
+
+		for (auto& thread : mThreads) {
+			thread.join();
+		}
+	}
+
+	void PipelineCompiler::submit(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJobs.push_back(std::move(job));
+		}
+		mJobAvailable.notify_one();
+	}
+
+	void PipelineCompiler::waitIdle() {
+		std::unique_lock<std::mutex> lock(mMutex);
+		mIdle.wait(lock, [this] { return mJobs.empty() && mRunningJobs == 0; });
+	}
+
+	size_t PipelineCompiler::getPendingCount() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mJobs.size() + mRunningJobs;
+	}
+
+	void PipelineCompiler::workerLoop() {
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mJobAvailable.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+
+				//queued jobs still run when stopping, their results may be waited on
+				if (mJobs.empty()) {
+					return;
+				}
+
+				job = std::move(mJobs.front());
+				mJobs.pop_front();
+				mRunningJobs++;
+			}
+
+			//jobs report failures through their own future, see Pipeline::buildAsync
+			job();
+
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mRunningJobs--;
+				if (mJobs.empty() && mRunningJobs == 0) {
+					mIdle.notify_all();
+				}
+			}
+		}
+	}
+}
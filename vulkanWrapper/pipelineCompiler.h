@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//Worker threads that compile pipelines in the background, see Pipeline::buildAsync.
+	//vkCreateGraphicsPipelines and VkPipelineCache are thread safe, so the workers share the device's cache.
+	//Jobs run in submission order as workers become free, the destructor finishes every queued job first.
+
+	class PipelineCompiler {
+	public:
+		using Ptr = std::shared_ptr<PipelineCompiler>;
+		static Ptr create(uint32_t threadCount = 0) {
+			return std::make_shared<PipelineCompiler>(threadCount);
+		}
+
+		//threadCount 0: one thread per core except the one recording frames, at least one
+		explicit PipelineCompiler(uint32_t threadCount = 0);
+
+		~PipelineCompiler();
+
+		void submit(std::function<void()> job);
+
+		//blocks until every job submitted so far has finished
+		void waitIdle();
+
+		[[nodiscard]] auto getThreadCount() const { return static_cast<uint32_t>(mThreads.size()); }
+
+		//queued and running jobs
+		[[nodiscard]] size_t getPendingCount() const;
+
+	private:
+		void workerLoop();
+
+	private:
+		std::vector<std::thread> mThreads{};
+		std::deque<std::function<void()>> mJobs{};
+		size_t mRunningJobs{ 0 };
+		bool mStopping{ false };
+
+		mutable std::mutex mMutex;
+		std::condition_variable mJobAvailable;
+		std::condition_variable mIdle;
+	};
+}
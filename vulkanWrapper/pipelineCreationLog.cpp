@@ -0,0 +1,124 @@
+#include "pipelineCreationLog.h"
+
+namespace Tea::Wrapper {
+
+	namespace {
+		//labels are file paths, which contain backslashes on windows
+		std::string escapeJson(const std::string& text) {
+			std::string escaped{};
+			for (char c : text) {
+				if (c == '"' || c == '\\') {
+					escaped.push_back('\\');
+				}
+				escaped.push_back(c);
+			}
+			return escaped;
+		}
+	}
+
+	void PipelineCreationLog::add(const PipelineCreationRecord& record) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mTotals.mRequests++;
+		if (record.mShared) {
+			mTotals.mShared++;
+		}
+		else {
+			mTotals.mCreated++;
+			mTotals.mCreateMs += record.mCpuMs;
+			mTotals.mWithFeedback += record.mFeedbackValid ? 1 : 0;
+			mTotals.mCacheHits += record.mFeedbackValid && record.mCacheHit ? 1 : 0;
+		}
+
+		mRecords.push_back(record);
+		if (mRecords.size() > MaxRecords) {
+			mRecords.pop_front();
+		}
+	}
+
+	std::vector<PipelineCreationRecord> PipelineCreationLog::getRecords() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return { mRecords.begin(), mRecords.end() };
+	}
+
+	PipelineCreationTotals PipelineCreationLog::getTotals() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mTotals;
+	}
+
+	std::vector<PipelineCreationRecord> PipelineCreationLog::getSlowest(size_t count) const {
+		std::vector<PipelineCreationRecord> created{};
+		for (const auto& record : getRecords()) {
+			if (!record.mShared) {
+				created.push_back(record);
+			}
+		}
+
+		std::sort(created.begin(), created.end(), [](const PipelineCreationRecord& a, const PipelineCreationRecord& b) {
+			return a.mCpuMs > b.mCpuMs;
+		});
+
+		if (created.size() > count) {
+			created.resize(count);
+		}
+
+		return created;
+	}
+
+	void PipelineCreationLog::clear() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRecords.clear();
+		mTotals = {};
+	}
+
+	std::string PipelineCreationLog::toJson() const {
+		std::vector<PipelineCreationRecord> records{};
+		PipelineCreationTotals totals{};
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			records.assign(mRecords.begin(), mRecords.end());
+			totals = mTotals;
+		}
+
+		std::ostringstream json;
+
+		json << "{\n";
+		json << "    \"requests\": " << totals.mRequests
+			<< ", \"created\": " << totals.mCreated
+			<< ", \"shared\": " << totals.mShared
+			<< ", \"createMs\": " << totals.mCreateMs
+			<< ", \"withFeedback\": " << totals.mWithFeedback
+			<< ", \"cacheHits\": " << totals.mCacheHits
+			<< ", \"droppedRecords\": " << totals.mRequests - records.size() << ",\n";
+
+		json << "    \"records\": [\n";
+		for (size_t i = 0; i < records.size(); ++i) {
+			const auto& record = records[i];
+			json << "      { \"key\": \"" << std::hex << record.mKeyHash << std::dec
+				<< "\", \"label\": \"" << escapeJson(record.mLabel)
+				<< "\", \"shared\": " << (record.mShared ? "true" : "false")
+				<< ", \"cpuMs\": " << record.mCpuMs;
+
+			if (record.mFeedbackValid) {
+				json << ", \"driverMs\": " << record.mDriverMs
+					<< ", \"cacheHit\": " << (record.mCacheHit ? "true" : "false")
+					<< ", \"stages\": [";
+				for (size_t stage = 0; stage < record.mStages.size(); ++stage) {
+					const auto& stageRecord = record.mStages[stage];
+					json << (stage > 0 ? ", " : "") << "{ \"stage\": " << static_cast<uint32_t>(stageRecord.mStage);
+					if (stageRecord.mValid) {
+						json << ", \"ms\": " << stageRecord.mMs << ", \"cacheHit\": " << (stageRecord.mCacheHit ? "true" : "false");
+					}
+					json << " }";
+				}
+				json << "]";
+			}
+
+			json << " }" << (i + 1 < records.size() ? "," : "") << "\n";
+		}
+		json << "    ]\n";
+		json << "  }";
+
+		return json.str();
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//How long every pipeline took to create and whether it came from a cache, to find the variants behind
+	//startup time and hitches. With VK_EXT_pipeline_creation_feedback the driver reports the duration per pipeline
+	//and per stage and whether VkPipelineCache had it, otherwise only the CPU time of the call is known.
+	//Filled by PipelineStateCache, read through Device::getPipelineStateCache()->getCreationLog().
+
+	struct PipelineStageCreationRecord {
+		VkShaderStageFlagBits	mStage{ VK_SHADER_STAGE_VERTEX_BIT };
+		bool					mValid{ false };		//false: the driver reported nothing for this stage
+		double					mMs{ 0.0 };
+		bool					mCacheHit{ false };
+	};
+
+	struct PipelineCreationRecord {
+		uint64_t	mKeyHash{ 0 };		//PipelineStateCache key, equal for requests of the same state
+		std::string	mLabel{};			//e.g. the shader files, see PipelineIdentity::mLabel
+
+		//true: another Pipeline already had this state, nothing was created
+		bool		mShared{ false };
+
+		double		mCpuMs{ 0.0 };		//wall clock of the request, including waiting for another thread's compile
+
+		//driver feedback, mFeedbackValid false without the extension or if the driver did not fill it in
+		bool		mFeedbackValid{ false };
+		double		mDriverMs{ 0.0 };
+		bool		mCacheHit{ false };	//found in VkPipelineCache
+		std::vector<PipelineStageCreationRecord> mStages{};
+	};
+
+	//running over every request, also the ones no longer kept as records
+	struct PipelineCreationTotals {
+		uint64_t	mRequests{ 0 };
+		uint64_t	mCreated{ 0 };
+		uint64_t	mShared{ 0 };
+		double		mCreateMs{ 0.0 };
+		uint64_t	mWithFeedback{ 0 };
+		uint64_t	mCacheHits{ 0 };
+	};
+
+	//keeps the last MaxRecords records, so a long session that keeps building pipelines does not grow it without bound
+	class PipelineCreationLog {
+	public:
+		using Ptr = std::shared_ptr<PipelineCreationLog>;
+		static Ptr create() { return std::make_shared<PipelineCreationLog>(); }
+
+		static constexpr size_t MaxRecords = 4096;
+
+		PipelineCreationLog() = default;
+
+		~PipelineCreationLog() = default;
+
+		//thread safe
+		void add(const PipelineCreationRecord& record);
+
+		//the most recent records, oldest first
+		[[nodiscard]] std::vector<PipelineCreationRecord> getRecords() const;
+
+		[[nodiscard]] PipelineCreationTotals getTotals() const;
+
+		//slowest of the kept created pipelines first, shared requests are left out
+		[[nodiscard]] std::vector<PipelineCreationRecord> getSlowest(size_t count) const;
+
+		//drops the records and resets the totals
+		void clear();
+
+		[[nodiscard]] std::string toJson() const;
+
+	private:
+		std::deque<PipelineCreationRecord> mRecords{};
+		PipelineCreationTotals mTotals{};
+
+		mutable std::mutex mMutex;
+	};
+}
@@ -0,0 +1,603 @@
+#include "pipelineManifest.h"
+#include "shaderLibrary.h"
+#include <filesystem>
+
+namespace Tea::Wrapper {
+
+	namespace {
+		//reads what StateKey wrote, every read past the end fails the whole description
+		class DescriptionReader {
+		public:
+			explicit DescriptionReader(const std::vector<uint8_t>& data) : mData(data) {}
+
+			template<typename T>
+			T read() {
+				T value{};
+				if (mFailed || mOffset + sizeof(T) > mData.size()) {
+					mFailed = true;
+					return value;
+				}
+
+				std::memcpy(&value, mData.data() + mOffset, sizeof(T));
+				mOffset += sizeof(T);
+
+				return value;
+			}
+
+			//element counts are checked against the bytes left, a damaged count must not allocate gigabytes
+			size_t readCount(size_t elementSize) {
+				auto count = read<size_t>();
+				if (mFailed || count > (mData.size() - mOffset) / std::max<size_t>(elementSize, 1)) {
+					mFailed = true;
+					return 0;
+				}
+
+				return count;
+			}
+
+			std::string readString() {
+				auto length = readCount(1);
+				if (mFailed) {
+					return {};
+				}
+
+				std::string text(reinterpret_cast<const char*>(mData.data() + mOffset), length);
+				mOffset += length;
+
+				return text;
+			}
+
+			[[nodiscard]] bool isValid() const { return !mFailed && mOffset == mData.size(); }
+
+		private:
+			const std::vector<uint8_t>& mData;
+			size_t mOffset{ 0 };
+			bool mFailed{ false };
+		};
+	}
+
+	void PipelineDescription::write(StateKey& out) const {
+		out.add(mStages.size());
+		for (const auto& stage : mStages) {
+			out.addString(stage.mFileName.c_str());
+			out.addString(stage.mEntryPoint.c_str());
+			out.add(stage.mStage);
+			out.add(stage.mCodeHash);
+
+			const auto& mapEntries = stage.mSpecialization.getMapEntries();
+			out.add(mapEntries.size());
+			for (const auto& entry : mapEntries) {
+				out.add(entry.constantID);
+				out.add(entry.offset);
+				out.add(entry.size);
+			}
+			const auto& data = stage.mSpecialization.getData();
+			out.add(data.size());
+			out.addBytes(data.data(), data.size());
+		}
+
+		out.add(mVertexBindings.size());
+		for (const auto& binding : mVertexBindings) {
+			out.add(binding.binding);
+			out.add(binding.stride);
+			out.add(binding.inputRate);
+		}
+
+		out.add(mVertexAttributes.size());
+		for (const auto& attribute : mVertexAttributes) {
+			out.add(attribute.location);
+			out.add(attribute.binding);
+			out.add(attribute.format);
+			out.add(attribute.offset);
+		}
+
+		out.add(mAssemblyState.topology);
+		out.add(mAssemblyState.primitiveRestartEnable);
+
+		out.add(mRasterState.depthClampEnable);
+		out.add(mRasterState.rasterizerDiscardEnable);
+		out.add(mRasterState.polygonMode);
+		out.add(mRasterState.cullMode);
+		out.add(mRasterState.frontFace);
+		out.add(mRasterState.depthBiasEnable);
+		out.add(mRasterState.depthBiasConstantFactor);
+		out.add(mRasterState.depthBiasClamp);
+		out.add(mRasterState.depthBiasSlopeFactor);
+		out.add(mRasterState.lineWidth);
+
+		out.add(mSampleState.rasterizationSamples);
+		out.add(mSampleState.sampleShadingEnable);
+		out.add(mSampleState.minSampleShading);
+		out.add(mSampleState.alphaToCoverageEnable);
+		out.add(mSampleState.alphaToOneEnable);
+
+		out.add(mDepthStencilState.depthTestEnable);
+		out.add(mDepthStencilState.depthWriteEnable);
+		out.add(mDepthStencilState.depthCompareOp);
+		out.add(mDepthStencilState.depthBoundsTestEnable);
+		out.add(mDepthStencilState.stencilTestEnable);
+		for (const auto& stencil : { mDepthStencilState.front, mDepthStencilState.back }) {
+			out.add(stencil.failOp);
+			out.add(stencil.passOp);
+			out.add(stencil.depthFailOp);
+			out.add(stencil.compareOp);
+			out.add(stencil.compareMask);
+			out.add(stencil.writeMask);
+			out.add(stencil.reference);
+		}
+		out.add(mDepthStencilState.minDepthBounds);
+		out.add(mDepthStencilState.maxDepthBounds);
+
+		out.add(mBlendState.logicOpEnable);
+		out.add(mBlendState.logicOp);
+		for (float constant : mBlendState.blendConstants) {
+			out.add(constant);
+		}
+
+		out.add(mViewports.size());
+		for (const auto& viewport : mViewports) {
+			out.add(viewport.x);
+			out.add(viewport.y);
+			out.add(viewport.width);
+			out.add(viewport.height);
+			out.add(viewport.minDepth);
+			out.add(viewport.maxDepth);
+		}
+
+		out.add(mScissors.size());
+		for (const auto& scissor : mScissors) {
+			out.add(scissor.offset.x);
+			out.add(scissor.offset.y);
+			out.add(scissor.extent.width);
+			out.add(scissor.extent.height);
+		}
+
+		out.add(mSampleMask.size());
+		for (auto mask : mSampleMask) {
+			out.add(mask);
+		}
+
+		out.add(mBlendAttachments.size());
+		for (const auto& attachment : mBlendAttachments) {
+			out.add(attachment.blendEnable);
+			out.add(attachment.srcColorBlendFactor);
+			out.add(attachment.dstColorBlendFactor);
+			out.add(attachment.colorBlendOp);
+			out.add(attachment.srcAlphaBlendFactor);
+			out.add(attachment.dstAlphaBlendFactor);
+			out.add(attachment.alphaBlendOp);
+			out.add(attachment.colorWriteMask);
+		}
+
+		out.add(mDynamicStates.size());
+		for (auto state : mDynamicStates) {
+			out.add(state);
+		}
+
+		out.add(mSetLayouts.size());
+		for (const auto& setLayout : mSetLayouts) {
+			out.add(setLayout.size());
+			for (const auto& binding : setLayout) {
+				out.add(binding.binding);
+				out.add(binding.descriptorType);
+				out.add(binding.descriptorCount);
+				out.add(binding.stageFlags);
+			}
+		}
+
+		out.add(mPushConstantRanges.size());
+		for (const auto& range : mPushConstantRanges) {
+			out.add(range.stageFlags);
+			out.add(range.offset);
+			out.add(range.size);
+		}
+
+		out.add(mAttachments.size());
+		for (const auto& attachment : mAttachments) {
+			out.add(attachment.flags);
+			out.add(attachment.format);
+			out.add(attachment.samples);
+			out.add(attachment.loadOp);
+			out.add(attachment.storeOp);
+			out.add(attachment.stencilLoadOp);
+			out.add(attachment.stencilStoreOp);
+			out.add(attachment.initialLayout);
+			out.add(attachment.finalLayout);
+		}
+
+		auto addReference = [&out](const VkAttachmentReference& reference) {
+			out.add(reference.attachment);
+			out.add(reference.layout);
+		};
+
+		out.add(mSubPasses.size());
+		for (const auto& subPass : mSubPasses) {
+			out.add(subPass.mColorAttachments.size());
+			for (const auto& reference : subPass.mColorAttachments) {
+				addReference(reference);
+			}
+
+			out.add(subPass.mInputAttachments.size());
+			for (const auto& reference : subPass.mInputAttachments) {
+				addReference(reference);
+			}
+
+			addReference(subPass.mDepthStencilAttachment);
+		}
+
+		out.add(mDependencies.size());
+		for (const auto& dependency : mDependencies) {
+			out.add(dependency.srcSubpass);
+			out.add(dependency.dstSubpass);
+			out.add(dependency.srcStageMask);
+			out.add(dependency.dstStageMask);
+			out.add(dependency.srcAccessMask);
+			out.add(dependency.dstAccessMask);
+			out.add(dependency.dependencyFlags);
+		}
+
+		out.add(mSubPass);
+	}
+
+	std::optional<PipelineDescription> PipelineDescription::read(const std::vector<uint8_t>& data) {
+		DescriptionReader in(data);
+		PipelineDescription description{};
+
+		description.mStages.resize(in.readCount(sizeof(uint32_t)));
+		for (auto& stage : description.mStages) {
+			stage.mFileName = in.readString();
+			stage.mEntryPoint = in.readString();
+			stage.mStage = in.read<VkShaderStageFlagBits>();
+			stage.mCodeHash = in.read<uint64_t>();
+
+			std::vector<VkSpecializationMapEntry> mapEntries(in.readCount(sizeof(uint32_t) * 2 + sizeof(size_t)));
+			for (auto& entry : mapEntries) {
+				entry.constantID = in.read<uint32_t>();
+				entry.offset = in.read<uint32_t>();
+				entry.size = in.read<size_t>();
+			}
+			std::vector<uint8_t> data(in.readCount(1));
+			for (auto& byte : data) {
+				byte = in.read<uint8_t>();
+			}
+			if (!stage.mSpecialization.assign(mapEntries, data)) {
+				return std::nullopt;
+			}
+		}
+
+		description.mVertexBindings.resize(in.readCount(sizeof(VkVertexInputBindingDescription)));
+		for (auto& binding : description.mVertexBindings) {
+			binding.binding = in.read<uint32_t>();
+			binding.stride = in.read<uint32_t>();
+			binding.inputRate = in.read<VkVertexInputRate>();
+		}
+
+		description.mVertexAttributes.resize(in.readCount(sizeof(VkVertexInputAttributeDescription)));
+		for (auto& attribute : description.mVertexAttributes) {
+			attribute.location = in.read<uint32_t>();
+			attribute.binding = in.read<uint32_t>();
+			attribute.format = in.read<VkFormat>();
+			attribute.offset = in.read<uint32_t>();
+		}
+
+		description.mAssemblyState.topology = in.read<VkPrimitiveTopology>();
+		description.mAssemblyState.primitiveRestartEnable = in.read<VkBool32>();
+
+		auto& raster = description.mRasterState;
+		raster.depthClampEnable = in.read<VkBool32>();
+		raster.rasterizerDiscardEnable = in.read<VkBool32>();
+		raster.polygonMode = in.read<VkPolygonMode>();
+		raster.cullMode = in.read<VkCullModeFlags>();
+		raster.frontFace = in.read<VkFrontFace>();
+		raster.depthBiasEnable = in.read<VkBool32>();
+		raster.depthBiasConstantFactor = in.read<float>();
+		raster.depthBiasClamp = in.read<float>();
+		raster.depthBiasSlopeFactor = in.read<float>();
+		raster.lineWidth = in.read<float>();
+
+		auto& sample = description.mSampleState;
+		sample.rasterizationSamples = in.read<VkSampleCountFlagBits>();
+		sample.sampleShadingEnable = in.read<VkBool32>();
+		sample.minSampleShading = in.read<float>();
+		sample.alphaToCoverageEnable = in.read<VkBool32>();
+		sample.alphaToOneEnable = in.read<VkBool32>();
+
+		auto& depth = description.mDepthStencilState;
+		depth.depthTestEnable = in.read<VkBool32>();
+		depth.depthWriteEnable = in.read<VkBool32>();
+		depth.depthCompareOp = in.read<VkCompareOp>();
+		depth.depthBoundsTestEnable = in.read<VkBool32>();
+		depth.stencilTestEnable = in.read<VkBool32>();
+		for (auto* stencil : { &depth.front, &depth.back }) {
+			stencil->failOp = in.read<VkStencilOp>();
+			stencil->passOp = in.read<VkStencilOp>();
+			stencil->depthFailOp = in.read<VkStencilOp>();
+			stencil->compareOp = in.read<VkCompareOp>();
+			stencil->compareMask = in.read<uint32_t>();
+			stencil->writeMask = in.read<uint32_t>();
+			stencil->reference = in.read<uint32_t>();
+		}
+		depth.minDepthBounds = in.read<float>();
+		depth.maxDepthBounds = in.read<float>();
+
+		description.mBlendState.logicOpEnable = in.read<VkBool32>();
+		description.mBlendState.logicOp = in.read<VkLogicOp>();
+		for (float& constant : description.mBlendState.blendConstants) {
+			constant = in.read<float>();
+		}
+
+		description.mViewports.resize(in.readCount(sizeof(VkViewport)));
+		for (auto& viewport : description.mViewports) {
+			viewport.x = in.read<float>();
+			viewport.y = in.read<float>();
+			viewport.width = in.read<float>();
+			viewport.height = in.read<float>();
+			viewport.minDepth = in.read<float>();
+			viewport.maxDepth = in.read<float>();
+		}
+
+		description.mScissors.resize(in.readCount(sizeof(VkRect2D)));
+		for (auto& scissor : description.mScissors) {
+			scissor.offset.x = in.read<int32_t>();
+			scissor.offset.y = in.read<int32_t>();
+			scissor.extent.width = in.read<uint32_t>();
+			scissor.extent.height = in.read<uint32_t>();
+		}
+
+		description.mSampleMask.resize(in.readCount(sizeof(VkSampleMask)));
+		for (auto& mask : description.mSampleMask) {
+			mask = in.read<VkSampleMask>();
+		}
+
+		description.mBlendAttachments.resize(in.readCount(sizeof(VkPipelineColorBlendAttachmentState)));
+		for (auto& attachment : description.mBlendAttachments) {
+			attachment.blendEnable = in.read<VkBool32>();
+			attachment.srcColorBlendFactor = in.read<VkBlendFactor>();
+			attachment.dstColorBlendFactor = in.read<VkBlendFactor>();
+			attachment.colorBlendOp = in.read<VkBlendOp>();
+			attachment.srcAlphaBlendFactor = in.read<VkBlendFactor>();
+			attachment.dstAlphaBlendFactor = in.read<VkBlendFactor>();
+			attachment.alphaBlendOp = in.read<VkBlendOp>();
+			attachment.colorWriteMask = in.read<VkColorComponentFlags>();
+		}
+
+		description.mDynamicStates.resize(in.readCount(sizeof(VkDynamicState)));
+		for (auto& state : description.mDynamicStates) {
+			state = in.read<VkDynamicState>();
+		}
+
+		description.mSetLayouts.resize(in.readCount(sizeof(size_t)));
+		for (auto& setLayout : description.mSetLayouts) {
+			setLayout.resize(in.readCount(4 * sizeof(uint32_t)));
+			for (auto& binding : setLayout) {
+				binding.binding = in.read<uint32_t>();
+				binding.descriptorType = in.read<VkDescriptorType>();
+				binding.descriptorCount = in.read<uint32_t>();
+				binding.stageFlags = in.read<VkShaderStageFlags>();
+			}
+		}
+
+		description.mPushConstantRanges.resize(in.readCount(sizeof(VkPushConstantRange)));
+		for (auto& range : description.mPushConstantRanges) {
+			range.stageFlags = in.read<VkShaderStageFlags>();
+			range.offset = in.read<uint32_t>();
+			range.size = in.read<uint32_t>();
+		}
+
+		description.mAttachments.resize(in.readCount(sizeof(VkAttachmentDescription)));
+		for (auto& attachment : description.mAttachments) {
+			attachment.flags = in.read<VkAttachmentDescriptionFlags>();
+			attachment.format = in.read<VkFormat>();
+			attachment.samples = in.read<VkSampleCountFlagBits>();
+			attachment.loadOp = in.read<VkAttachmentLoadOp>();
+			attachment.storeOp = in.read<VkAttachmentStoreOp>();
+			attachment.stencilLoadOp = in.read<VkAttachmentLoadOp>();
+			attachment.stencilStoreOp = in.read<VkAttachmentStoreOp>();
+			attachment.initialLayout = in.read<VkImageLayout>();
+			attachment.finalLayout = in.read<VkImageLayout>();
+		}
+
+		auto readReference = [&in]() {
+			VkAttachmentReference reference{};
+			reference.attachment = in.read<uint32_t>();
+			reference.layout = in.read<VkImageLayout>();
+			return reference;
+		};
+
+		description.mSubPasses.resize(in.readCount(sizeof(VkAttachmentReference)));
+		for (auto& subPass : description.mSubPasses) {
+			subPass.mColorAttachments.resize(in.readCount(sizeof(VkAttachmentReference)));
+			for (auto& reference : subPass.mColorAttachments) {
+				reference = readReference();
+			}
+
+			subPass.mInputAttachments.resize(in.readCount(sizeof(VkAttachmentReference)));
+			for (auto& reference : subPass.mInputAttachments) {
+				reference = readReference();
+			}
+
+			subPass.mDepthStencilAttachment = readReference();
+		}
+
+		description.mDependencies.resize(in.readCount(sizeof(VkSubpassDependency)));
+		for (auto& dependency : description.mDependencies) {
+			dependency.srcSubpass = in.read<uint32_t>();
+			dependency.dstSubpass = in.read<uint32_t>();
+			dependency.srcStageMask = in.read<VkPipelineStageFlags>();
+			dependency.dstStageMask = in.read<VkPipelineStageFlags>();
+			dependency.srcAccessMask = in.read<VkAccessFlags>();
+			dependency.dstAccessMask = in.read<VkAccessFlags>();
+			dependency.dependencyFlags = in.read<VkDependencyFlags>();
+		}
+
+		description.mSubPass = in.read<uint32_t>();
+
+		if (!in.isValid()) {
+			return std::nullopt;
+		}
+
+		return description;
+	}
+
+	PipelineManifest::PipelineManifest(const std::string& path) {
+		mPath = path;
+		load();
+	}
+
+	void PipelineManifest::record(const PipelineDescription& description) {
+		StateKey bytes{};
+		description.write(bytes);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mRecordedHashes.insert(bytes.getHash()).second) {
+			mRecorded.push_back(bytes.getBytes());
+		}
+	}
+
+	std::vector<PipelineDescription> PipelineManifest::getLoadedDescriptions() const {
+		std::vector<PipelineDescription> descriptions{};
+
+		for (const auto& data : mLoaded) {
+			auto description = PipelineDescription::read(data);
+			if (description.has_value()) {
+				descriptions.push_back(std::move(description.value()));
+			}
+		}
+
+		return descriptions;
+	}
+
+	size_t PipelineManifest::getRecordedCount() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mRecorded.size();
+	}
+
+	bool PipelineManifest::save() const {
+		//mLoaded is only written by the constructor, the shader files are hashed outside the lock
+		std::vector<const std::vector<uint8_t>*> current{};
+		std::map<std::string, std::optional<uint64_t>> fileHashes{};
+		for (const auto& data : mLoaded) {
+			if (isCurrent(data, fileHashes)) {
+				current.push_back(&data);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		//the warm-up builds last run's pipelines unrecorded, they stay in the file through mLoaded
+		std::vector<const std::vector<uint8_t>*> entries{};
+		std::set<uint64_t> hashes = mRecordedHashes;
+		for (const auto& data : mRecorded) {
+			entries.push_back(&data);
+		}
+		for (const auto* data : current) {
+			StateKey key{};
+			key.addBytes(data->data(), data->size());
+			if (hashes.insert(key.getHash()).second) {
+				entries.push_back(data);
+			}
+		}
+
+		StateKey body{};
+		for (const auto* data : entries) {
+			body.add(static_cast<uint64_t>(data->size()));
+			body.addBytes(data->data(), data->size());
+		}
+
+		FileHeader header{};
+		header.mMagic = Magic;
+		header.mVersion = Version;
+		header.mCount = entries.size();
+		header.mChecksum = body.getHash();
+
+		//written next to the manifest and renamed over it, like PipelineCache::save
+		std::string tempPath = mPath + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file) {
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(body.getBytes().data()), static_cast<std::streamsize>(body.getBytes().size()));
+			file.flush();
+
+			if (!file) {
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, mPath, error);
+		if (error) {
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool PipelineManifest::isCurrent(const std::vector<uint8_t>& data, std::map<std::string, std::optional<uint64_t>>& fileHashes) {
+		auto description = PipelineDescription::read(data);
+		if (!description.has_value()) {
+			return false;
+		}
+
+		//the same check PipelineWarmup::getShader makes, a changed or removed shader never warms this description up again
+		for (const auto& stage : description->mStages) {
+			auto it = fileHashes.find(stage.mFileName);
+			if (it == fileHashes.end()) {
+				it = fileHashes.emplace(stage.mFileName, ShaderLibrary::getFileHash(stage.mFileName)).first;
+			}
+
+			if (it->second != stage.mCodeHash) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void PipelineManifest::load() {
+		std::ifstream file(mPath, std::ios::ate | std::ios::binary | std::ios::in);
+		if (!file) {
+			return;
+		}
+
+		auto fileSize = static_cast<size_t>(file.tellg());
+		if (fileSize < sizeof(FileHeader)) {
+			return;
+		}
+		file.seekg(0);
+
+		FileHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		std::vector<uint8_t> body(fileSize - sizeof(FileHeader));
+		file.read(reinterpret_cast<char*>(body.data()), static_cast<std::streamsize>(body.size()));
+
+		StateKey checksum{};
+		checksum.addBytes(body.data(), body.size());
+
+		if (!file || header.mMagic != Magic || header.mVersion != Version || checksum.getHash() != header.mChecksum) {
+			std::cerr << "Pipeline manifest " << mPath << " is stale or damaged, nothing is warmed up" << std::endl;
+			return;
+		}
+
+		size_t offset = 0;
+		for (uint64_t i = 0; i < header.mCount; ++i) {
+			uint64_t size = 0;
+			if (offset + sizeof(size) > body.size()) {
+				break;
+			}
+			std::memcpy(&size, body.data() + offset, sizeof(size));
+			offset += sizeof(size);
+
+			if (size > body.size() - offset) {
+				break;
+			}
+			mLoaded.emplace_back(body.begin() + offset, body.begin() + offset + size);
+			offset += size;
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../base.h"
+#include "pipelineStateCache.h"
+#include "specializationConstants.h"
+
+namespace Tea::Wrapper {
+	//Everything needed to build a pipeline again in a later run, without any handle: shaders by file,
+	//descriptor set layouts by their bindings and the render pass by its description.
+	//Written by Pipeline for every pipeline it builds, turned back into pipelines by PipelineWarmup.
+
+	struct ShaderStageDescription {
+		std::string				mFileName{};
+		std::string				mEntryPoint{};
+		VkShaderStageFlagBits	mStage{ VK_SHADER_STAGE_VERTEX_BIT };
+		uint64_t				mCodeHash{ 0 };		//the file is skipped at warm-up if its code changed since
+		SpecializationConstants	mSpecialization{};
+	};
+
+	struct SubPassDescription {
+		std::vector<VkAttachmentReference> mColorAttachments{};
+		std::vector<VkAttachmentReference> mInputAttachments{};
+		VkAttachmentReference mDepthStencilAttachment{};	//layout VK_IMAGE_LAYOUT_UNDEFINED: none
+	};
+
+	struct PipelineDescription {
+		std::vector<ShaderStageDescription> mStages{};
+
+		std::vector<VkVertexInputBindingDescription> mVertexBindings{};
+		std::vector<VkVertexInputAttributeDescription> mVertexAttributes{};
+
+		//only the plain fields of the create infos are kept, their pointers and sType are not
+		VkPipelineInputAssemblyStateCreateInfo mAssemblyState{};
+		VkPipelineRasterizationStateCreateInfo mRasterState{};
+		VkPipelineMultisampleStateCreateInfo mSampleState{};
+		VkPipelineDepthStencilStateCreateInfo mDepthStencilState{};
+		VkPipelineColorBlendStateCreateInfo mBlendState{};
+
+		std::vector<VkViewport> mViewports{};
+		std::vector<VkRect2D> mScissors{};
+		std::vector<VkSampleMask> mSampleMask{};
+		std::vector<VkPipelineColorBlendAttachmentState> mBlendAttachments{};
+		std::vector<VkDynamicState> mDynamicStates{};
+
+		std::vector<std::vector<VkDescriptorSetLayoutBinding>> mSetLayouts{};
+		std::vector<VkPushConstantRange> mPushConstantRanges{};
+
+		std::vector<VkAttachmentDescription> mAttachments{};
+		std::vector<SubPassDescription> mSubPasses{};
+		std::vector<VkSubpassDependency> mDependencies{};
+		uint32_t mSubPass{ 0 };
+
+		void write(StateKey& out) const;
+
+		//empty if data is not a description this version wrote
+		static std::optional<PipelineDescription> read(const std::vector<uint8_t>& data);
+	};
+
+	//The descriptions of every pipeline built during a run, loaded at startup and saved at shutdown.
+	//A description is recorded once however often it is built. Stored as
+	//header (magic, version, count, checksum) + per description (size, bytes), saved through a temporary file like PipelineCache
+	class PipelineManifest {
+	public:
+		using Ptr = std::shared_ptr<PipelineManifest>;
+		static Ptr create(const std::string& path) { return std::make_shared<PipelineManifest>(path); }
+
+		static constexpr const char* DefaultPath = "pipeline_manifest.bin";
+
+		explicit PipelineManifest(const std::string& path);
+
+		~PipelineManifest() = default;
+
+		//thread safe
+		void record(const PipelineDescription& description);
+
+		//descriptions the previous run saved
+		[[nodiscard]] std::vector<PipelineDescription> getLoadedDescriptions() const;
+
+		[[nodiscard]] size_t getRecordedCount() const;
+
+		//writes the recorded descriptions and the loaded ones whose shader files are unchanged, so a run that builds
+		//only some pipelines keeps the others while descriptions of edited or removed shaders are dropped
+		bool save() const;
+
+	private:
+		struct FileHeader {
+			uint32_t mMagic{ 0 };
+			uint32_t mVersion{ 0 };
+			uint64_t mCount{ 0 };
+			uint64_t mChecksum{ 0 };
+		};
+
+		static constexpr uint32_t Magic = 0x4D505454;	//"TTPM"
+		static constexpr uint32_t Version = 2;
+
+		void load();
+
+		//true if data is a description whose stages' files still have the recorded code hashes.
+		//fileHashes keeps the files hashed so far, most descriptions share their shaders
+		static bool isCurrent(const std::vector<uint8_t>& data, std::map<std::string, std::optional<uint64_t>>& fileHashes);
+
+	private:
+		std::string mPath{};
+
+		std::vector<std::vector<uint8_t>> mLoaded{};
+
+		std::vector<std::vector<uint8_t>> mRecorded{};
+		std::set<uint64_t> mRecordedHashes{};
+
+		mutable std::mutex mMutex;
+	};
+}
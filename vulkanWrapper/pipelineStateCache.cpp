@@ -0,0 +1,415 @@
+#include "pipelineStateCache.h"
+
+namespace Tea::Wrapper {
+
+	void StateKey::addBytes(const void* data, size_t size) {
+		auto bytes = static_cast<const uint8_t*>(data);
+		mBytes.insert(mBytes.end(), bytes, bytes + size);
+
+		for (size_t i = 0; i < size; ++i) {
+			mHash ^= bytes[i];
+			mHash *= 1099511628211ull;
+		}
+	}
+
+	void StateKey::addString(const char* text) {
+		//length first, so "ab" + "c" and "a" + "bc" differ
+		size_t length = text != nullptr ? std::strlen(text) : 0;
+		add(length);
+		addBytes(text, length);
+	}
+
+	SharedPipelineLayout::~SharedPipelineLayout() {
+		if (mLayout != VK_NULL_HANDLE) {
+			vkDestroyPipelineLayout(mDevice, mLayout, nullptr);
+		}
+	}
+
+	SharedPipeline::~SharedPipeline() {
+		if (mPipeline != VK_NULL_HANDLE) {
+			vkDestroyPipeline(mDevice, mPipeline, nullptr);
+		}
+	}
+
+	PipelineStateCache::PipelineStateCache(VkDevice device, VkPipelineCache pipelineCache, bool creationFeedback) {
+		mDevice = device;
+		mPipelineCache = pipelineCache;
+		mCreationFeedback = creationFeedback;
+		mCreationLog = PipelineCreationLog::create();
+	}
+
+	SharedPipelineLayout::Ptr PipelineStateCache::getLayout(const VkPipelineLayoutCreateInfo& createInfo) {
+		auto key = makeLayoutKey(createInfo);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStats.mLayoutRequests++;
+
+		auto range = mLayouts.equal_range(key.getHash());
+		for (auto it = range.first; it != range.second; ++it) {
+			if (it->second.first == key) {
+				if (auto layout = it->second.second.lock()) {
+					return layout;
+				}
+			}
+		}
+
+		VkPipelineLayout layout{ VK_NULL_HANDLE };
+		if (vkCreatePipelineLayout(mDevice, &createInfo, nullptr, &layout) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create pipeline layout");
+		}
+		mStats.mLayoutsCreated++;
+
+		auto sharedLayout = std::make_shared<SharedPipelineLayout>(mDevice, layout);
+
+		prune(mLayouts);
+		mLayouts.emplace(key.getHash(), std::make_pair(std::move(key), std::weak_ptr<SharedPipelineLayout>(sharedLayout)));
+
+		return sharedLayout;
+	}
+
+	SharedPipeline::Ptr PipelineStateCache::getPipeline(const VkGraphicsPipelineCreateInfo& createInfo, const PipelineIdentity& identity) {
+		if (identity.mStageCodeHashes.size() != createInfo.stageCount) {
+			throw std::runtime_error("Error: every pipeline stage needs its code hash");
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto key = makePipelineKey(createInfo, identity);
+		auto hash = key.getHash();
+
+		PipelineCreationRecord record{};
+		record.mKeyHash = hash;
+		record.mLabel = identity.mLabel;
+
+		auto logShared = [&]() {
+			record.mShared = true;
+			record.mCpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			mCreationLog->add(record);
+		};
+
+		std::promise<SharedPipeline::Ptr> promise;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStats.mPipelineRequests++;
+
+			auto range = mPipelines.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				if (it->second.first == key) {
+					if (auto pipeline = it->second.second.lock()) {
+						lock.unlock();
+
+						logShared();
+						return pipeline;
+					}
+				}
+			}
+
+			auto compiling = mCompilingPipelines.equal_range(hash);
+			for (auto it = compiling.first; it != compiling.second; ++it) {
+				if (it->second.first == key) {
+					auto future = it->second.second;
+					lock.unlock();
+
+					auto pipeline = future.get();
+					logShared();
+					return pipeline;
+				}
+			}
+
+			mCompilingPipelines.emplace(hash, std::make_pair(key, promise.get_future().share()));
+		}
+
+		SharedPipeline::Ptr sharedPipeline{ nullptr };
+		VkPipeline pipeline{ VK_NULL_HANDLE };
+		bool created = createPipeline(createInfo, &pipeline, record) == VK_SUCCESS;
+		if (created) {
+			sharedPipeline = std::make_shared<SharedPipeline>(mDevice, pipeline, identity.mLayout);
+
+			record.mCpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			mCreationLog->add(record);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			auto compiling = mCompilingPipelines.equal_range(hash);
+			for (auto it = compiling.first; it != compiling.second; ++it) {
+				if (it->second.first == key) {
+					mCompilingPipelines.erase(it);
+					break;
+				}
+			}
+
+			if (created) {
+				mStats.mPipelinesCreated++;
+
+				prune(mPipelines);
+				mPipelines.emplace(hash, std::make_pair(std::move(key), std::weak_ptr<SharedPipeline>(sharedPipeline)));
+			}
+		}
+
+		if (!created) {
+			auto error = std::make_exception_ptr(std::runtime_error("Error:failed to create pipeline"));
+			promise.set_exception(error);
+			std::rethrow_exception(error);
+		}
+
+		promise.set_value(sharedPipeline);
+
+		return sharedPipeline;
+	}
+
+	VkResult PipelineStateCache::createPipeline(const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline* pipeline, PipelineCreationRecord& record) const {
+		if (!mCreationFeedback) {
+			return vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &createInfo, nullptr, pipeline);
+		}
+
+		VkPipelineCreationFeedbackEXT pipelineFeedback{};
+		std::vector<VkPipelineCreationFeedbackEXT> stageFeedbacks(createInfo.stageCount);
+
+		VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+		feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+		feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+		feedbackInfo.pipelineStageCreationFeedbackCount = createInfo.stageCount;
+		feedbackInfo.pPipelineStageCreationFeedbacks = stageFeedbacks.data();
+
+		//the key requires an empty chain, so the feedback is all there is
+		auto feedbackCreateInfo = createInfo;
+		feedbackCreateInfo.pNext = &feedbackInfo;
+
+		auto result = vkCreateGraphicsPipelines(mDevice, mPipelineCache, 1, &feedbackCreateInfo, nullptr, pipeline);
+		if (result != VK_SUCCESS) {
+			return result;
+		}
+
+		//durations are in nanoseconds
+		record.mFeedbackValid = (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) != 0;
+		record.mDriverMs = static_cast<double>(pipelineFeedback.duration) / 1e6;
+		record.mCacheHit = (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0;
+
+		for (uint32_t i = 0; i < createInfo.stageCount; ++i) {
+			PipelineStageCreationRecord stage{};
+			stage.mStage = createInfo.pStages[i].stage;
+			stage.mValid = (stageFeedbacks[i].flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT) != 0;
+			stage.mMs = static_cast<double>(stageFeedbacks[i].duration) / 1e6;
+			stage.mCacheHit = (stageFeedbacks[i].flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) != 0;
+
+			record.mStages.push_back(stage);
+		}
+
+		return result;
+	}
+
+	PipelineStateCacheStats PipelineStateCache::getStats() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mStats;
+	}
+
+	StateKey PipelineStateCache::makeLayoutKey(const VkPipelineLayoutCreateInfo& createInfo) {
+		StateKey key{};
+		key.add(createInfo.flags);
+
+		key.add(createInfo.setLayoutCount);
+		for (uint32_t i = 0; i < createInfo.setLayoutCount; ++i) {
+			key.add(createInfo.pSetLayouts[i]);
+		}
+
+		key.add(createInfo.pushConstantRangeCount);
+		for (uint32_t i = 0; i < createInfo.pushConstantRangeCount; ++i) {
+			const auto& range = createInfo.pPushConstantRanges[i];
+			key.add(range.stageFlags);
+			key.add(range.offset);
+			key.add(range.size);
+		}
+
+		return key;
+	}
+
+	StateKey PipelineStateCache::makePipelineKey(const VkGraphicsPipelineCreateInfo& createInfo, const PipelineIdentity& identity) {
+		StateKey key{};
+		key.add(createInfo.flags);
+
+		//shaders
+		key.add(createInfo.stageCount);
+		for (uint32_t i = 0; i < createInfo.stageCount; ++i) {
+			const auto& stage = createInfo.pStages[i];
+			key.add(stage.flags);
+			key.add(stage.stage);
+			key.add(identity.mStageCodeHashes[i]);
+			key.addString(stage.pName);
+
+			bool specialized = stage.pSpecializationInfo != nullptr;
+			key.add(specialized);
+			if (specialized) {
+				const auto& specialization = *stage.pSpecializationInfo;
+				key.add(specialization.mapEntryCount);
+				for (uint32_t entry = 0; entry < specialization.mapEntryCount; ++entry) {
+					key.add(specialization.pMapEntries[entry].constantID);
+					key.add(specialization.pMapEntries[entry].offset);
+					key.add(specialization.pMapEntries[entry].size);
+				}
+				key.add(specialization.dataSize);
+				key.addBytes(specialization.pData, specialization.dataSize);
+			}
+		}
+
+		//vertex input
+		const auto& vertexInput = *createInfo.pVertexInputState;
+		key.add(vertexInput.vertexBindingDescriptionCount);
+		for (uint32_t i = 0; i < vertexInput.vertexBindingDescriptionCount; ++i) {
+			const auto& binding = vertexInput.pVertexBindingDescriptions[i];
+			key.add(binding.binding);
+			key.add(binding.stride);
+			key.add(binding.inputRate);
+		}
+		key.add(vertexInput.vertexAttributeDescriptionCount);
+		for (uint32_t i = 0; i < vertexInput.vertexAttributeDescriptionCount; ++i) {
+			const auto& attribute = vertexInput.pVertexAttributeDescriptions[i];
+			key.add(attribute.location);
+			key.add(attribute.binding);
+			key.add(attribute.format);
+			key.add(attribute.offset);
+		}
+
+		key.add(createInfo.pInputAssemblyState->topology);
+		key.add(createInfo.pInputAssemblyState->primitiveRestartEnable);
+
+		bool tessellation = createInfo.pTessellationState != nullptr;
+		key.add(tessellation);
+		if (tessellation) {
+			key.add(createInfo.pTessellationState->patchControlPoints);
+		}
+
+		//viewports and scissors only count when they are baked
+		const auto& viewportState = *createInfo.pViewportState;
+		key.add(viewportState.viewportCount);
+		key.add(viewportState.pViewports != nullptr);
+		for (uint32_t i = 0; viewportState.pViewports != nullptr && i < viewportState.viewportCount; ++i) {
+			const auto& viewport = viewportState.pViewports[i];
+			key.add(viewport.x);
+			key.add(viewport.y);
+			key.add(viewport.width);
+			key.add(viewport.height);
+			key.add(viewport.minDepth);
+			key.add(viewport.maxDepth);
+		}
+		key.add(viewportState.scissorCount);
+		key.add(viewportState.pScissors != nullptr);
+		for (uint32_t i = 0; viewportState.pScissors != nullptr && i < viewportState.scissorCount; ++i) {
+			const auto& scissor = viewportState.pScissors[i];
+			key.add(scissor.offset.x);
+			key.add(scissor.offset.y);
+			key.add(scissor.extent.width);
+			key.add(scissor.extent.height);
+		}
+
+		//rasterization
+		const auto& raster = *createInfo.pRasterizationState;
+		key.add(raster.depthClampEnable);
+		key.add(raster.rasterizerDiscardEnable);
+		key.add(raster.polygonMode);
+		key.add(raster.cullMode);
+		key.add(raster.frontFace);
+		key.add(raster.depthBiasEnable);
+		key.add(raster.depthBiasConstantFactor);
+		key.add(raster.depthBiasClamp);
+		key.add(raster.depthBiasSlopeFactor);
+		key.add(raster.lineWidth);
+
+		const auto& multisample = *createInfo.pMultisampleState;
+		key.add(multisample.rasterizationSamples);
+		key.add(multisample.sampleShadingEnable);
+		key.add(multisample.minSampleShading);
+		key.add(multisample.pSampleMask != nullptr);
+		if (multisample.pSampleMask != nullptr) {
+			uint32_t maskWords = (static_cast<uint32_t>(multisample.rasterizationSamples) + 31) / 32;
+			key.addBytes(multisample.pSampleMask, maskWords * sizeof(VkSampleMask));
+		}
+		key.add(multisample.alphaToCoverageEnable);
+		key.add(multisample.alphaToOneEnable);
+
+		//depth stencil
+		bool depthStencil = createInfo.pDepthStencilState != nullptr;
+		key.add(depthStencil);
+		if (depthStencil) {
+			const auto& depth = *createInfo.pDepthStencilState;
+			key.add(depth.depthTestEnable);
+			key.add(depth.depthWriteEnable);
+			key.add(depth.depthCompareOp);
+			key.add(depth.depthBoundsTestEnable);
+			key.add(depth.stencilTestEnable);
+			for (const auto& stencil : { depth.front, depth.back }) {
+				key.add(stencil.failOp);
+				key.add(stencil.passOp);
+				key.add(stencil.depthFailOp);
+				key.add(stencil.compareOp);
+				key.add(stencil.compareMask);
+				key.add(stencil.writeMask);
+				key.add(stencil.reference);
+			}
+			key.add(depth.minDepthBounds);
+			key.add(depth.maxDepthBounds);
+		}
+
+		//blending
+		const auto& blend = *createInfo.pColorBlendState;
+		key.add(blend.logicOpEnable);
+		key.add(blend.logicOp);
+		key.add(blend.attachmentCount);
+		for (uint32_t i = 0; i < blend.attachmentCount; ++i) {
+			const auto& attachment = blend.pAttachments[i];
+			key.add(attachment.blendEnable);
+			key.add(attachment.srcColorBlendFactor);
+			key.add(attachment.dstColorBlendFactor);
+			key.add(attachment.colorBlendOp);
+			key.add(attachment.srcAlphaBlendFactor);
+			key.add(attachment.dstAlphaBlendFactor);
+			key.add(attachment.alphaBlendOp);
+			key.add(attachment.colorWriteMask);
+		}
+		for (float constant : blend.blendConstants) {
+			key.add(constant);
+		}
+
+		bool dynamic = createInfo.pDynamicState != nullptr;
+		key.add(dynamic);
+		if (dynamic) {
+			key.add(createInfo.pDynamicState->dynamicStateCount);
+			for (uint32_t i = 0; i < createInfo.pDynamicState->dynamicStateCount; ++i) {
+				key.add(createInfo.pDynamicState->pDynamicStates[i]);
+			}
+		}
+
+		//by content where known, a pipeline works with any compatible layout and render pass.
+		//Otherwise layouts come from getLayout, so equal layouts still share a handle
+		key.add(identity.mLayoutHash != 0);
+		if (identity.mLayoutHash != 0) {
+			key.add(identity.mLayoutHash);
+		}
+		else {
+			key.add(createInfo.layout);
+		}
+
+		key.add(identity.mRenderPassHash != 0);
+		if (identity.mRenderPassHash != 0) {
+			key.add(identity.mRenderPassHash);
+		}
+		else {
+			key.add(createInfo.renderPass);
+		}
+		key.add(createInfo.subpass);
+
+		return key;
+	}
+
+	template<typename T>
+	void PipelineStateCache::prune(std::unordered_multimap<uint64_t, std::pair<StateKey, std::weak_ptr<T>>>& entries) {
+		for (auto it = entries.begin(); it != entries.end();) {
+			if (it->second.second.expired()) {
+				it = entries.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+}
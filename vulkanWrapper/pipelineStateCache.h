@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../base.h"
+#include "pipelineCreationLog.h"
+
+namespace Tea::Wrapper {
+	//Byte key of a pipeline or layout description, pointers are followed so two descriptions with equal content but
+	//different arrays give the same key. Equal hashes are still compared byte for byte.
+	class StateKey {
+	public:
+		//scalars, enums and handles only: whole Vulkan structs would pull in padding and pointers
+		template<typename T>
+		void add(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T> && !std::is_class_v<T>, "StateKey::add takes scalars, enums and handles");
+			addBytes(&value, sizeof(T));
+		}
+
+		void addBytes(const void* data, size_t size);
+
+		void addString(const char* text);
+
+		[[nodiscard]] uint64_t getHash() const { return mHash; }
+
+		[[nodiscard]] const auto& getBytes() const { return mBytes; }
+
+		bool operator==(const StateKey& other) const { return mHash == other.mHash && mBytes == other.mBytes; }
+
+	private:
+		std::vector<uint8_t> mBytes{};
+		uint64_t mHash{ 14695981039346656037ull };	//FNV-1a offset basis
+	};
+
+	//A VkPipelineLayout shared by every Pipeline with the same layout description, destroyed with its last user
+	class SharedPipelineLayout {
+	public:
+		using Ptr = std::shared_ptr<SharedPipelineLayout>;
+
+		SharedPipelineLayout(VkDevice device, VkPipelineLayout layout) : mDevice(device), mLayout(layout) {}
+
+		~SharedPipelineLayout();
+
+		[[nodiscard]] auto getLayout() const { return mLayout; }
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		VkPipelineLayout mLayout{ VK_NULL_HANDLE };
+	};
+
+	//A VkPipeline shared by every Pipeline with the same state, destroyed with its last user.
+	//Keeps the layout it was created with, other users may only have a compatible one
+	class SharedPipeline {
+	public:
+		using Ptr = std::shared_ptr<SharedPipeline>;
+
+		SharedPipeline(VkDevice device, VkPipeline pipeline, const SharedPipelineLayout::Ptr& layout)
+			: mDevice(device), mPipeline(pipeline), mLayout(layout) {}
+
+		~SharedPipeline();
+
+		[[nodiscard]] auto getPipeline() const { return mPipeline; }
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		VkPipeline mPipeline{ VK_NULL_HANDLE };
+		SharedPipelineLayout::Ptr mLayout{ nullptr };
+	};
+
+	//what the handles in a pipeline create info stand for, so pipelines created from equal descriptions match
+	//even when their shader modules, render passes or layouts are different objects (see PipelineWarmup)
+	struct PipelineIdentity {
+		std::vector<uint64_t> mStageCodeHashes{};	//per stage, Shader::getCodeHash
+		uint64_t mRenderPassHash{ 0 };				//RenderPass::getDescriptionHash, 0: the handle is used
+		uint64_t mLayoutHash{ 0 };					//set layout bindings and push constants, 0: the handle is used
+
+		SharedPipelineLayout::Ptr mLayout{ nullptr };	//the object behind createInfo.layout
+
+		std::string mLabel{};		//names the pipeline in the creation log, not part of the key
+	};
+
+	struct PipelineStateCacheStats {
+		uint64_t mLayoutRequests{ 0 };
+		uint64_t mLayoutsCreated{ 0 };
+		uint64_t mPipelineRequests{ 0 };
+		uint64_t mPipelinesCreated{ 0 };
+	};
+
+	//Deduplicates pipelines and pipeline layouts: a description that matches a live object returns that object
+	//instead of compiling again. Entries are weak, an object nobody uses any more is destroyed as usual and
+	//compiled again (through the device's VkPipelineCache) if it is asked for later.
+	//Thread safe. Pipelines compile outside the lock, a request for a pipeline another thread is compiling
+	//waits for that compile instead of starting its own.
+	class PipelineStateCache {
+	public:
+		using Ptr = std::shared_ptr<PipelineStateCache>;
+		static Ptr create(VkDevice device, VkPipelineCache pipelineCache, bool creationFeedback) {
+			return std::make_shared<PipelineStateCache>(device, pipelineCache, creationFeedback);
+		}
+
+		//creationFeedback: VK_EXT_pipeline_creation_feedback is enabled on the device
+		PipelineStateCache(VkDevice device, VkPipelineCache pipelineCache, bool creationFeedback);
+
+		~PipelineStateCache() = default;
+
+		SharedPipelineLayout::Ptr getLayout(const VkPipelineLayoutCreateInfo& createInfo);
+
+		//identity.mStageCodeHashes[i] identifies the SPIR-V of createInfo.pStages[i], so the same shader loaded
+		//into two modules still matches. pNext chains are not part of the key and must be empty
+		SharedPipeline::Ptr getPipeline(const VkGraphicsPipelineCreateInfo& createInfo, const PipelineIdentity& identity);
+
+		[[nodiscard]] PipelineStateCacheStats getStats() const;
+
+		//every getPipeline call, with its timing and cache hits
+		[[nodiscard]] auto getCreationLog() const { return mCreationLog; }
+
+	private:
+		static StateKey makeLayoutKey(const VkPipelineLayoutCreateInfo& createInfo);
+
+		static StateKey makePipelineKey(const VkGraphicsPipelineCreateInfo& createInfo, const PipelineIdentity& identity);
+
+		//vkCreateGraphicsPipelines with creation feedback chained in when the device supports it
+		VkResult createPipeline(const VkGraphicsPipelineCreateInfo& createInfo, VkPipeline* pipeline, PipelineCreationRecord& record) const;
+
+		//drops entries whose object is gone, so the maps do not grow with every resize or reload
+		template<typename T>
+		static void prune(std::unordered_multimap<uint64_t, std::pair<StateKey, std::weak_ptr<T>>>& entries);
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		VkPipelineCache mPipelineCache{ VK_NULL_HANDLE };
+		bool mCreationFeedback{ false };
+
+		PipelineCreationLog::Ptr mCreationLog{ nullptr };
+
+		std::unordered_multimap<uint64_t, std::pair<StateKey, std::weak_ptr<SharedPipelineLayout>>> mLayouts{};
+		std::unordered_multimap<uint64_t, std::pair<StateKey, std::weak_ptr<SharedPipeline>>> mPipelines{};
+		std::unordered_multimap<uint64_t, std::pair<StateKey, std::shared_future<SharedPipeline::Ptr>>> mCompilingPipelines{};
+
+		PipelineStateCacheStats mStats{};
+
+		mutable std::mutex mMutex;
+	};
+}
@@ -0,0 +1,164 @@
+#include "pipelineWarmup.h"
+#include <filesystem>
+
+namespace Tea::Wrapper {
+
+	PipelineWarmup::PipelineWarmup(const Device::Ptr& device) {
+		mDevice = device;
+	}
+
+	void PipelineWarmup::start() {
+		for (const auto& description : mDevice->getPipelineManifest()->getLoadedDescriptions()) {
+			Pipeline::Ptr pipeline{ nullptr };
+			try {
+				pipeline = makePipeline(description);
+			}
+			catch (const std::exception& e) {
+				std::cerr << "Error: pipeline warm-up skipped a description: " << e.what() << std::endl;
+			}
+
+			if (pipeline == nullptr) {
+				mSkippedCount++;
+				continue;
+			}
+
+			mPipelines.push_back(pipeline);
+		}
+	}
+
+	void PipelineWarmup::wait() {
+		std::vector<Pipeline::Ptr> warmed{};
+		for (const auto& pipeline : mPipelines) {
+			try {
+				pipeline->wait();
+				warmed.push_back(pipeline);
+			}
+			catch (const std::exception& e) {
+				std::cerr << "Error: pipeline warm-up failed: " << e.what() << std::endl;
+				mFailedCount++;
+			}
+		}
+
+		mPipelines = warmed;
+		mWarmedCount = static_cast<uint32_t>(mPipelines.size());
+	}
+
+	Pipeline::Ptr PipelineWarmup::makePipeline(const PipelineDescription& description) {
+		std::vector<Shader::Ptr> shaders{};
+		for (const auto& stage : description.mStages) {
+			auto shader = getShader(stage);
+			if (shader == nullptr) {
+				return nullptr;
+			}
+			shaders.push_back(shader);
+		}
+
+		std::vector<DescriptorSetLayout::Ptr> setLayouts{};
+		for (const auto& bindings : description.mSetLayouts) {
+			setLayouts.push_back(mDevice->getDescriptorSetLayoutCache()->get(mDevice, bindings));
+		}
+
+		auto pipeline = Pipeline::create(mDevice, getRenderPass(description));
+		pipeline->setRecorded(false);
+		pipeline->setShaderGroup(shaders);
+		pipeline->setDescriptorSetLayouts(setLayouts);
+
+		//the description keeps no sType, the ones Pipeline set stay
+		pipeline->mVertexInputState.vertexBindingDescriptionCount = static_cast<uint32_t>(description.mVertexBindings.size());
+		pipeline->mVertexInputState.pVertexBindingDescriptions = description.mVertexBindings.data();
+		pipeline->mVertexInputState.vertexAttributeDescriptionCount = static_cast<uint32_t>(description.mVertexAttributes.size());
+		pipeline->mVertexInputState.pVertexAttributeDescriptions = description.mVertexAttributes.data();
+
+		auto setState = [](auto& target, const auto& source) {
+			auto sType = target.sType;
+			target = source;
+			target.sType = sType;
+			target.pNext = nullptr;
+		};
+		setState(pipeline->mAssemblyState, description.mAssemblyState);
+		setState(pipeline->mRasterState, description.mRasterState);
+		setState(pipeline->mSampleState, description.mSampleState);
+		setState(pipeline->mDepthStencilState, description.mDepthStencilState);
+		setState(pipeline->mBlendState, description.mBlendState);
+
+		pipeline->mSampleState.pSampleMask = description.mSampleMask.empty() ? nullptr : description.mSampleMask.data();
+
+		for (const auto& blendAttachment : description.mBlendAttachments) {
+			pipeline->pushBlendAttachment(blendAttachment);
+		}
+
+		pipeline->setViewports(description.mViewports);
+		pipeline->setScissors(description.mScissors);
+		pipeline->setDynamicStates(description.mDynamicStates);
+
+		//checked like any other pipeline's ranges, a damaged or foreign manifest throws here and is skipped
+		pipeline->setPushConstantRanges(description.mPushConstantRanges);
+
+		//the state is copied here, the pointers into the description must not outlive it
+		pipeline->buildAsync();
+
+		pipeline->mVertexInputState.vertexBindingDescriptionCount = 0;
+		pipeline->mVertexInputState.pVertexBindingDescriptions = nullptr;
+		pipeline->mVertexInputState.vertexAttributeDescriptionCount = 0;
+		pipeline->mVertexInputState.pVertexAttributeDescriptions = nullptr;
+		pipeline->mSampleState.pSampleMask = nullptr;
+
+		return pipeline;
+	}
+
+	Shader::Ptr PipelineWarmup::getShader(const ShaderStageDescription& stage) {
+		std::string key = stage.mFileName + "|" + stage.mEntryPoint + "|" + std::to_string(static_cast<uint32_t>(stage.mStage))
+			+ "|" + stage.mSpecialization.toString();
+
+		auto it = mShaders.find(key);
+		if (it == mShaders.end()) {
+			if (!std::filesystem::exists(stage.mFileName)) {
+				return nullptr;
+			}
+			it = mShaders.emplace(key, Shader::create(mDevice, stage.mFileName, stage.mStage, stage.mEntryPoint, stage.mSpecialization)).first;
+		}
+
+		//a rebuilt shader gives a different pipeline than the recorded one, the application compiles that one itself
+		if (it->second->getCodeHash() != stage.mCodeHash) {
+			return nullptr;
+		}
+
+		return it->second;
+	}
+
+	RenderPass::Ptr PipelineWarmup::getRenderPass(const PipelineDescription& description) {
+		auto renderPass = RenderPass::create(mDevice);
+
+		for (const auto& attachment : description.mAttachments) {
+			renderPass->addAttachment(attachment);
+		}
+
+		for (const auto& subPassDescription : description.mSubPasses) {
+			SubPass subPass{};
+			for (const auto& ref : subPassDescription.mColorAttachments) {
+				subPass.addColorAttachmentReference(ref);
+			}
+			for (const auto& ref : subPassDescription.mInputAttachments) {
+				subPass.addInputAttachmentReference(ref);
+			}
+			subPass.setDepthStencilAttachmentReference(subPassDescription.mDepthStencilAttachment);
+
+			renderPass->addSubPass(subPass);
+		}
+
+		for (const auto& dependency : description.mDependencies) {
+			renderPass->addDependency(dependency);
+		}
+
+		//the description hash is only known once built, a duplicate render pass is cheap and dropped right away
+		renderPass->buildRenderPass();
+
+		auto it = mRenderPasses.find(renderPass->getDescriptionHash());
+		if (it != mRenderPasses.end()) {
+			return it->second;
+		}
+
+		mRenderPasses[renderPass->getDescriptionHash()] = renderPass;
+		return renderPass;
+	}
+}
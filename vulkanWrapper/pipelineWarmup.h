@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+#include "shader.h"
+#include "renderPass.h"
+#include "descriptorSetLayout.h"
+#include "pipeline.h"
+#include "pipelineManifest.h"
+
+namespace Tea::Wrapper {
+	//Compiles every pipeline the previous run recorded in the device's PipelineManifest, in parallel on the
+	//PipelineCompiler, so the application finds them in the PipelineStateCache instead of compiling on first use.
+	//Warm-up pipelines are matched by content: the application's own Pipelines get the same VkPipeline as long as
+	//they use DescriptorSetLayout wrappers (Pipeline::setDescriptorSetLayouts). Keep the warm-up alive as long as
+	//its pipelines should stay cached.
+
+	class PipelineWarmup {
+	public:
+		using Ptr = std::shared_ptr<PipelineWarmup>;
+		static Ptr create(const Device::Ptr& device) { return std::make_shared<PipelineWarmup>(device); }
+
+		PipelineWarmup(const Device::Ptr& device);
+
+		~PipelineWarmup() = default;
+
+		//queues the recorded descriptions and returns, descriptions whose shader files are gone or changed are skipped
+		void start();
+
+		//blocks until every queued pipeline has compiled, a failed pipeline is counted instead of thrown
+		void wait();
+
+		[[nodiscard]] auto getWarmedCount() const { return mWarmedCount; }
+		[[nodiscard]] auto getSkippedCount() const { return mSkippedCount; }
+		[[nodiscard]] auto getFailedCount() const { return mFailedCount; }
+
+	private:
+		//nullptr if the description can not be built in this run
+		Pipeline::Ptr makePipeline(const PipelineDescription& description);
+
+		Shader::Ptr getShader(const ShaderStageDescription& stage);
+
+		RenderPass::Ptr getRenderPass(const PipelineDescription& description);
+
+	private:
+		Device::Ptr mDevice{ nullptr };
+
+		std::vector<Pipeline::Ptr> mPipelines{};
+
+		//shared between descriptions, most pipelines differ in a few states only. Set layouts come from the device's cache
+		std::map<std::string, Shader::Ptr> mShaders{};
+		std::unordered_map<uint64_t, RenderPass::Ptr> mRenderPasses{};
+
+		uint32_t mWarmedCount{ 0 };
+		uint32_t mSkippedCount{ 0 };
+		uint32_t mFailedCount{ 0 };
+	};
+}
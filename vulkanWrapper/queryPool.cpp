@@ -0,0 +1,55 @@
+#include "queryPool.h"
+
+namespace Tea::Wrapper {
+
+	QueryPool::QueryPool(const Device::Ptr& device, uint32_t queryCount, VkQueryType queryType) {
+		mDevice = device;
+		mQueryCount = queryCount;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+		mTimestampPeriod = properties.limits.timestampPeriod;
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(mDevice->getPhysicalDevice(), &queueFamilyCount, nullptr);
+
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(mDevice->getPhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+
+		mTimestampValidBits = queueFamilies[mDevice->getGraphicQueueFamily().value()].timestampValidBits;
+
+		VkQueryPoolCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		createInfo.queryType = queryType;
+		createInfo.queryCount = mQueryCount;
+
+		if (vkCreateQueryPool(mDevice->getDevice(), &createInfo, nullptr, &mQueryPool) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create query pool");
+		}
+	}
+
+	QueryPool::~QueryPool() {
+		if (mQueryPool != VK_NULL_HANDLE) {
+			vkDestroyQueryPool(mDevice->getDevice(), mQueryPool, nullptr);
+		}
+	}
+
+	bool QueryPool::getResults(uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& results) const {
+		results.resize(queryCount);
+
+		VkResult result = vkGetQueryPoolResults(
+			mDevice->getDevice(), mQueryPool,
+			firstQuery, queryCount,
+			results.size() * sizeof(uint64_t), results.data(),
+			sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+		return result == VK_SUCCESS;
+	}
+
+	double QueryPool::toNanoseconds(uint64_t begin, uint64_t end) const {
+		//only the low timestampValidBits bits are meaningful
+		uint64_t mask = mTimestampValidBits >= 64 ? ~0ull : ((1ull << mTimestampValidBits) - 1);
+
+		return static_cast<double>((end - begin) & mask) * mTimestampPeriod;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+
+namespace Tea::Wrapper {
+	//Timestamp queries for measuring GPU time: write two timestamps around the work with CommandBuffer::writeTimestamp
+	//and read them back once the submission has completed. Queries have to be reset (CommandBuffer::resetQueryPool)
+	//before every reuse.
+
+	class QueryPool {
+	public:
+		using Ptr = std::shared_ptr<QueryPool>;
+		static Ptr create(const Device::Ptr& device, uint32_t queryCount, VkQueryType queryType = VK_QUERY_TYPE_TIMESTAMP) {
+			return std::make_shared<QueryPool>(device, queryCount, queryType);
+		}
+
+		QueryPool(const Device::Ptr& device, uint32_t queryCount, VkQueryType queryType = VK_QUERY_TYPE_TIMESTAMP);
+
+		~QueryPool();
+
+		//false if any of the queries has no result yet
+		bool getResults(uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& results) const;
+
+		//nanoseconds between two timestamps of the graphics queue
+		[[nodiscard]] double toNanoseconds(uint64_t begin, uint64_t end) const;
+
+		//some queues (and some software drivers) do not write timestamps at all
+		[[nodiscard]] bool isTimestampSupported() const { return mTimestampValidBits > 0; }
+
+		[[nodiscard]] auto getQueryPool() const { return mQueryPool; }
+
+		[[nodiscard]] auto getQueryCount() const { return mQueryCount; }
+
+	private:
+		VkQueryPool mQueryPool{ VK_NULL_HANDLE };
+		uint32_t mQueryCount{ 0 };
+
+		float mTimestampPeriod{ 1.0f };
+		uint32_t mTimestampValidBits{ 0 };
+
+		Device::Ptr mDevice{ nullptr };
+	};
+}
@@ -0,0 +1,34 @@
+#include "reflectedLayout.h"
+
+namespace Tea::Wrapper {
+
+	ReflectedLayout::ReflectedLayout(const Device::Ptr& device, const std::vector<Shader::Ptr>& shaders, const std::set<DynamicBinding>& dynamicBindings) {
+		std::vector<ShaderReflection> reflections{};
+		for (const auto& shader : shaders) {
+			reflections.push_back(shader->getReflection());
+		}
+		mReflection = ShaderReflection::merge(reflections);
+
+		for (const auto& bindings : mReflection.getSetLayoutBindings(dynamicBindings)) {
+			mSetLayouts.push_back(device->getDescriptorSetLayoutCache()->get(device, bindings));
+		}
+
+		mPushConstantRanges = mReflection.getPushConstantRanges();
+	}
+
+	void ReflectedLayout::checkVertexInput(const std::vector<VkVertexInputAttributeDescription>& attributes) const {
+		for (const auto& input : mReflection.getVertexInputs()) {
+			auto attribute = std::find_if(attributes.begin(), attributes.end(), [&input](const VkVertexInputAttributeDescription& description) {
+				return description.location == input.mLocation;
+			});
+
+			if (attribute == attributes.end()) {
+				throw std::runtime_error("Error: no vertex attribute for shader input " + input.mName + " at location " + std::to_string(input.mLocation));
+			}
+
+			if (attribute->format != input.mFormat) {
+				throw std::runtime_error("Error: vertex attribute at location " + std::to_string(input.mLocation) + " does not match the format of shader input " + input.mName);
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+#include "shader.h"
+#include "descriptorSetLayout.h"
+#include "shaderReflection.h"
+
+namespace Tea::Wrapper {
+	//The descriptor set layouts and push constant ranges a group of shaders declares, merged across their stages.
+	//Set layouts come from the device's DescriptorSetLayoutCache, so every ReflectedLayout of equal shaders uses the
+	//same ones and pipelines built with it (Pipeline::setReflectedLayout) share their VkPipelineLayout.
+
+	class ReflectedLayout {
+	public:
+		using Ptr = std::shared_ptr<ReflectedLayout>;
+		static Ptr create(const Device::Ptr& device, const std::vector<Shader::Ptr>& shaders, const std::set<DynamicBinding>& dynamicBindings = {}) {
+			return std::make_shared<ReflectedLayout>(device, shaders, dynamicBindings);
+		}
+
+		//throws if a shader could not be reflected or the stages disagree on a binding
+		ReflectedLayout(const Device::Ptr& device, const std::vector<Shader::Ptr>& shaders, const std::set<DynamicBinding>& dynamicBindings);
+
+		~ReflectedLayout() = default;
+
+		[[nodiscard]] const auto& getReflection() const { return mReflection; }
+
+		//index = set number
+		[[nodiscard]] const auto& getSetLayouts() const { return mSetLayouts; }
+
+		[[nodiscard]] const auto& getPushConstantRanges() const { return mPushConstantRanges; }
+
+		//throws unless every vertex input of the vertex shader is fed by an attribute of the same format
+		void checkVertexInput(const std::vector<VkVertexInputAttributeDescription>& attributes) const;
+
+	private:
+		ShaderReflection mReflection{};
+
+		std::vector<DescriptorSetLayout::Ptr> mSetLayouts{};
+		std::vector<VkPushConstantRange> mPushConstantRanges{};
+	};
+}
@@ -76,7 +76,9 @@ namespace Tea::Wrapper {
 
 		std::vector<VkSubpassDescription> subpassDescriptions{};
 
+		//rebuilt so the references point into our own copies, not into the subpasses passed to addSubPass
 		for (int i = 0; i < mSubPasses.size(); ++i) {
+			mSubPasses[i].buildSubPassDescription();
 			subpassDescriptions.push_back(mSubPasses[i].getSubPassDescription());
 		}
 
@@ -86,6 +88,58 @@ namespace Tea::Wrapper {
 		if (vkCreateRenderPass(mDevice->getDevice(), &renderpassCreateInfo, nullptr, &mRenderPass) != VK_SUCCESS) {
 			throw std::runtime_error("Error: failed to create renderPass");
 		}
+
+		mDescriptionHash = makeDescriptionHash();
+	}
+
+	uint64_t RenderPass::makeDescriptionHash() const {
+		StateKey key{};
+
+		key.add(mAttachmentDescriptions.size());
+		for (const auto& attachment : mAttachmentDescriptions) {
+			key.add(attachment.flags);
+			key.add(attachment.format);
+			key.add(attachment.samples);
+			key.add(attachment.loadOp);
+			key.add(attachment.storeOp);
+			key.add(attachment.stencilLoadOp);
+			key.add(attachment.stencilStoreOp);
+			key.add(attachment.initialLayout);
+			key.add(attachment.finalLayout);
+		}
+
+		auto addReference = [&key](const VkAttachmentReference& reference) {
+			key.add(reference.attachment);
+			key.add(reference.layout);
+		};
+
+		key.add(mSubPasses.size());
+		for (const auto& subPass : mSubPasses) {
+			key.add(subPass.getColorAttachmentReferences().size());
+			for (const auto& reference : subPass.getColorAttachmentReferences()) {
+				addReference(reference);
+			}
+
+			key.add(subPass.getInputAttachmentReferences().size());
+			for (const auto& reference : subPass.getInputAttachmentReferences()) {
+				addReference(reference);
+			}
+
+			addReference(subPass.getDepthStencilAttachmentReference());
+		}
+
+		key.add(mDependencies.size());
+		for (const auto& dependency : mDependencies) {
+			key.add(dependency.srcSubpass);
+			key.add(dependency.dstSubpass);
+			key.add(dependency.srcStageMask);
+			key.add(dependency.dstStageMask);
+			key.add(dependency.srcAccessMask);
+			key.add(dependency.dstAccessMask);
+			key.add(dependency.dependencyFlags);
+		}
+
+		return key.getHash();
 	}
 
 }
\ No newline at end of file
@@ -32,6 +32,12 @@ namespace Tea::Wrapper {
 		void buildSubPassDescription();
 
 		[[nodiscard]] auto getSubPassDescription() const { return mSubPassDescription; }
+
+		[[nodiscard]] const auto& getColorAttachmentReferences() const { return mColorAttachmentReferences; }
+		[[nodiscard]] const auto& getInputAttachmentReferences() const { return mInputAttachmentReferences; }
+
+		//layout VK_IMAGE_LAYOUT_UNDEFINED: no depth stencil attachment
+		[[nodiscard]] const auto& getDepthStencilAttachmentReference() const { return mDepthStencilAttachmentReference; }
 	private:
 		//subpuss == description + reference
 		VkSubpassDescription mSubPassDescription{};
@@ -68,6 +74,16 @@ namespace Tea::Wrapper {
 
 		[[nodiscard]] auto getRenderPass() const { return mRenderPass; }
 
+		[[nodiscard]] const auto& getSubPasses() const { return mSubPasses; }
+		[[nodiscard]] const auto& getAttachments() const { return mAttachmentDescriptions; }
+		[[nodiscard]] const auto& getDependencies() const { return mDependencies; }
+
+		//hash of everything the render pass was built from, equal render passes built twice give equal pipelines
+		[[nodiscard]] auto getDescriptionHash() const { return mDescriptionHash; }
+
+	private:
+		uint64_t makeDescriptionHash() const;
+
 	private:
 		VkRenderPass mRenderPass{ VK_NULL_HANDLE };
 		//each mSubPass contains it attachmentdescrtption
@@ -77,6 +93,8 @@ namespace Tea::Wrapper {
 
 		std::vector<VkSubpassDependency> mDependencies{};
 
+		uint64_t mDescriptionHash{ 0 };
+
 		Device::Ptr mDevice{ nullptr };
 	};
 }
\ No newline at end of file
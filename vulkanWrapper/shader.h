@@ -2,28 +2,47 @@
 
 #include "../base.h"
 #include "device.h"
+#include "specializationConstants.h"
 
 namespace Tea::Wrapper {
 	class Shader {
 	public:
 		using Ptr = std::shared_ptr<Shader>;
-		static Ptr create(const Device::Ptr& device, const std::string& fileName, VkShaderStageFlagBits shaderStage, const std::string& entryPoint) {
-			return std::make_shared<Shader>(device, fileName, shaderStage, entryPoint);
+		static Ptr create(const Device::Ptr& device, const std::string& fileName, VkShaderStageFlagBits shaderStage, const std::string& entryPoint,
+			const SpecializationConstants& specialization = {}) {
+			return std::make_shared<Shader>(device, fileName, shaderStage, entryPoint, specialization);
 		}
-		Shader(const Device::Ptr& device, const std::string& fileName, VkShaderStageFlagBits shaderStage, const std::string& entryPoint);
 
-		~Shader();
+		//shaders of one file with different specialization share the module but give different pipelines
+		Shader(const Device::Ptr& device, const std::string& fileName, VkShaderStageFlagBits shaderStage, const std::string& entryPoint,
+			const SpecializationConstants& specialization = {});
+
+		~Shader() = default;
 
 
 		[[nodiscard]] auto getShaderStage() const { return mShaderStage; }
 		[[nodiscard]] auto& getShaderEntryPoint() const { return mEntryPoint; }
-		[[nodiscard]] auto getShaderModule() const { return mShaderModule; }
+		//shared with every Shader of the same code, see ShaderLibrary
+		[[nodiscard]] auto getShaderModule() const { return mModule->getModule(); }
+		[[nodiscard]] const auto& getSharedModule() const { return mModule; }
+
+		//hash of the SPIR-V, equal code loaded twice gives the same pipeline (see PipelineStateCache)
+		[[nodiscard]] auto getCodeHash() const { return mModule->getCodeHash(); }
+
+		[[nodiscard]] const auto& getFileName() const { return mFileName; }
+
+		[[nodiscard]] const auto& getSpecialization() const { return mSpecialization; }
+
+		//bindings, push constants and vertex inputs the code declares, throws if it could not be reflected
+		[[nodiscard]] const auto& getReflection() const { return mModule->getReflection(); }
 
 	private:
-		VkShaderModule mShaderModule{ VK_NULL_HANDLE };
+		ShaderModule::Ptr mModule{ nullptr };
 
 		Device::Ptr mDevice{ nullptr };
 		std::string mEntryPoint;
+		std::string mFileName;
 		VkShaderStageFlagBits mShaderStage;
+		SpecializationConstants mSpecialization{};
 	};
 }
\ No newline at end of file
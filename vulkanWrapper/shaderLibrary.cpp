@@ -0,0 +1,221 @@
+#include "shaderLibrary.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Tea::Wrapper {
+
+	namespace {
+		//read only view of a whole file, unmapped when it goes out of scope
+		class MappedFile {
+		public:
+			explicit MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+				mFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (mFile == INVALID_HANDLE_VALUE) {
+					return;
+				}
+
+				LARGE_INTEGER size{};
+				if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) {
+					return;
+				}
+				mSize = static_cast<size_t>(size.QuadPart);
+
+				mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mMapping == nullptr) {
+					return;
+				}
+				mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+				mFile = open(fileName.c_str(), O_RDONLY);
+				if (mFile < 0) {
+					return;
+				}
+
+				struct stat status {};
+				if (fstat(mFile, &status) != 0 || status.st_size == 0) {
+					return;
+				}
+				mSize = static_cast<size_t>(status.st_size);
+
+				void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+				mData = data != MAP_FAILED ? data : nullptr;
+#endif
+			}
+
+			~MappedFile() {
+#ifdef _WIN32
+				if (mData != nullptr) {
+					UnmapViewOfFile(mData);
+				}
+				if (mMapping != nullptr) {
+					CloseHandle(mMapping);
+				}
+				if (mFile != INVALID_HANDLE_VALUE) {
+					CloseHandle(mFile);
+				}
+#else
+				if (mData != nullptr) {
+					munmap(mData, mSize);
+				}
+				if (mFile >= 0) {
+					close(mFile);
+				}
+#endif
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			//page aligned, so it can be passed to vkCreateShaderModule as is
+			[[nodiscard]] const void* getData() const { return mData; }
+			[[nodiscard]] size_t getSize() const { return mData != nullptr ? mSize : 0; }
+
+		private:
+#ifdef _WIN32
+			HANDLE mFile{ INVALID_HANDLE_VALUE };
+			HANDLE mMapping{ nullptr };
+#else
+			int mFile{ -1 };
+#endif
+			void* mData{ nullptr };
+			size_t mSize{ 0 };
+		};
+
+		//FNV-1a like StateKey, so the hash equals what Shader::getCodeHash always reported
+		uint64_t hashCode(const void* data, size_t size) {
+			auto bytes = static_cast<const uint8_t*>(data);
+
+			uint64_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < size; ++i) {
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+
+	ShaderModule::~ShaderModule() {
+		if (mModule != VK_NULL_HANDLE) {
+			vkDestroyShaderModule(mDevice, mModule, nullptr);
+		}
+	}
+
+	const ShaderReflection& ShaderModule::getReflection() const {
+		if (!mReflection.has_value()) {
+			throw std::runtime_error(mReflectionError);
+		}
+		return mReflection.value();
+	}
+
+	ShaderLibrary::ShaderLibrary(VkDevice device) {
+		mDevice = device;
+	}
+
+	ShaderModule::Ptr ShaderLibrary::load(const std::string& fileName) {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStats.mRequests++;
+
+			auto it = mModulesByPath.find(fileName);
+			if (it != mModulesByPath.end()) {
+				return it->second;
+			}
+		}
+
+		//mapped and hashed outside the lock, two threads loading the same new file end up with one module below
+		auto module = createModule(fileName);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto it = mModulesByPath.find(fileName);
+		if (it != mModulesByPath.end()) {
+			return it->second;
+		}
+
+		mModulesByPath[fileName] = module;
+		return module;
+	}
+
+	void ShaderLibrary::reload() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mModulesByPath.clear();
+		mModulesByHash.clear();
+	}
+
+	ShaderLibraryStats ShaderLibrary::getStats() const {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mStats;
+	}
+
+	std::optional<uint64_t> ShaderLibrary::getFileHash(const std::string& fileName) {
+		MappedFile file(fileName);
+		if (file.getSize() == 0) {
+			return std::nullopt;
+		}
+
+		return hashCode(file.getData(), file.getSize());
+	}
+
+	ShaderModule::Ptr ShaderLibrary::createModule(const std::string& fileName) {
+		MappedFile file(fileName);
+		if (file.getSize() == 0) {
+			throw std::runtime_error("Error: failed to open shader file " + fileName);
+		}
+
+		if (file.getSize() % sizeof(uint32_t) != 0) {
+			throw std::runtime_error("Error: shader file is no SPIR-V " + fileName);
+		}
+
+		uint64_t codeHash = hashCode(file.getData(), file.getSize());
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStats.mFilesMapped++;
+
+			//the same code under another path, e.g. a copied or renamed file
+			auto it = mModulesByHash.find(codeHash);
+			if (it != mModulesByHash.end() && it->second->getCodeSize() == file.getSize()) {
+				return it->second;
+			}
+		}
+
+		VkShaderModuleCreateInfo shaderCreateInfo{};
+		shaderCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		shaderCreateInfo.codeSize = file.getSize();
+		shaderCreateInfo.pCode = static_cast<const uint32_t*>(file.getData());
+
+		VkShaderModule shaderModule{ VK_NULL_HANDLE };
+		if (vkCreateShaderModule(mDevice, &shaderCreateInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create shader module " + fileName);
+		}
+
+		auto module = std::make_shared<ShaderModule>(mDevice, shaderModule, codeHash, file.getSize());
+
+		try {
+			module->setReflection(ShaderReflection::reflect(static_cast<const uint32_t*>(file.getData()), file.getSize() / sizeof(uint32_t)));
+		}
+		catch (const std::exception& e) {
+			module->setReflectionError(std::string(e.what()) + " (" + fileName + ")");
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto it = mModulesByHash.find(codeHash);
+		if (it != mModulesByHash.end() && it->second->getCodeSize() == file.getSize()) {
+			//another thread was faster, its module is used and this one destroyed
+			return it->second;
+		}
+
+		mStats.mModulesCreated++;
+		mModulesByHash[codeHash] = module;
+		return module;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../base.h"
+#include "shaderReflection.h"
+
+namespace Tea::Wrapper {
+	//A VkShaderModule shared by every Shader loaded from the same SPIR-V, destroyed with the ShaderLibrary
+	class ShaderModule {
+	public:
+		using Ptr = std::shared_ptr<ShaderModule>;
+
+		ShaderModule(VkDevice device, VkShaderModule module, uint64_t codeHash, size_t codeSize)
+			: mDevice(device), mModule(module), mCodeHash(codeHash), mCodeSize(codeSize) {}
+
+		//reflected while the file is mapped. A module that can not be reflected still loads, getReflection throws then
+		void setReflection(const ShaderReflection& reflection) { mReflection = reflection; }
+		void setReflectionError(const std::string& error) { mReflectionError = error; }
+
+		~ShaderModule();
+
+		[[nodiscard]] auto getModule() const { return mModule; }
+		[[nodiscard]] auto getCodeHash() const { return mCodeHash; }
+		[[nodiscard]] auto getCodeSize() const { return mCodeSize; }
+
+		[[nodiscard]] const ShaderReflection& getReflection() const;
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		VkShaderModule mModule{ VK_NULL_HANDLE };
+		uint64_t mCodeHash{ 0 };
+		size_t mCodeSize{ 0 };
+
+		std::optional<ShaderReflection> mReflection{};
+		std::string mReflectionError{};
+	};
+
+	struct ShaderLibraryStats {
+		uint64_t mRequests{ 0 };
+		uint64_t mFilesMapped{ 0 };
+		uint64_t mModulesCreated{ 0 };
+	};
+
+	//Loads every SPIR-V file once: the file is memory mapped, hashed and turned into a module, later requests for the
+	//same path are answered from memory. Files with equal content share one module.
+	//Modules are kept until the library is destroyed or reload() is called, so rebuilding pipelines
+	//(e.g. on a swapchain recreation) never touches the filesystem.
+	//Thread safe.
+	class ShaderLibrary {
+	public:
+		using Ptr = std::shared_ptr<ShaderLibrary>;
+		static Ptr create(VkDevice device) { return std::make_shared<ShaderLibrary>(device); }
+
+		explicit ShaderLibrary(VkDevice device);
+
+		~ShaderLibrary() = default;
+
+		//throws if the file can not be read or is no SPIR-V
+		ShaderModule::Ptr load(const std::string& fileName);
+
+		//forgets the paths, the next load reads the files again (e.g. after shaders were recompiled).
+		//Modules still used by a Shader stay alive through it
+		void reload();
+
+		[[nodiscard]] ShaderLibraryStats getStats() const;
+
+		//the hash a module loaded from the file now would get, nullopt if the file can not be read
+		static std::optional<uint64_t> getFileHash(const std::string& fileName);
+
+	private:
+		ShaderModule::Ptr createModule(const std::string& fileName);
+
+	private:
+		VkDevice mDevice{ VK_NULL_HANDLE };
+
+		std::unordered_map<std::string, ShaderModule::Ptr> mModulesByPath{};
+		std::unordered_map<uint64_t, ShaderModule::Ptr> mModulesByHash{};
+
+		ShaderLibraryStats mStats{};
+
+		mutable std::mutex mMutex;
+	};
+}
@@ -0,0 +1,532 @@
+#include "shaderReflection.h"
+
+namespace Tea::Wrapper {
+
+	namespace {
+		//the subset of the SPIR-V specification reflection needs
+		constexpr uint32_t SpirvMagic = 0x07230203;
+		constexpr size_t SpirvHeaderWords = 5;
+
+		enum SpirvOp : uint16_t {
+			OpName = 5,
+			OpEntryPoint = 15,
+			OpTypeBool = 20,
+			OpTypeInt = 21,
+			OpTypeFloat = 22,
+			OpTypeVector = 23,
+			OpTypeMatrix = 24,
+			OpTypeImage = 25,
+			OpTypeSampler = 26,
+			OpTypeSampledImage = 27,
+			OpTypeArray = 28,
+			OpTypeRuntimeArray = 29,
+			OpTypeStruct = 30,
+			OpTypePointer = 32,
+			OpConstant = 43,
+			OpSpecConstant = 50,
+			OpVariable = 59,
+			OpDecorate = 71,
+			OpMemberDecorate = 72,
+		};
+
+		enum SpirvDecoration : uint32_t {
+			DecorationBlock = 2,
+			DecorationBufferBlock = 3,
+			DecorationArrayStride = 6,
+			DecorationMatrixStride = 7,
+			DecorationBuiltIn = 11,
+			DecorationLocation = 30,
+			DecorationBinding = 33,
+			DecorationDescriptorSet = 34,
+			DecorationOffset = 35,
+		};
+
+		enum SpirvStorageClass : uint32_t {
+			StorageClassUniformConstant = 0,
+			StorageClassInput = 1,
+			StorageClassUniform = 2,
+			StorageClassPushConstant = 9,
+			StorageClassStorageBuffer = 12,
+		};
+
+		enum SpirvDim : uint32_t {
+			DimBuffer = 5,
+			DimSubpassData = 6,
+		};
+
+		struct SpirvType {
+			uint16_t				mOp{ 0 };
+			std::vector<uint32_t>	mOperands{};	//everything after the result id
+		};
+
+		struct SpirvDecorations {
+			std::optional<uint32_t>	mSet{};
+			std::optional<uint32_t>	mBinding{};
+			std::optional<uint32_t>	mLocation{};
+			uint32_t				mArrayStride{ 0 };
+			bool					mBuiltIn{ false };
+			bool					mBlock{ false };
+			bool					mBufferBlock{ false };
+		};
+
+		struct SpirvMemberDecorations {
+			uint32_t	mOffset{ 0 };
+			uint32_t	mMatrixStride{ 0 };
+		};
+
+		struct SpirvVariable {
+			uint32_t mId{ 0 };
+			uint32_t mType{ 0 };		//the pointee, not the pointer
+			uint32_t mStorageClass{ 0 };
+		};
+
+		class SpirvModule {
+		public:
+			SpirvModule(const uint32_t* code, size_t wordCount) {
+				if (code == nullptr || wordCount < SpirvHeaderWords || code[0] != SpirvMagic) {
+					throw std::runtime_error("Error: shader code is no SPIR-V");
+				}
+
+				std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> pointers{};
+				std::vector<std::pair<uint32_t, uint32_t>> variables{};
+
+				for (size_t offset = SpirvHeaderWords; offset < wordCount;) {
+					auto op = static_cast<uint16_t>(code[offset] & 0xFFFF);
+					auto length = static_cast<size_t>(code[offset] >> 16);
+					if (length == 0 || offset + length > wordCount) {
+						throw std::runtime_error("Error: damaged SPIR-V instruction");
+					}
+
+					const uint32_t* words = code + offset + 1;
+					size_t count = length - 1;
+
+					switch (op) {
+					case OpName:
+						if (count >= 2) {
+							mNames[words[0]] = readString(words + 1, count - 1);
+						}
+						break;
+					case OpEntryPoint:
+						//a module may hold several, the first one is the one reflected
+						if (count >= 1 && !mExecutionModel.has_value()) {
+							mExecutionModel = words[0];
+						}
+						break;
+					case OpTypeBool:
+					case OpTypeInt:
+					case OpTypeFloat:
+					case OpTypeVector:
+					case OpTypeMatrix:
+					case OpTypeImage:
+					case OpTypeSampler:
+					case OpTypeSampledImage:
+					case OpTypeArray:
+					case OpTypeRuntimeArray:
+					case OpTypeStruct:
+						if (count >= 1) {
+							mTypes[words[0]] = { op, std::vector<uint32_t>(words + 1, words + count) };
+						}
+						break;
+					case OpTypePointer:
+						if (count >= 3) {
+							pointers[words[0]] = { words[1], words[2] };
+						}
+						break;
+					case OpConstant:
+					case OpSpecConstant:
+						//array lengths, a specialized length keeps its default here
+						if (count >= 3) {
+							mConstants[words[1]] = words[2];
+						}
+						break;
+					case OpVariable:
+						if (count >= 3) {
+							variables.emplace_back(words[1], words[0]);
+						}
+						break;
+					case OpDecorate:
+						if (count >= 2) {
+							decorate(words[0], words[1], count >= 3 ? words[2] : 0);
+						}
+						break;
+					case OpMemberDecorate:
+						if (count >= 3) {
+							auto& member = mMemberDecorations[{ words[0], words[1] }];
+							if (words[2] == DecorationOffset && count >= 4) {
+								member.mOffset = words[3];
+							}
+							else if (words[2] == DecorationMatrixStride && count >= 4) {
+								member.mMatrixStride = words[3];
+							}
+						}
+						break;
+					default:
+						break;
+					}
+
+					offset += length;
+				}
+
+				for (const auto& [id, pointerType] : variables) {
+					auto pointer = pointers.find(pointerType);
+					if (pointer == pointers.end()) {
+						throw std::runtime_error("Error: SPIR-V variable without pointer type");
+					}
+
+					mVariables.push_back({ id, pointer->second.second, pointer->second.first });
+				}
+			}
+
+			[[nodiscard]] const SpirvType& getType(uint32_t id) const {
+				auto it = mTypes.find(id);
+				if (it == mTypes.end()) {
+					throw std::runtime_error("Error: SPIR-V type that can not be reflected");
+				}
+				return it->second;
+			}
+
+			[[nodiscard]] SpirvDecorations getDecorations(uint32_t id) const {
+				auto it = mDecorations.find(id);
+				return it != mDecorations.end() ? it->second : SpirvDecorations{};
+			}
+
+			[[nodiscard]] SpirvMemberDecorations getMemberDecorations(uint32_t structId, uint32_t member) const {
+				auto it = mMemberDecorations.find({ structId, member });
+				return it != mMemberDecorations.end() ? it->second : SpirvMemberDecorations{};
+			}
+
+			[[nodiscard]] uint32_t getConstant(uint32_t id) const {
+				auto it = mConstants.find(id);
+				if (it == mConstants.end()) {
+					throw std::runtime_error("Error: SPIR-V array length is no constant");
+				}
+				return it->second;
+			}
+
+			[[nodiscard]] std::string getName(uint32_t id) const {
+				auto it = mNames.find(id);
+				return it != mNames.end() ? it->second : std::string{};
+			}
+
+			[[nodiscard]] const auto& getVariables() const { return mVariables; }
+			[[nodiscard]] auto getExecutionModel() const { return mExecutionModel; }
+
+		private:
+			static std::string readString(const uint32_t* words, size_t count) {
+				std::string text{};
+				for (size_t i = 0; i < count; ++i) {
+					for (uint32_t byte = 0; byte < 4; ++byte) {
+						char c = static_cast<char>((words[i] >> (byte * 8)) & 0xFF);
+						if (c == '\0') {
+							return text;
+						}
+						text.push_back(c);
+					}
+				}
+				return text;
+			}
+
+			void decorate(uint32_t id, uint32_t decoration, uint32_t value) {
+				auto& decorations = mDecorations[id];
+				switch (decoration) {
+				case DecorationBlock:			decorations.mBlock = true; break;
+				case DecorationBufferBlock:		decorations.mBufferBlock = true; break;
+				case DecorationArrayStride:		decorations.mArrayStride = value; break;
+				case DecorationBuiltIn:			decorations.mBuiltIn = true; break;
+				case DecorationLocation:		decorations.mLocation = value; break;
+				case DecorationBinding:			decorations.mBinding = value; break;
+				case DecorationDescriptorSet:	decorations.mSet = value; break;
+				default: break;
+				}
+			}
+
+		private:
+			std::optional<uint32_t> mExecutionModel{};
+			std::unordered_map<uint32_t, SpirvType> mTypes{};
+			std::unordered_map<uint32_t, uint32_t> mConstants{};
+			std::unordered_map<uint32_t, std::string> mNames{};
+			std::unordered_map<uint32_t, SpirvDecorations> mDecorations{};
+			std::map<std::pair<uint32_t, uint32_t>, SpirvMemberDecorations> mMemberDecorations{};
+			std::vector<SpirvVariable> mVariables{};
+		};
+
+		VkShaderStageFlags toStage(uint32_t executionModel) {
+			switch (executionModel) {
+			case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+			case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+			case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+			case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+			case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+			case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+			default: throw std::runtime_error("Error: unsupported SPIR-V execution model");
+			}
+		}
+
+		//size in a push constant block, explicit layout decorations win over the natural size
+		uint32_t getTypeSize(const SpirvModule& module, uint32_t typeId, uint32_t matrixStride = 0) {
+			const auto& type = module.getType(typeId);
+
+			switch (type.mOp) {
+			case OpTypeBool:
+				return 4;
+			case OpTypeInt:
+			case OpTypeFloat:
+				return type.mOperands.at(0) / 8;
+			case OpTypeVector:
+				return type.mOperands.at(1) * getTypeSize(module, type.mOperands.at(0));
+			case OpTypeMatrix: {
+				uint32_t columnSize = matrixStride != 0 ? matrixStride : getTypeSize(module, type.mOperands.at(0));
+				return type.mOperands.at(1) * columnSize;
+			}
+			case OpTypeArray: {
+				uint32_t stride = module.getDecorations(typeId).mArrayStride;
+				uint32_t elementSize = stride != 0 ? stride : getTypeSize(module, type.mOperands.at(0), matrixStride);
+				return module.getConstant(type.mOperands.at(1)) * elementSize;
+			}
+			case OpTypeStruct: {
+				uint32_t size = 0;
+				for (uint32_t member = 0; member < type.mOperands.size(); ++member) {
+					auto decorations = module.getMemberDecorations(typeId, member);
+					size = std::max(size, decorations.mOffset + getTypeSize(module, type.mOperands[member], decorations.mMatrixStride));
+				}
+				return size;
+			}
+			default:
+				throw std::runtime_error("Error: SPIR-V type in a push constant block that can not be sized");
+			}
+		}
+
+		VkDescriptorType toDescriptorType(const SpirvModule& module, const SpirvVariable& variable, uint32_t typeId) {
+			const auto& type = module.getType(typeId);
+
+			if (variable.mStorageClass == StorageClassStorageBuffer) {
+				return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			}
+
+			if (variable.mStorageClass == StorageClassUniform) {
+				return module.getDecorations(typeId).mBufferBlock ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			}
+
+			switch (type.mOp) {
+			case OpTypeSampler:
+				return VK_DESCRIPTOR_TYPE_SAMPLER;
+			case OpTypeSampledImage:
+				return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			case OpTypeImage: {
+				uint32_t dim = type.mOperands.at(1);
+				uint32_t sampled = type.mOperands.at(5);
+				if (dim == DimBuffer) {
+					return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				}
+				if (dim == DimSubpassData) {
+					return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+				}
+				return sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+			}
+			default:
+				throw std::runtime_error("Error: SPIR-V resource type that can not be reflected");
+			}
+		}
+
+		VkFormat toVertexFormat(const SpirvModule& module, uint32_t typeId) {
+			const auto& type = module.getType(typeId);
+
+			uint32_t components = 1;
+			const SpirvType* scalar = &type;
+			if (type.mOp == OpTypeVector) {
+				components = type.mOperands.at(1);
+				scalar = &module.getType(type.mOperands.at(0));
+			}
+
+			if ((scalar->mOp != OpTypeFloat && scalar->mOp != OpTypeInt) || scalar->mOperands.at(0) != 32 || components < 1 || components > 4) {
+				throw std::runtime_error("Error: vertex input type that can not be reflected, only 32 bit scalars and vectors are");
+			}
+
+			static const std::array<VkFormat, 4> floatFormats = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+			static const std::array<VkFormat, 4> intFormats = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+			static const std::array<VkFormat, 4> uintFormats = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+			if (scalar->mOp == OpTypeFloat) {
+				return floatFormats[components - 1];
+			}
+			return scalar->mOperands.at(1) != 0 ? intFormats[components - 1] : uintFormats[components - 1];
+		}
+	}
+
+	ShaderReflection ShaderReflection::reflect(const uint32_t* code, size_t wordCount) {
+		SpirvModule module(code, wordCount);
+
+		if (!module.getExecutionModel().has_value()) {
+			throw std::runtime_error("Error: SPIR-V module has no entry point");
+		}
+
+		ShaderReflection reflection{};
+		reflection.mStages = toStage(module.getExecutionModel().value());
+
+		for (const auto& variable : module.getVariables()) {
+			auto decorations = module.getDecorations(variable.mId);
+
+			switch (variable.mStorageClass) {
+			case StorageClassUniformConstant:
+			case StorageClassUniform:
+			case StorageClassStorageBuffer: {
+				if (!decorations.mBinding.has_value()) {
+					break;
+				}
+
+				//arrays of resources are one binding with a descriptor count
+				uint32_t typeId = variable.mType;
+				uint32_t count = 1;
+				while (module.getType(typeId).mOp == OpTypeArray || module.getType(typeId).mOp == OpTypeRuntimeArray) {
+					const auto& array = module.getType(typeId);
+					if (array.mOp == OpTypeRuntimeArray) {
+						throw std::runtime_error("Error: unsized descriptor arrays are not supported");
+					}
+					count *= module.getConstant(array.mOperands.at(1));
+					typeId = array.mOperands.at(0);
+				}
+
+				ReflectedBinding binding{};
+				binding.mSet = decorations.mSet.value_or(0);
+				binding.mBinding = decorations.mBinding.value();
+				binding.mType = toDescriptorType(module, variable, typeId);
+				binding.mCount = count;
+				binding.mStages = reflection.mStages;
+
+				//blocks are usually named by their type, e.g. "VPMatrices", the instance name may be empty
+				binding.mName = module.getName(variable.mId);
+				if (binding.mName.empty()) {
+					binding.mName = module.getName(typeId);
+				}
+
+				reflection.mBindings.push_back(binding);
+				break;
+			}
+			case StorageClassPushConstant: {
+				const auto& block = module.getType(variable.mType);
+				if (block.mOp != OpTypeStruct || block.mOperands.empty()) {
+					break;
+				}
+
+				uint32_t offset = UINT32_MAX;
+				for (uint32_t member = 0; member < block.mOperands.size(); ++member) {
+					offset = std::min(offset, module.getMemberDecorations(variable.mType, member).mOffset);
+				}
+
+				VkPushConstantRange range{};
+				range.stageFlags = reflection.mStages;
+				range.offset = offset;
+				range.size = getTypeSize(module, variable.mType) - offset;
+
+				reflection.mPushConstantRanges.push_back(range);
+				break;
+			}
+			case StorageClassInput: {
+				if (reflection.mStages != VK_SHADER_STAGE_VERTEX_BIT || decorations.mBuiltIn || !decorations.mLocation.has_value()) {
+					break;
+				}
+
+				ReflectedVertexInput input{};
+				input.mLocation = decorations.mLocation.value();
+				input.mFormat = toVertexFormat(module, variable.mType);
+				input.mName = module.getName(variable.mId);
+
+				reflection.mVertexInputs.push_back(input);
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		std::sort(reflection.mBindings.begin(), reflection.mBindings.end(), [](const ReflectedBinding& a, const ReflectedBinding& b) {
+			return std::tie(a.mSet, a.mBinding) < std::tie(b.mSet, b.mBinding);
+		});
+		std::sort(reflection.mVertexInputs.begin(), reflection.mVertexInputs.end(), [](const ReflectedVertexInput& a, const ReflectedVertexInput& b) {
+			return a.mLocation < b.mLocation;
+		});
+
+		return reflection;
+	}
+
+	ShaderReflection ShaderReflection::merge(const std::vector<ShaderReflection>& reflections) {
+		ShaderReflection merged{};
+
+		for (const auto& reflection : reflections) {
+			merged.mStages |= reflection.mStages;
+
+			for (const auto& binding : reflection.mBindings) {
+				auto it = std::find_if(merged.mBindings.begin(), merged.mBindings.end(), [&binding](const ReflectedBinding& other) {
+					return other.mSet == binding.mSet && other.mBinding == binding.mBinding;
+				});
+
+				if (it == merged.mBindings.end()) {
+					merged.mBindings.push_back(binding);
+					continue;
+				}
+
+				if (it->mType != binding.mType || it->mCount != binding.mCount) {
+					throw std::runtime_error("Error: shader stages disagree on set " + std::to_string(binding.mSet) + " binding " + std::to_string(binding.mBinding));
+				}
+				it->mStages |= binding.mStages;
+			}
+
+			//a stage may only appear in one range, equal ranges of different stages become one
+			for (const auto& range : reflection.mPushConstantRanges) {
+				auto it = std::find_if(merged.mPushConstantRanges.begin(), merged.mPushConstantRanges.end(), [&range](const VkPushConstantRange& other) {
+					return other.offset == range.offset && other.size == range.size;
+				});
+
+				if (it != merged.mPushConstantRanges.end()) {
+					it->stageFlags |= range.stageFlags;
+				}
+				else {
+					merged.mPushConstantRanges.push_back(range);
+				}
+			}
+
+			if ((reflection.mStages & VK_SHADER_STAGE_VERTEX_BIT) != 0) {
+				merged.mVertexInputs = reflection.mVertexInputs;
+			}
+		}
+
+		std::sort(merged.mBindings.begin(), merged.mBindings.end(), [](const ReflectedBinding& a, const ReflectedBinding& b) {
+			return std::tie(a.mSet, a.mBinding) < std::tie(b.mSet, b.mBinding);
+		});
+
+		return merged;
+	}
+
+	std::vector<std::vector<VkDescriptorSetLayoutBinding>> ShaderReflection::getSetLayoutBindings(const std::set<DynamicBinding>& dynamicBindings) const {
+		std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets{};
+
+		for (const auto& binding : mBindings) {
+			if (sets.size() <= binding.mSet) {
+				sets.resize(binding.mSet + 1);
+			}
+
+			VkDescriptorSetLayoutBinding layoutBinding{};
+			layoutBinding.binding = binding.mBinding;
+			layoutBinding.descriptorType = binding.mType;
+			layoutBinding.descriptorCount = binding.mCount;
+			layoutBinding.stageFlags = binding.mStages;
+			layoutBinding.pImmutableSamplers = nullptr;
+
+			if (dynamicBindings.count({ binding.mSet, binding.mBinding }) != 0) {
+				if (binding.mType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+					layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+				}
+				else if (binding.mType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+					layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+				}
+				else {
+					throw std::runtime_error("Error: only buffers can be dynamic, set " + std::to_string(binding.mSet) + " binding " + std::to_string(binding.mBinding));
+				}
+			}
+
+			sets[binding.mSet].push_back(layoutBinding);
+		}
+
+		return sets;
+	}
+}
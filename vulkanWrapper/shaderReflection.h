@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//What a SPIR-V module expects from the pipeline around it: descriptor bindings, push constants and vertex inputs.
+	//Read straight from the module's instructions, without an external reflection library. Only what pipelines built
+	//here can use is reflected: a single entry point, 32 bit vertex inputs and fixed size descriptor arrays.
+
+	struct ReflectedBinding {
+		uint32_t			mSet{ 0 };
+		uint32_t			mBinding{ 0 };
+		VkDescriptorType	mType{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER };
+		uint32_t			mCount{ 1 };			//array size
+		VkShaderStageFlags	mStages{ 0 };
+		std::string			mName{};			//variable or block name, empty if the module was stripped
+	};
+
+	//set and binding of a buffer that is bound with a dynamic offset, SPIR-V does not know about those
+	using DynamicBinding = std::pair<uint32_t, uint32_t>;
+
+	struct ReflectedVertexInput {
+		uint32_t	mLocation{ 0 };
+		VkFormat	mFormat{ VK_FORMAT_UNDEFINED };
+		std::string	mName{};
+	};
+
+	class ShaderReflection {
+	public:
+		//throws if code is no valid SPIR-V or uses something that can not be reflected
+		static ShaderReflection reflect(const uint32_t* code, size_t wordCount);
+
+		//bindings and push constants of every stage of a pipeline. A binding used by several stages is merged into one
+		//with their stage flags, equal push constant ranges likewise. Throws if stages disagree on a binding's type or size
+		static ShaderReflection merge(const std::vector<ShaderReflection>& reflections);
+
+		//execution model of the entry point, several for a merged reflection
+		[[nodiscard]] auto getStages() const { return mStages; }
+
+		//sorted by set, then binding
+		[[nodiscard]] const auto& getBindings() const { return mBindings; }
+
+		//one per set up to the highest set used, sets in between are empty. Buffers listed in dynamicBindings get the
+		//dynamic descriptor type, throws if one of them is no buffer
+		[[nodiscard]] std::vector<std::vector<VkDescriptorSetLayoutBinding>> getSetLayoutBindings(const std::set<DynamicBinding>& dynamicBindings = {}) const;
+
+		[[nodiscard]] const auto& getPushConstantRanges() const { return mPushConstantRanges; }
+
+		//vertex stage only, sorted by location
+		[[nodiscard]] const auto& getVertexInputs() const { return mVertexInputs; }
+
+	private:
+		VkShaderStageFlags mStages{ 0 };
+		std::vector<ReflectedBinding> mBindings{};
+		std::vector<VkPushConstantRange> mPushConstantRanges{};
+		std::vector<ReflectedVertexInput> mVertexInputs{};
+	};
+}
@@ -0,0 +1,69 @@
+#include "specializationConstants.h"
+
+namespace Tea::Wrapper {
+
+	VkSpecializationInfo SpecializationConstants::getInfo() const {
+		VkSpecializationInfo info{};
+		info.mapEntryCount = static_cast<uint32_t>(mMapEntries.size());
+		info.pMapEntries = mMapEntries.data();
+		info.dataSize = mData.size();
+		info.pData = mData.data();
+
+		return info;
+	}
+
+	std::string SpecializationConstants::toString() const {
+		std::ostringstream text;
+		for (const auto& entry : mMapEntries) {
+			text << (entry.offset > 0 ? " " : "") << entry.constantID << "=";
+
+			//shown as the integer or float the bytes most likely are
+			if (entry.size == sizeof(uint32_t)) {
+				uint32_t value = 0;
+				std::memcpy(&value, mData.data() + entry.offset, sizeof(value));
+				text << value;
+			}
+			else if (entry.size == sizeof(double)) {
+				double value = 0.0;
+				std::memcpy(&value, mData.data() + entry.offset, sizeof(value));
+				text << value;
+			}
+			else {
+				text << "?";
+			}
+		}
+
+		return text.str();
+	}
+
+	bool SpecializationConstants::assign(const std::vector<VkSpecializationMapEntry>& mapEntries, const std::vector<uint8_t>& data) {
+		mValues.clear();
+
+		for (const auto& entry : mapEntries) {
+			if (entry.offset + entry.size > data.size()) {
+				mValues.clear();
+				rebuild();
+				return false;
+			}
+			mValues[entry.constantID] = std::vector<uint8_t>(data.begin() + entry.offset, data.begin() + entry.offset + entry.size);
+		}
+
+		rebuild();
+		return true;
+	}
+
+	void SpecializationConstants::rebuild() {
+		mMapEntries.clear();
+		mData.clear();
+
+		for (const auto& [constantID, bytes] : mValues) {
+			VkSpecializationMapEntry entry{};
+			entry.constantID = constantID;
+			entry.offset = static_cast<uint32_t>(mData.size());
+			entry.size = bytes.size();
+
+			mMapEntries.push_back(entry);
+			mData.insert(mData.end(), bytes.begin(), bytes.end());
+		}
+	}
+}
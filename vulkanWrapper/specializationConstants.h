@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//Values for a shader's specialization constants (layout(constant_id = N) const ...), fixed when the pipeline is
+	//compiled, so the driver can fold branches on them away. One SPIR-V module gives a pipeline per set of values,
+	//e.g. textured or vertex colored; the values are part of the pipeline's key in PipelineStateCache.
+	//Kept ordered by constant id, the same values set in any order give the same pipeline.
+
+	class SpecializationConstants {
+	public:
+		//scalars only, use VkBool32 for bool constants: SPIR-V booleans are 32 bit
+		template<typename T>
+		SpecializationConstants& set(uint32_t constantID, const T& value) {
+			static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "SpecializationConstants::set takes int, uint, float, double or VkBool32");
+
+			auto bytes = reinterpret_cast<const uint8_t*>(&value);
+			mValues[constantID] = std::vector<uint8_t>(bytes, bytes + sizeof(T));
+			rebuild();
+
+			return *this;
+		}
+
+		[[nodiscard]] bool empty() const { return mValues.empty(); }
+
+		[[nodiscard]] const auto& getMapEntries() const { return mMapEntries; }
+		[[nodiscard]] const auto& getData() const { return mData; }
+
+		//points into this object
+		[[nodiscard]] VkSpecializationInfo getInfo() const;
+
+		//e.g. "0=1 2=4", names the variant in logs
+		[[nodiscard]] std::string toString() const;
+
+		//entries and data as getMapEntries/getData return them, false if they do not fit together
+		bool assign(const std::vector<VkSpecializationMapEntry>& mapEntries, const std::vector<uint8_t>& data);
+
+	private:
+		void rebuild();
+
+	private:
+		std::map<uint32_t, std::vector<uint8_t>> mValues{};
+
+		std::vector<VkSpecializationMapEntry> mMapEntries{};
+		std::vector<uint8_t> mData{};
+	};
+}
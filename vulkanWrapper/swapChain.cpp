@@ -6,7 +6,8 @@ namespace Tea::Wrapper {
 		const Device::Ptr& device, 
 		const Window::Ptr& window, 
 		const WindowSurface::Ptr& surface,
-		const CommandPool::Ptr& commandPool
+		const CommandPool::Ptr& commandPool,
+		const Ptr& oldSwapChain
 	) {
 		mDevice = device;
 		mWindow = window;
@@ -68,7 +69,7 @@ namespace Tea::Wrapper {
 		//ǰ屻סĲ֣û,ǻӰ쵽ض
 		createInfo.clipped = VK_TRUE;
 
-		createInfo.oldSwapchain = VK_NULL_HANDLE;
+		createInfo.oldSwapchain = oldSwapChain != nullptr ? oldSwapChain->getSwapChain() : VK_NULL_HANDLE;
 		if (vkCreateSwapchainKHR(mDevice->getDevice(), &createInfo, nullptr, &mSwapChain) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create swap chain!");
 		}
@@ -88,7 +89,9 @@ namespace Tea::Wrapper {
 			mSwapChainImageViews[i] = createImageView(mSwapChainImages[i], mSwapChainFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1);
 		}
 
-		mDepthImages.resize(mImageCount);
+		//frames are rendered one after another on the graphics queue and the depth is cleared at load and never stored,
+		//so a single depth image serves every framebuffer. The render pass dependency orders the depth writes of consecutive frames
+		mDepthImage = Image::createDepthImage(mDevice, mSwapChainExtent.width, mSwapChainExtent.height);
 
 		VkImageSubresourceRange region{};
 		region.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -97,17 +100,13 @@ namespace Tea::Wrapper {
 		region.baseArrayLayer = 0;
 		region.layerCount = 1;
 
-		for (int i = 0; i < mImageCount; i++) {
-			mDepthImages[i] = Image::createDepthImage(mDevice, mSwapChainExtent.width, mSwapChainExtent.height);
-
-			mDepthImages[i]->setImageLayout(
-				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-				VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-				region,
-				commandPool
-			);
-		}
+		mDepthImage->setImageLayout(
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+			region,
+			commandPool
+		);
 	}
 
 	SwapChain::~SwapChain()	{
@@ -246,7 +245,7 @@ namespace Tea::Wrapper {
 		for (int i = 0; i < mImageCount; ++i) {
 			//FrameBuffer Ϊһ֡ݣnColorAttachment 1DepthStencilAttachment
 			//ЩļΪһFrameBufferߣͻγһGPUļϣϷAttachments
-			std::array<VkImageView, 2> attachments { mSwapChainImageViews[i], mDepthImages[i]->getImageView() };
+			std::array<VkImageView, 2> attachments { mSwapChainImageViews[i], mDepthImage->getImageView() };
 
 			VkFramebufferCreateInfo frameBufferCreateInfo{};
 			frameBufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -17,15 +17,18 @@ namespace Tea::Wrapper {
 	class SwapChain {
 	public:
 		using Ptr = std::shared_ptr<SwapChain>;
-		static Ptr create(const Device::Ptr& device, const Window::Ptr& window, const WindowSurface::Ptr& surface, const CommandPool::Ptr& commandPool) {
-			return std::make_shared<SwapChain>(device, window, surface, commandPool);
+		//oldSwapChain (when recreating) is handed to the driver so it can reuse its resources and keep presenting
+		//until the new one takes over. It is retired by this, but must only be destroyed once its frames are done
+		static Ptr create(const Device::Ptr& device, const Window::Ptr& window, const WindowSurface::Ptr& surface, const CommandPool::Ptr& commandPool, const Ptr& oldSwapChain = nullptr) {
+			return std::make_shared<SwapChain>(device, window, surface, commandPool, oldSwapChain);
 		}
 
 		SwapChain(
 			const Device::Ptr& device, 
 			const Window::Ptr& window, 
 			const WindowSurface::Ptr& surface,
-			const CommandPool::Ptr& commandPool
+			const CommandPool::Ptr& commandPool,
+			const Ptr& oldSwapChain = nullptr
 		);
 
 		~SwapChain();
@@ -71,8 +74,8 @@ namespace Tea::Wrapper {
 		//In Vulkan, a framebuffer is associated with a render pass and a set of attachments, which might be images from a swapchain or other render targets.
 		std::vector<VkFramebuffer> mSwapChainFrameBuffers{};
 
-		//depth
-		std::vector<Image::Ptr> mDepthImages{};
+		//depth, shared by every framebuffer
+		Image::Ptr mDepthImage{ nullptr };
 
 		Device::Ptr mDevice{ nullptr };
 		Window::Ptr mWindow{ nullptr };
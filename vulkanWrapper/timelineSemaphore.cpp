@@ -0,0 +1,66 @@
+#include "timelineSemaphore.h"
+
+namespace Tea::Wrapper {
+
+	TimelineSemaphore::TimelineSemaphore(VkDevice device, uint64_t initialValue) {
+		mDevice = device;
+
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = initialValue;
+
+		VkSemaphoreCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		createInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(mDevice, &createInfo, nullptr, &mSemaphore) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create timeline semaphore");
+		}
+	}
+
+	TimelineSemaphore::~TimelineSemaphore() {
+		if (mSemaphore != VK_NULL_HANDLE) {
+			vkDestroySemaphore(mDevice, mSemaphore, nullptr);
+		}
+	}
+
+	uint64_t TimelineSemaphore::getValue() const {
+		uint64_t value = 0;
+		if (vkGetSemaphoreCounterValue(mDevice, mSemaphore, &value) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to read timeline semaphore value");
+		}
+
+		return value;
+	}
+
+	bool TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const {
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &mSemaphore;
+		waitInfo.pValues = &value;
+
+		VkResult result = vkWaitSemaphores(mDevice, &waitInfo, timeout);
+		if (result == VK_TIMEOUT) {
+			return false;
+		}
+
+		if (result != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to wait for timeline semaphore");
+		}
+
+		return true;
+	}
+
+	void TimelineSemaphore::signal(uint64_t value) {
+		VkSemaphoreSignalInfo signalInfo{};
+		signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+		signalInfo.semaphore = mSemaphore;
+		signalInfo.value = value;
+
+		if (vkSignalSemaphore(mDevice, &signalInfo) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to signal timeline semaphore");
+		}
+	}
+}
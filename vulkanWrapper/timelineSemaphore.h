@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../base.h"
+
+namespace Tea::Wrapper {
+	//A Vulkan 1.2 timeline semaphore: a 64 bit counter the GPU raises when a submission that signals it completes.
+	//The CPU can read, wait for or signal a value without any fence. Signaled values must strictly increase,
+	//so one semaphore should only be signaled from submissions to one queue.
+
+	class TimelineSemaphore {
+	public:
+		using Ptr = std::shared_ptr<TimelineSemaphore>;
+		static Ptr create(VkDevice device, uint64_t initialValue = 0) {
+			return std::make_shared<TimelineSemaphore>(device, initialValue);
+		}
+
+		TimelineSemaphore(VkDevice device, uint64_t initialValue = 0);
+
+		~TimelineSemaphore();
+
+		//the value the GPU (or signal()) has reached so far
+		[[nodiscard]] uint64_t getValue() const;
+
+		//false if timeout (in nanoseconds) ran out before value was reached
+		bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+		//raises the counter from the host, value must be bigger than the current one
+		void signal(uint64_t value);
+
+		[[nodiscard]] auto getSemaphore() const { return mSemaphore; }
+
+	private:
+		VkSemaphore mSemaphore{ VK_NULL_HANDLE };
+		VkDevice mDevice{ VK_NULL_HANDLE };
+	};
+}
@@ -0,0 +1,52 @@
+#include "uniformRingAllocator.h"
+
+namespace Tea::Wrapper {
+
+	UniformRingAllocator::UniformRingAllocator(const Device::Ptr& device, uint32_t frameCount, VkDeviceSize frameCapacity) {
+		mDevice = device;
+		mFrameCount = frameCount;
+
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(mDevice->getPhysicalDevice(), &properties);
+
+		//the spec guarantees minUniformBufferOffsetAlignment is a power of two
+		mAlignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+
+		//every region starts aligned, so offsets stay aligned across frames
+		mFrameCapacity = alignUp(frameCapacity);
+
+		mBuffer = Buffer::createUniformBuffer(mDevice, mFrameCapacity * mFrameCount, nullptr);
+	}
+
+	UniformRingAllocator::~UniformRingAllocator() {
+	}
+
+	void UniformRingAllocator::beginFrame(uint32_t frameIndex) {
+		assert(frameIndex < mFrameCount);
+
+		mFrameIndex = frameIndex;
+		mHead = 0;
+	}
+
+	uint32_t UniformRingAllocator::push(const void* data, VkDeviceSize size) {
+		VkDeviceSize alignedSize = alignUp(size);
+		if (mHead + alignedSize > mFrameCapacity) {
+			throw std::runtime_error("Error: uniform ring frame region is full, increase frameCapacity");
+		}
+
+		VkDeviceSize offset = mFrameIndex * mFrameCapacity + mHead;
+		memcpy(static_cast<char*>(mBuffer->getMappedData()) + offset, data, size);
+
+		mHead += alignedSize;
+
+		return static_cast<uint32_t>(offset);
+	}
+
+	void UniformRingAllocator::endFrame() {
+		if (mHead == 0) {
+			return;
+		}
+
+		mBuffer->flush(mFrameIndex * mFrameCapacity, mHead);
+	}
+}
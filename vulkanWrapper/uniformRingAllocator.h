@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+#include "buffer.h"
+
+namespace Tea::Wrapper {
+	//One persistently mapped uniform buffer split into one region per frame in flight.
+	//Every frame the region of that frame is rewound and filled linearly, each push returns a
+	//minUniformBufferOffsetAlignment aligned offset that is passed as a dynamic offset when binding
+	//a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor, so N objects need neither N buffers nor N descriptor sets.
+	class UniformRingAllocator {
+	public:
+		using Ptr = std::shared_ptr<UniformRingAllocator>;
+		static Ptr create(const Device::Ptr& device, uint32_t frameCount, VkDeviceSize frameCapacity = DefaultFrameCapacity) {
+			return std::make_shared<UniformRingAllocator>(device, frameCount, frameCapacity);
+		}
+
+		UniformRingAllocator(const Device::Ptr& device, uint32_t frameCount, VkDeviceSize frameCapacity = DefaultFrameCapacity);
+
+		~UniformRingAllocator();
+
+		//rewinds the region of frameIndex, the last submission that used this region must have completed
+		void beginFrame(uint32_t frameIndex);
+
+		//copies the data into the current frame region and returns its dynamic offset
+		uint32_t push(const void* data, VkDeviceSize size);
+
+		template<typename T>
+		uint32_t push(const T& value) { return push(&value, sizeof(T)); }
+
+		//flushes everything pushed since beginFrame, a no-op on HOST_COHERENT memory
+		void endFrame();
+
+		[[nodiscard]] auto getBuffer() const { return mBuffer; }
+
+		[[nodiscard]] auto getAlignment() const { return mAlignment; }
+
+		[[nodiscard]] auto getFrameCapacity() const { return mFrameCapacity; }
+
+		[[nodiscard]] auto getUsedBytes() const { return mHead; }
+
+		static constexpr VkDeviceSize DefaultFrameCapacity = 1024 * 1024;
+
+	private:
+		[[nodiscard]] VkDeviceSize alignUp(VkDeviceSize value) const { return (value + mAlignment - 1) & ~(mAlignment - 1); }
+
+		Device::Ptr mDevice{ nullptr };
+		Buffer::Ptr mBuffer{ nullptr };
+
+		VkDeviceSize mAlignment{ 256 };
+		VkDeviceSize mFrameCapacity{ 0 };
+		uint32_t mFrameCount{ 0 };
+
+		uint32_t mFrameIndex{ 0 };
+		VkDeviceSize mHead{ 0 };
+	};
+}
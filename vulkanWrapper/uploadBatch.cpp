@@ -0,0 +1,180 @@
+#include "uploadBatch.h"
+
+namespace Tea::Wrapper {
+
+	UploadBatch::UploadBatch(const Device::Ptr& device) {
+		mDevice = device;
+		mUploadHeap = mDevice->getUploadHeap();
+		mScheduler = mDevice->getFrameScheduler();
+		//uploads go to the transfer queue when the device has one, so they run next to rendering instead of behind it
+		mCommandPool = CommandPool::create(mDevice, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, mDevice->getTransferQueueFamily());
+	}
+
+	UploadBatch::~UploadBatch() {
+		submit();
+		waitAll();
+	}
+
+	void UploadBatch::uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset) {
+		VkDeviceSize offset = 0;
+		while (offset < size) {
+			VkDeviceSize chunkSize = std::min<VkDeviceSize>(size - offset, mUploadHeap->getMaxChunkSize());
+
+			auto region = allocateRegion(chunkSize);
+			memcpy(region.mData, static_cast<const char*>(data) + offset, chunkSize);
+			mUploadHeap->flush(region);
+
+			VkBufferCopy copyInfo{};
+			copyInfo.size = chunkSize;
+			copyInfo.srcOffset = region.mOffset;
+			copyInfo.dstOffset = dstOffset + offset;
+
+			getCommandBuffer()->copyBufferToBuffer(region.mBuffer, dstBuffer, 1, { copyInfo });
+
+			offset += chunkSize;
+		}
+	}
+
+	void UploadBatch::uploadBuffer(const Buffer::Ptr& dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset) {
+		uploadBuffer(dstBuffer->getBuffer(), data, size, dstOffset);
+		mResources.push_back(dstBuffer);
+	}
+
+	void UploadBatch::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+		VkBufferCopy copyInfo{};
+		copyInfo.size = size;
+		copyInfo.srcOffset = 0;
+		copyInfo.dstOffset = 0;
+
+		getCommandBuffer()->copyBufferToBuffer(srcBuffer, dstBuffer, 1, { copyInfo });
+	}
+
+	void UploadBatch::uploadImage(VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height, const void* data, size_t size) {
+		//a big image is copied in bands of whole rows so that it never has to fit into the heap at once
+		size_t rowSize = size / height;
+		if (rowSize > mUploadHeap->getMaxChunkSize()) {
+			throw std::runtime_error("Error: a single image row does not fit into the upload heap");
+		}
+
+		uint32_t rowsPerChunk = static_cast<uint32_t>(std::min<size_t>(height, mUploadHeap->getMaxChunkSize() / rowSize));
+
+		//bands have to respect the transfer queue granularity, only the last one may end at the image edge instead
+		uint32_t granularity = mDevice->getTransferImageGranularity().height;
+		if (granularity == 0) {
+			rowsPerChunk = height;
+		}
+		else if (rowsPerChunk < height) {
+			rowsPerChunk = std::max(granularity, rowsPerChunk / granularity * granularity);
+		}
+
+		if (rowsPerChunk * rowSize > mUploadHeap->getCapacity()) {
+			throw std::runtime_error("Error: image does not fit into the upload heap with the transfer queue granularity");
+		}
+
+		//the buffer offset of vkCmdCopyBufferToImage has to be a multiple of the texel size and of 4, e.g. 12 for RGB32F
+		VkDeviceSize texelSize = std::max<VkDeviceSize>(rowSize / width, 1);
+		VkDeviceSize alignment = std::lcm(texelSize, VkDeviceSize{ 4 });
+
+		uint32_t row = 0;
+		while (row < height) {
+			uint32_t rowCount = std::min(rowsPerChunk, height - row);
+			VkDeviceSize chunkSize = rowCount * rowSize;
+
+			auto region = allocateRegion(chunkSize, alignment);
+			memcpy(region.mData, static_cast<const char*>(data) + row * rowSize, chunkSize);
+			mUploadHeap->flush(region);
+
+			getCommandBuffer()->copyBufferToImage(region.mBuffer, region.mOffset, dstImage, dstImageLayout, width, rowCount, static_cast<int32_t>(row));
+
+			row += rowCount;
+		}
+	}
+
+	void UploadBatch::uploadImage(const Image::Ptr& dstImage, const void* data, size_t size) {
+		uploadImage(
+			dstImage->getImage(), dstImage->getLayout(),
+			static_cast<uint32_t>(dstImage->getWidth()), static_cast<uint32_t>(dstImage->getHeight()),
+			data, size);
+		mResources.push_back(dstImage);
+	}
+
+	UploadTicket UploadBatch::submit() {
+		if (mCommandBuffer != nullptr) {
+			flushCommandBuffer();
+		}
+
+		//nothing recorded: the ticket of the last submission (0 if there was none) is already the right answer
+		return mLastTicket;
+	}
+
+	bool UploadBatch::isComplete(UploadTicket ticket) {
+		bool complete = mScheduler->isComplete(QueueType::Transfer, ticket);
+		collect();
+		return complete;
+	}
+
+	void UploadBatch::wait(UploadTicket ticket) {
+		mScheduler->wait(QueueType::Transfer, ticket);
+		collect();
+	}
+
+	void UploadBatch::waitAll() {
+		wait(mLastTicket);
+	}
+
+	const CommandBuffer::Ptr& UploadBatch::getCommandBuffer() {
+		if (mCommandBuffer == nullptr) {
+			if (mFreeCommandBuffers.empty()) {
+				mCommandBuffer = CommandBuffer::create(mDevice, mCommandPool);
+			}
+			else {
+				mCommandBuffer = mFreeCommandBuffers.back();
+				mFreeCommandBuffers.pop_back();
+			}
+			mCommandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		}
+
+		return mCommandBuffer;
+	}
+
+	UploadRegion UploadBatch::allocateRegion(VkDeviceSize size, VkDeviceSize alignment) {
+		auto region = mUploadHeap->tryAllocate(size, alignment);
+		if (region.has_value()) {
+			return region.value();
+		}
+
+		if (mCommandBuffer != nullptr) {
+			flushCommandBuffer();
+		}
+
+		return mUploadHeap->allocate(size, alignment);
+	}
+
+	void UploadBatch::flushCommandBuffer() {
+		mCommandBuffer->end();
+
+		InFlight inFlight{};
+		inFlight.mTicket = mCommandBuffer->submit(QueueType::Transfer);
+
+		mUploadHeap->retire(QueueType::Transfer, inFlight.mTicket);
+
+		inFlight.mCommandBuffer = mCommandBuffer;
+		inFlight.mResources = std::move(mResources);
+		mInFlight.push_back(std::move(inFlight));
+
+		mLastTicket = mInFlight.back().mTicket;
+		mSubmitCount++;
+
+		mCommandBuffer = nullptr;
+		mResources.clear();
+
+		collect();
+	}
+
+	void UploadBatch::collect() {
+		while (!mInFlight.empty() && mScheduler->isComplete(QueueType::Transfer, mInFlight.front().mTicket)) {
+			mFreeCommandBuffers.push_back(mInFlight.front().mCommandBuffer);
+			mInFlight.pop_front();
+		}
+	}
+}
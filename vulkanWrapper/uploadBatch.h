@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../base.h"
+#include "device.h"
+#include "commandPool.h"
+#include "commandBuffer.h"
+#include "buffer.h"
+#include "image.h"
+
+namespace Tea::Wrapper {
+	//Records many buffer and image uploads into one command buffer and submits them together,
+	//so loading a scene costs one (or a few, when the upload heap runs full) submissions instead of one queue drain per copy.
+	//submit() returns a ticket that can be polled with isComplete or waited on with wait, the batch keeps the
+	//command buffers and the destination resources passed as Ptr alive until their ticket completes.
+	//Staging regions come from Device::getUploadHeap(), so only one batch per device should be recording at a time.
+	//The batch runs on the transfer queue, the graphics queue may only read the results once the ticket has completed,
+	//either waited for on the CPU or through FrameScheduler::makeWait(QueueType::Transfer, ticket, stage) on the GPU.
+
+	//the value of the transfer timeline the batch's last submission signals
+	using UploadTicket = uint64_t;
+
+	class UploadBatch {
+	public:
+		using Ptr = std::shared_ptr<UploadBatch>;
+		static Ptr create(const Device::Ptr& device) {
+			return std::make_shared<UploadBatch>(device);
+		}
+
+		UploadBatch(const Device::Ptr& device);
+
+		~UploadBatch();
+
+		void uploadBuffer(VkBuffer dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+		void uploadBuffer(const Buffer::Ptr& dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+		void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+
+		//the image has to be in dstImageLayout (TRANSFER_DST_OPTIMAL or GENERAL) when the batch executes,
+		//data holds height tightly packed rows
+		void uploadImage(VkImage dstImage, VkImageLayout dstImageLayout, uint32_t width, uint32_t height, const void* data, size_t size);
+
+		void uploadImage(const Image::Ptr& dstImage, const void* data, size_t size);
+
+		//submits everything recorded since the last submit, the ticket covers those copies and all earlier ones
+		UploadTicket submit();
+
+		bool isComplete(UploadTicket ticket);
+
+		void wait(UploadTicket ticket);
+
+		void waitAll();
+
+		[[nodiscard]] auto getSubmitCount() const { return mSubmitCount; }
+
+	private:
+		const CommandBuffer::Ptr& getCommandBuffer();
+
+		//if the heap is full, what is recorded so far is submitted so the heap can recycle its older regions
+		UploadRegion allocateRegion(VkDeviceSize size, VkDeviceSize alignment = UploadHeap::DefaultAlignment);
+
+		void flushCommandBuffer();
+
+		//releases the resources of completed submissions and keeps their command buffers for reuse
+		void collect();
+
+		Device::Ptr mDevice{ nullptr };
+		UploadHeap::Ptr mUploadHeap{ nullptr };
+		FrameScheduler::Ptr mScheduler{ nullptr };
+		CommandPool::Ptr mCommandPool{ nullptr };
+
+		CommandBuffer::Ptr mCommandBuffer{ nullptr };
+		std::vector<std::shared_ptr<void>> mResources{};
+
+		struct InFlight {
+			UploadTicket					mTicket{ 0 };
+			CommandBuffer::Ptr				mCommandBuffer{ nullptr };
+			std::vector<std::shared_ptr<void>>	mResources{};
+		};
+		std::deque<InFlight> mInFlight{};
+
+		//of completed submissions, begin resets them (the pool allows resetting single buffers)
+		std::vector<CommandBuffer::Ptr> mFreeCommandBuffers{};
+
+		UploadTicket mLastTicket{ 0 };
+		uint32_t mSubmitCount{ 0 };
+	};
+}
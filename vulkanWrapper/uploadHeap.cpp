@@ -0,0 +1,178 @@
+#include "uploadHeap.h"
+
+namespace Tea::Wrapper {
+
+	static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	UploadHeap::UploadHeap(VkDevice device, const MemoryAllocator::Ptr& allocator, const FrameScheduler::Ptr& scheduler, VkDeviceSize capacity) {
+		mDevice = device;
+		mAllocator = allocator;
+		mScheduler = scheduler;
+		mCapacity = capacity;
+
+		VkBufferCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		createInfo.size = mCapacity;
+		createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateBuffer(mDevice, &createInfo, nullptr, &mBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("Error: failed to create upload heap buffer");
+		}
+
+		VkMemoryRequirements memReq{};
+		vkGetBufferMemoryRequirements(mDevice, mBuffer, &memReq);
+
+		auto memoryTypeIndex = findMemoryTypeIndex(mAllocator->getMemoryProperties(), memReq.memoryTypeBits, MemoryUsage::CpuOnly);
+		if (!memoryTypeIndex.has_value()) {
+			throw std::runtime_error("Error: no host visible memory type for the upload heap");
+		}
+
+		mAllocation = mAllocator->allocate(memReq, memoryTypeIndex.value(), true, MemoryCategory::Staging);
+		vkBindBufferMemory(mDevice, mBuffer, mAllocation.mMemory, mAllocation.mOffset);
+
+		mMappedData = static_cast<char*>(mAllocator->map(mAllocation));
+	}
+
+	UploadHeap::~UploadHeap() {
+		for (const auto& submission : mSubmissions) {
+			mScheduler->wait(submission.mQueue, submission.mValue);
+		}
+
+		if (mBuffer != VK_NULL_HANDLE) {
+			vkDestroyBuffer(mDevice, mBuffer, nullptr);
+		}
+
+		mAllocator->unmap(mAllocation);
+		mAllocator->free(mAllocation);
+	}
+
+	std::optional<UploadRegion> UploadHeap::tryAllocate(VkDeviceSize size, VkDeviceSize alignment) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		reclaim();
+
+		return tryAllocateLocked(size, alignment);
+	}
+
+	UploadRegion UploadHeap::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (size > mCapacity) {
+			throw std::runtime_error("Error: upload is bigger than the upload heap, split it into chunks");
+		}
+
+		while (true) {
+			reclaim();
+
+			auto region = tryAllocateLocked(size, alignment);
+			if (region.has_value()) {
+				return region.value();
+			}
+
+			//only regions that were never retired are left, waiting would never end
+			if (mSubmissions.empty()) {
+				throw std::runtime_error("Error: upload heap is full of unsubmitted regions, retire and submit them first");
+			}
+
+			waitOldest();
+		}
+	}
+
+	std::optional<UploadRegion> UploadHeap::tryAllocateLocked(VkDeviceSize size, VkDeviceSize alignment) {
+		if (size == 0 || size > mCapacity) {
+			return std::nullopt;
+		}
+
+		if (mUsedBytes == 0) {
+			mHead = 0;
+			mTail = 0;
+		}
+
+		bool full = mUsedBytes > 0 && mHead == mTail;
+		if (full) {
+			return std::nullopt;
+		}
+
+		VkDeviceSize offset = alignUp(mHead, alignment);
+
+		if (mHead >= mTail) {
+			//free space is [mHead, mCapacity) followed by [0, mTail)
+			if (offset + size <= mCapacity) {
+				mUsedBytes += offset + size - mHead;
+				mPendingBytes += offset + size - mHead;
+			}
+			else if (size <= mTail) {
+				//the end of the ring is skipped, it is given back together with this region
+				offset = 0;
+				mUsedBytes += mCapacity - mHead + size;
+				mPendingBytes += mCapacity - mHead + size;
+			}
+			else {
+				return std::nullopt;
+			}
+		}
+		else {
+			//free space is [mHead, mTail)
+			if (offset + size > mTail) {
+				return std::nullopt;
+			}
+
+			mUsedBytes += offset + size - mHead;
+			mPendingBytes += offset + size - mHead;
+		}
+
+		mHead = offset + size;
+
+		UploadRegion region{};
+		region.mBuffer = mBuffer;
+		region.mOffset = offset;
+		region.mSize = size;
+		region.mData = mMappedData + offset;
+
+		return region;
+	}
+
+	void UploadHeap::flush(const UploadRegion& region) {
+		mAllocator->flush(mAllocation, region.mOffset, region.mSize);
+	}
+
+	void UploadHeap::retire(QueueType queue, uint64_t value) {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		Submission submission{};
+		submission.mQueue = queue;
+		submission.mValue = value;
+		submission.mEnd = mHead;
+		submission.mBytes = mPendingBytes;
+
+		mSubmissions.push_back(submission);
+		mPendingBytes = 0;
+	}
+
+	void UploadHeap::waitIdle() {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		while (!mSubmissions.empty()) {
+			waitOldest();
+			reclaim();
+		}
+	}
+
+	void UploadHeap::reclaim() {
+		while (!mSubmissions.empty() && mScheduler->isComplete(mSubmissions.front().mQueue, mSubmissions.front().mValue)) {
+			auto& submission = mSubmissions.front();
+
+			mTail = submission.mEnd;
+			mUsedBytes -= submission.mBytes;
+
+			mSubmissions.pop_front();
+		}
+	}
+
+	void UploadHeap::waitOldest() {
+		mScheduler->wait(mSubmissions.front().mQueue, mSubmissions.front().mValue);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../base.h"
+#include "memoryAllocator.h"
+#include "frameScheduler.h"
+
+namespace Tea::Wrapper {
+	//A fixed amount of persistently mapped host visible memory used as a ring for all staging copies.
+	//Regions handed out since the last retire() belong to the submission retire() is given: once its queue's
+	//timeline reaches the submission's value the regions are recycled. Nothing is allocated per upload.
+
+	struct UploadRegion {
+		VkBuffer		mBuffer{ VK_NULL_HANDLE };
+		VkDeviceSize	mOffset{ 0 };
+		VkDeviceSize	mSize{ 0 };
+		void*			mData{ nullptr };
+	};
+
+	class UploadHeap {
+	public:
+		using Ptr = std::shared_ptr<UploadHeap>;
+		static Ptr create(VkDevice device, const MemoryAllocator::Ptr& allocator, const FrameScheduler::Ptr& scheduler, VkDeviceSize capacity = DefaultCapacity) {
+			return std::make_shared<UploadHeap>(device, allocator, scheduler, capacity);
+		}
+
+		UploadHeap(VkDevice device, const MemoryAllocator::Ptr& allocator, const FrameScheduler::Ptr& scheduler, VkDeviceSize capacity = DefaultCapacity);
+
+		~UploadHeap();
+
+		//non blocking, std::nullopt if the ring has no room until an in-flight submission finishes
+		std::optional<UploadRegion> tryAllocate(VkDeviceSize size, VkDeviceSize alignment = DefaultAlignment);
+
+		//waits for in-flight submissions until the region fits, size must not exceed getMaxChunkSize()
+		UploadRegion allocate(VkDeviceSize size, VkDeviceSize alignment = DefaultAlignment);
+
+		//make the host writes of a region visible to the device, a no-op on HOST_COHERENT memory
+		void flush(const UploadRegion& region);
+
+		//closes the regions allocated since the last retire, they are reused once queue has reached value
+		//(the value FrameScheduler::submit returned for the submission consuming them)
+		void retire(QueueType queue, uint64_t value);
+
+		[[nodiscard]] bool hasPendingRegions() const { return mPendingBytes > 0; }
+
+		void waitIdle();
+
+		//splitting uploads into chunks of this size keeps several of them in flight at once
+		[[nodiscard]] auto getMaxChunkSize() const { return mCapacity / 4; }
+
+		[[nodiscard]] auto getCapacity() const { return mCapacity; }
+
+		[[nodiscard]] auto getUsedBytes() const { return mUsedBytes; }
+
+		static constexpr VkDeviceSize DefaultCapacity = 32ull * 1024 * 1024;
+
+		//enough for buffer copies. Image copies have to pass lcm(texel size, 4) instead (see UploadBatch::uploadImage),
+		//3, 6 and 12 byte texels do not divide 16
+		static constexpr VkDeviceSize DefaultAlignment = 16;
+
+	private:
+		std::optional<UploadRegion> tryAllocateLocked(VkDeviceSize size, VkDeviceSize alignment);
+
+		//returns the regions of every signaled submission to the ring
+		void reclaim();
+
+		void waitOldest();
+
+		VkDevice mDevice{ VK_NULL_HANDLE };
+		MemoryAllocator::Ptr mAllocator{ nullptr };
+		FrameScheduler::Ptr mScheduler{ nullptr };
+
+		VkBuffer mBuffer{ VK_NULL_HANDLE };
+		MemoryAllocation mAllocation{};
+		char* mMappedData{ nullptr };
+
+		VkDeviceSize mCapacity{ 0 };
+
+		//[mTail, mHead) wrapping around mCapacity is in use, mUsedBytes tells a full ring from an empty one
+		VkDeviceSize mHead{ 0 };
+		VkDeviceSize mTail{ 0 };
+		VkDeviceSize mUsedBytes{ 0 };
+		VkDeviceSize mPendingBytes{ 0 };
+
+		//recycled in retire order, a submission on a fast queue waits for older ones on slower queues
+		struct Submission {
+			QueueType		mQueue{ QueueType::Transfer };
+			uint64_t		mValue{ 0 };
+			VkDeviceSize	mEnd{ 0 };
+			VkDeviceSize	mBytes{ 0 };
+		};
+		std::deque<Submission> mSubmissions{};
+
+		std::mutex mMutex;
+	};
+}
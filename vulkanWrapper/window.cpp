@@ -8,11 +8,21 @@ namespace Tea::Wrapper {
 		glfwInit();
 		//ûصopengl API ҽֹڸıС
 		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 		mWindow = glfwCreateWindow(mWidth, mHeight, "Vulkan", nullptr, nullptr);
 		if (!mWindow) {
 			std::cerr << "Error: failed to create window" << std::endl;
+			return;
 		}
+
+		//not every platform reports VK_ERROR_OUT_OF_DATE_KHR after a resize, so it is tracked here as well
+		glfwSetWindowUserPointer(mWindow, this);
+		glfwSetFramebufferSizeCallback(mWindow, [](GLFWwindow* window, int width, int height) {
+			auto self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+			self->mWidth = width;
+			self->mHeight = height;
+			self->mResized = true;
+		});
 	}
 	Window::~Window() {
 		glfwDestroyWindow(mWindow);
@@ -26,4 +36,8 @@ namespace Tea::Wrapper {
 	void Window::pollEvents() {
 		glfwPollEvents();
 	}
+
+	void Window::setSize(int width, int height) {
+		glfwSetWindowSize(mWindow, width, height);
+	}
 }
\ No newline at end of file
@@ -19,11 +19,19 @@ namespace Tea::Wrapper {
 
 		void pollEvents();
 
+		//set by the framebuffer size callback, the swapchain has to be recreated before the next present
+		[[nodiscard]] bool isResized() const { return mResized; }
+
+		void resetResized() { mResized = false; }
+
+		void setSize(int width, int height);
+
 		[[nodiscard]] auto getWindow() const { return mWindow; }
 
 	private:
 		int mWidth{ 0 };
 		int mHeight{ 0 };
+		bool mResized{ false };
 		GLFWwindow* mWindow;
 	};
 }
\ No newline at end of file